@@ -0,0 +1,168 @@
+/*************************************************************************************
+
+    Grid physics library, www.github.com/paboyle/Grid
+
+    Source file: ./lib/algorithms/CoarseAgglomeration.h
+
+    Copyright (C) 2015
+
+Author: Peter Boyle <paboyle@ph.ed.ac.uk>
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License along
+    with this program; if not, write to the Free Software Foundation, Inc.,
+    51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+
+    See the full license in the file "LICENSE" in the top level distribution directory
+*************************************************************************************/
+/*  END LEGAL */
+#pragma once
+
+NAMESPACE_BEGIN(Grid);
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+// Redundant coarse solves on agglomerated subgrids.
+//
+// Deep multigrid levels leave a handful of sites per rank, where the stencil halo exchange and
+// global sums are pure latency. When the local volume of a CoarsenedMatrix falls below
+// minLocalSites the processor grid is divided into copies, each holding the whole coarse
+// lattice on fewer ranks with at least minLocalSites sites each (as far as the rank count
+// allows). The links are replicated onto every copy once; each coarse solve then replicates
+// the source, runs identically on every copy and takes the solution from the first.
+//
+// Operator() and Grid() return the agglomerated operator and grid, or the original ones when
+// the volume is already above threshold, so solvers can be built on them unconditionally.
+// The copies are a snapshot: call Refresh() whenever the parent's links change
+// (CoarsenOperator, UpdateOperator, SetLinkPrecision).
+///////////////////////////////////////////////////////////////////////////////////////////////////
+template<class CoarseOperator>
+class CoarseAgglomeration {
+public:
+  typedef typename CoarseOperator::CoarseVector CoarseVector;
+
+  CoarseAgglomeration(CoarseOperator &_Op,int minLocalSites)
+    : Op(_Op), SubGrid(nullptr), SubRBGrid(nullptr), nsplit(1)
+  {
+    GridCartesian *grid = (GridCartesian *)Op.Grid();
+    int        nd    = grid->_ndimension;
+    Coordinate latt  = grid->FullDimensions();
+    Coordinate simd  = grid->_simd_layout;
+    Coordinate split = grid->ProcessorGrid();
+
+    // Peel the smallest prime factor off the most divided dimension until the subgrid
+    // local volume reaches the threshold
+    auto lsites = [&](void) { int64_t l=1; for(int d=0;d<nd;d++) l*=latt[d]/split[d]; return l; };
+    while ( lsites() < minLocalSites ) {
+      int dmax=-1;
+      for(int d=0;d<nd;d++) if ( (split[d]>1) && ((dmax<0) || (split[d]>split[dmax])) ) dmax=d;
+      if ( dmax<0 ) break;
+      int p=2; while ( split[dmax]%p ) p++;
+      split[dmax]/=p;
+      nsplit   *=p;
+    }
+    if ( nsplit==1 ) return;
+
+    GridRedBlackCartesian *rb = dynamic_cast<GridRedBlackCartesian *>(Op.RedBlackGrid());
+    assert(rb!=nullptr);
+    SubGrid   = new GridCartesian(latt,simd,split,*grid);
+    SubRBGrid = new GridRedBlackCartesian(SubGrid,rb->_checker_dim_mask,rb->_checker_dim);
+    SubOp.reset(new CoarseOperator(*SubGrid,*SubRBGrid,Op.hermitian));
+    Refresh();
+
+    std::cout << GridLogMessage << "CoarseAgglomeration: local volume "<<grid->lSites()
+	      <<" below "<<minLocalSites<<"; "<<nsplit<<" redundant copies on processor grid "<<split
+	      <<" with local volume "<<SubGrid->lSites()<<std::endl;
+  }
+
+  ~CoarseAgglomeration()
+  {
+    SubOp.reset();
+    if ( SubRBGrid ) delete SubRBGrid;
+    if ( SubGrid   ) delete SubGrid;
+  }
+
+  // Replicate the parent's current links and link precision onto every copy
+  void Refresh(void)
+  {
+    if ( !Active() ) return;
+    typename CoarseOperator::CoarseMatrix link(Op.Grid());
+    SubOp->AllocateLinks();
+    for(int p=0;p<Op.geom.npoint;p++) {
+      Op.Link(p,link);
+      Grid_split(link,SubOp->A[p]);
+    }
+    Grid_split(Op.AselfInv,SubOp->AselfInv);
+    SubOp->linkPrecision = Op.LinkPrecision();
+    SubOp->FillHalfCbs();
+  }
+
+  bool             Active(void)   { return nsplit>1; }
+  int              Copies(void)   { return nsplit; }
+  CoarseOperator & Operator(void) { return Active() ? *SubOp : Op; }
+  GridBase *       Grid(void)     { return Active() ? (GridBase *)SubGrid : Op.Grid(); }
+
+  // Parent grid -> every copy
+  void Replicate(const CoarseVector &in,CoarseVector &s_in)
+  {
+    if ( !Active() ) { s_in = in; return; }
+    std::vector<CoarseVector> full(nsplit,in);
+    Grid_split(full,s_in);
+  }
+  // First copy -> parent grid
+  void Gather(CoarseVector &s_out,CoarseVector &out)
+  {
+    if ( !Active() ) { out = s_out; return; }
+    std::vector<CoarseVector> full(nsplit,out.Grid());
+    Grid_unsplit(full,s_out);
+    out = full[0];
+  }
+
+private:
+  CoarseOperator                 &Op;
+  std::unique_ptr<CoarseOperator> SubOp;
+  GridCartesian                  *SubGrid;
+  GridRedBlackCartesian          *SubRBGrid;
+  int                             nsplit;
+};
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+// Wraps a solve built on Agglomeration.Operator() as a solve on the parent coarse grid;
+// the incoming solution is replicated as the initial guess.
+///////////////////////////////////////////////////////////////////////////////////////////////////
+template<class CoarseOperator,class Solver>
+class AgglomeratedCoarseSolve : public LinearFunction<typename CoarseOperator::CoarseVector> {
+public:
+  typedef typename CoarseOperator::CoarseVector CoarseVector;
+  using LinearFunction<CoarseVector>::operator();
+
+  CoarseAgglomeration<CoarseOperator> &Agglomeration;
+  Solver                              &Solve;
+
+  AgglomeratedCoarseSolve(CoarseAgglomeration<CoarseOperator> &_Agglomeration,Solver &_Solve)
+    : Agglomeration(_Agglomeration), Solve(_Solve) {};
+
+  void operator() (const CoarseVector &in,CoarseVector &out)
+  {
+    if ( !Agglomeration.Active() ) {
+      Solve(in,out);
+      return;
+    }
+    CoarseVector s_in (Agglomeration.Grid());
+    CoarseVector s_out(Agglomeration.Grid());
+    Agglomeration.Replicate(in ,s_in);
+    Agglomeration.Replicate(out,s_out);
+    Solve(s_in,s_out);
+    Agglomeration.Gather(s_out,out);
+  }
+};
+
+NAMESPACE_END(Grid);
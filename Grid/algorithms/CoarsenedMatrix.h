@@ -191,6 +191,25 @@ public:
     }
   }
 
+  ////////////////////////////////////////////////////////////////////////////////////////////////
+  // Cheap refresh for a slightly changed operator (e.g. between HMC trajectories): a few CG
+  // iterations of inverse iteration started from each current vector instead of from noise,
+  // then block orthonormalisation, ready for CoarsenedMatrix::UpdateOperator.
+  ////////////////////////////////////////////////////////////////////////////////////////////////
+  virtual void RefreshSubspace(LinearOperatorBase<FineField> &hermop,int maxiter=8) {
+
+    ConjugateGradient<FineField> CG(1.0e-2,maxiter,false);
+    FineField src(FineGrid);
+
+    for(int b=0;b<nbasis;b++){
+      src = subspace[b];
+      CG(hermop,src,subspace[b]);
+      RealD scale = std::pow(norm2(subspace[b]),-0.5); 
+      subspace[b] = subspace[b]*scale;
+    }
+    Orthogonalise();
+  }
+
   ////////////////////////////////////////////////////////////////////////////////////////////////
   // World of possibilities here. But have tried quite a lot of experiments (250+ jobs run on Summit)
   // and this is the best I found
@@ -293,6 +312,24 @@ public:
 
 };
 
+////////////////////////////////////////////////////////////////////////////////
+// Reduced precision coarse link storage: the packed lower precision vectors
+// follow the lane order of precisionChange, so a row of nbasis links expands
+// into nbasis full precision vectors in place.
+////////////////////////////////////////////////////////////////////////////////
+template<class vtype> struct CoarseLinkTypes {};
+template<> struct CoarseLinkTypes<vComplexD> { typedef vComplexF vSingle; typedef vComplexH vHalf; };
+template<> struct CoarseLinkTypes<vComplexF> { typedef vComplexF vSingle; typedef vComplexH vHalf; };
+
+accelerator_inline void coarseLinkCompress(vComplexF *out,vComplexD *in,int n) { precisionChange(out,in,n); }
+accelerator_inline void coarseLinkCompress(vComplexH *out,vComplexD *in,int n) { precisionChange(out,in,n); }
+accelerator_inline void coarseLinkCompress(vComplexH *out,vComplexF *in,int n) { precisionChange(out,in,n); }
+accelerator_inline void coarseLinkCompress(vComplexF *out,vComplexF *in,int n) { for(int i=0;i<n;i++) out[i]=in[i]; }
+accelerator_inline void coarseLinkExpand  (vComplexD *out,vComplexF *in,int n) { precisionChange(out,in,n); }
+accelerator_inline void coarseLinkExpand  (vComplexD *out,vComplexH *in,int n) { precisionChange(out,in,n); }
+accelerator_inline void coarseLinkExpand  (vComplexF *out,vComplexH *in,int n) { precisionChange(out,in,n); }
+accelerator_inline void coarseLinkExpand  (vComplexF *out,vComplexF *in,int n) { for(int i=0;i<n;i++) out[i]=in[i]; }
+
 // Fine Object == (per site) type of fine field
 // nbasis      == number of deflation vectors
 template<class Fobj,class CComplex,int nbasis>
@@ -308,6 +345,11 @@ public:
   typedef Lattice<Fobj >        FineField;
   typedef CoarseVector FermionField;
 
+  typedef typename GridTypeMapper<CComplex>::vector_type vCplx;
+  typedef typename CoarseLinkTypes<vCplx>::vSingle       vLinkSingle;
+  typedef typename CoarseLinkTypes<vCplx>::vHalf         vLinkHalf;
+  enum { LinksFull=0, LinksSingle=1, LinksHalf=2 };
+
   // enrich interface, use default implementation as in FermionOperator ///////
   void Dminus(CoarseVector const& in, CoarseVector& out) { out = in; }
   void DminusDag(CoarseVector const& in, CoarseVector& out) { out = in; }
@@ -338,6 +380,18 @@ public:
 
   Vector<RealD> dag_factor;
 
+  // Reduced precision copies of A, Aeven, Aodd used by the stencil kernels
+  // (except the self term of Mooee) when linkPrecision != LinksFull; the
+  // full precision hopping terms are then released (fullLinks==0)
+  int linkPrecision;
+  int fullLinks;
+  std::vector<Vector<vLinkSingle> > SingleLinks[3];
+  std::vector<Vector<vLinkHalf> >   HalfLinks[3];
+
+  // How CoarsenOperator/UpdateOperator obtain the links, see CoarsenLinks
+  enum { CoarsenMasked=0, CoarsenProbing=1 };
+  int coarsenMethod;
+
   ///////////////////////
   // Interface
   ///////////////////////
@@ -355,6 +409,11 @@ public:
     SimpleCompressor<siteVector> compressor;
 
     Stencil.HaloExchange(in,compressor);
+
+    std::vector<int> all(geom.npoint);
+    for(int p=0;p<geom.npoint;p++) all[p]=p;
+    if ( CompressedApply(Stencil,A,all,in,out,0) ) return;
+
     autoView( in_v , in, AcceleratorRead);
     autoView( out_v , out, AcceleratorWrite);
     autoView( Stencil_v  , Stencil, AcceleratorRead);
@@ -421,6 +480,11 @@ public:
     SimpleCompressor<siteVector> compressor;
 
     Stencil.HaloExchange(in,compressor);
+
+    std::vector<int> all(geom.npoint);
+    for(int p=0;p<geom.npoint;p++) all[p]=geom.points_dagger[p];
+    if ( CompressedApply(Stencil,A,all,in,out,1) ) return;
+
     autoView( in_v , in, AcceleratorRead);
     autoView( out_v , out, AcceleratorWrite);
     autoView( Stencil_v  , Stencil, AcceleratorRead);
@@ -487,6 +551,8 @@ public:
     conformable(_grid,out.Grid());
     out.Checkerboard() = in.Checkerboard();
 
+    if ( CompressedApply(Stencil,A,std::vector<int>(1,point),in,out,0) ) return;
+
     typedef LatticeView<Cobj> Aview;
     Vector<Aview> AcceleratorViewContainer;
     for(int p=0;p<geom.npoint;p++) AcceleratorViewContainer.push_back(A[p].View(AcceleratorRead));
@@ -699,10 +765,6 @@ public:
     SimpleCompressor<siteVector> compressor;
 
     st.HaloExchange(in,compressor);
-    autoView( in_v,  in,  AcceleratorRead);
-    autoView( out_v, out, AcceleratorWrite);
-    autoView( st_v , st,  AcceleratorRead);
-    typedef LatticeView<Cobj> Aview;
 
     // determine in what order we need the points
     int npoint = geom.npoint-1;
@@ -710,6 +772,13 @@ public:
     for(int p=0; p<npoint; p++)
       points[p] = (dag && !hermitian) ? geom.points_dagger[p] : p;
 
+    if ( CompressedApply(st,a,std::vector<int>(points.begin(),points.end()),in,out,dag) ) return;
+
+    autoView( in_v,  in,  AcceleratorRead);
+    autoView( out_v, out, AcceleratorWrite);
+    autoView( st_v , st,  AcceleratorRead);
+    typedef LatticeView<Cobj> Aview;
+
     auto points_p = &points[0];
 
     Vector<Aview> AcceleratorViewContainer;
@@ -793,7 +862,10 @@ public:
     AselfInv(&CoarseGrid),
     AselfInvEven(_cbgrid),
     AselfInvOdd(_cbgrid),
-    dag_factor(nbasis*nbasis)
+    dag_factor(nbasis*nbasis),
+    linkPrecision(LinksFull),
+    fullLinks(1),
+    coarsenMethod(CoarsenMasked)
   {
     fillFactor();
   };
@@ -813,7 +885,10 @@ public:
     AselfInv(&CoarseGrid),
     AselfInvEven(&CoarseRBGrid),
     AselfInvOdd(&CoarseRBGrid),
-    dag_factor(nbasis*nbasis)
+    dag_factor(nbasis*nbasis),
+    linkPrecision(LinksFull),
+    fullLinks(1),
+    coarsenMethod(CoarsenMasked)
   {
     fillFactor();
   };
@@ -836,45 +911,94 @@ public:
 
   void CoarsenOperator(GridBase *FineGrid,LinearOperatorBase<Lattice<Fobj> > &linop,
 		       Aggregation<Fobj,CComplex,nbasis> & Subspace)
+  {
+    std::cout << GridLogMessage<< "CoarsenMatrix "<< std::endl;
+
+    CoarseScalar InnerProd(Grid()); 
+
+    std::cout << GridLogMessage<< "CoarsenMatrix Orthog "<< std::endl;
+    // Orthogonalise the subblocks over the basis
+    blockOrthogonalise(InnerProd,Subspace.subspace);
+
+    CoarsenLinks(FineGrid,linop,Subspace);
+  }
+
+  ////////////////////////////////////////////////////////////////////////////
+  // Recoarsen a modified fine operator (e.g. the gauge field has moved a few
+  // MD steps) on the existing subspace, which must already be orthonormal
+  // (from a previous CoarsenOperator or Aggregation::RefreshSubspace).
+  // A CoarseAgglomeration of this operator needs Refresh() afterwards.
+  ////////////////////////////////////////////////////////////////////////////
+  void UpdateOperator(GridBase *FineGrid,LinearOperatorBase<Lattice<Fobj> > &linop,
+		      Aggregation<Fobj,CComplex,nbasis> & Subspace)
+  {
+    std::cout << GridLogMessage<< "CoarsenMatrix update "<< std::endl;
+    CoarsenLinks(FineGrid,linop,Subspace);
+  }
+
+  ////////////////////////////////////////////////////////////////////////////
+  // CoarsenMasked applies OpDirAll and OpDiag to each basis vector and picks
+  // the stencil points apart with block face masks.
+  // CoarsenProbing needs only Op: each basis vector is modulated by npoint
+  // plane waves on the coarse lattice and the npoint x npoint phase system is
+  // solved site by site. It is exact only when Op couples a block to its
+  // nearest neighbour blocks alone; couplings to diagonal or next neighbours
+  // (a Schur complement, MdagM) alias onto the stencil points. It requires
+  // coarse extent >= 3 in every stencil direction, else the +/- neighbours
+  // coincide; otherwise it falls back to CoarsenMasked.
+  ////////////////////////////////////////////////////////////////////////////
+  bool ProbingPossible(void) {
+    for(int p=0;p<geom.npoint;p++){
+      if ( geom.displacements[p] && (Grid()->_fdimensions[geom.directions[p]]<3) ) return false;
+    }
+    return true;
+  }
+
+  void CoarsenLinks(GridBase *FineGrid,LinearOperatorBase<Lattice<Fobj> > &linop,
+		    Aggregation<Fobj,CComplex,nbasis> & Subspace)
+  {
+    AllocateLinks();
+    GridStopWatch LinkTimer;
+    LinkTimer.Start();
+    if ( (coarsenMethod==CoarsenProbing) && ProbingPossible() ) {
+      CoarsenLinksProbing(FineGrid,linop,Subspace);
+    } else {
+      if ( coarsenMethod==CoarsenProbing ) 
+	std::cout << GridLogMessage << "CoarsenMatrix coarse extent too small for probing; using masks" << std::endl;
+      CoarsenLinksMasked(FineGrid,linop,Subspace);
+    }
+    LinkTimer.Stop();
+    std::cout << GridLogMessage << "CoarsenMatrix links computed in " << LinkTimer.Elapsed() << std::endl;
+
+    InvertSelfStencilLink(); std::cout << GridLogMessage << "Coarse self link inverted" << std::endl;
+    FillHalfCbs(); std::cout << GridLogMessage << "Coarse half checkerboards filled" << std::endl;
+  }
+
+  void CoarsenLinksMasked(GridBase *FineGrid,LinearOperatorBase<Lattice<Fobj> > &linop,
+			  Aggregation<Fobj,CComplex,nbasis> & Subspace)
   {
     typedef Lattice<typename Fobj::tensor_reduced> FineComplexField;
     typedef typename Fobj::scalar_type scalar_type;
 
-    std::cout << GridLogMessage<< "CoarsenMatrix "<< std::endl;
-
     FineComplexField one(FineGrid); one=scalar_type(1.0,0.0);
     FineComplexField zero(FineGrid); zero=scalar_type(0.0,0.0);
 
     std::vector<FineComplexField> masks(geom.npoint,FineGrid);
-    FineComplexField imask(FineGrid); // contributions from within this block
-    FineComplexField omask(FineGrid); // contributions from outwith this block
 
     FineComplexField evenmask(FineGrid);
     FineComplexField oddmask(FineGrid); 
 
     FineField     phi(FineGrid);
     FineField     tmp(FineGrid);
-    FineField     zz(FineGrid); zz=Zero();
-    FineField    Mphi(FineGrid);
     FineField    Mphie(FineGrid);
     FineField    Mphio(FineGrid);
     std::vector<FineField>     Mphi_p(geom.npoint,FineGrid);
 
     Lattice<iScalar<vInteger> > coor (FineGrid);
-    Lattice<iScalar<vInteger> > bcoor(FineGrid);
     Lattice<iScalar<vInteger> > bcb  (FineGrid); bcb = Zero();
 
-    CoarseVector iProj(Grid()); 
     CoarseVector oProj(Grid()); 
     CoarseVector SelfProj(Grid()); 
-    CoarseComplexField iZProj(Grid()); 
-    CoarseComplexField oZProj(Grid()); 
-
-    CoarseScalar InnerProd(Grid()); 
-
-    std::cout << GridLogMessage<< "CoarsenMatrix Orthog "<< std::endl;
-    // Orthogonalise the subblocks over the basis
-    blockOrthogonalise(InnerProd,Subspace.subspace);
 
     // Compute the matrix elements of linop between this orthonormal
     // set of vectors.
@@ -923,42 +1047,42 @@ public:
 
       for(int p=0;p<geom.npoint;p++){ 
 
-	Mphi = Mphi_p[p];
-
 	int dir   = geom.directions[p];
 	int disp  = geom.displacements[p];
 
 	if ( (disp==-1) || (!hermitian ) ) {
 
 	  ////////////////////////////////////////////////////////////////////////
-	  // Pick out contributions coming from this cell and neighbour cell
+	  // Pick out contributions coming from the neighbour cell; one pass
+	  // projects onto every basis vector j
 	  ////////////////////////////////////////////////////////////////////////
-	  omask = masks[p];
-	  imask = one-omask;
-	
-	  for(int j=0;j<nbasis;j++){
-	    
-	    blockMaskedInnerProduct(oZProj,omask,Subspace.subspace[j],Mphi);
-	    
-	    autoView( iZProj_v , iZProj, AcceleratorRead) ;
-	    autoView( oZProj_v , oZProj, AcceleratorRead) ;
+	  mult(tmp,Mphi_p[p],masks[p]);
+	  blockProjectFused(oProj,tmp,Subspace.subspace);
+
+	  {
+	    autoView( oProj_v , oProj, AcceleratorRead) ;
 	    autoView( A_p     ,  A[p], AcceleratorWrite);
-	    autoView( A_self  , A[self_stencil], AcceleratorWrite);
-
-	    accelerator_for(ss, Grid()->oSites(), Fobj::Nsimd(),{ coalescedWrite(A_p[ss](j,i),oZProj_v(ss)); });
-	    if ( hermitian && (disp==-1) ) {
-	      for(int pp=0;pp<geom.npoint;pp++){// Find the opposite link and set <j|A|i> = <i|A|j>*
-		int dirp   = geom.directions[pp];
-		int dispp  = geom.displacements[pp];
-		if ( (dirp==dir) && (dispp==1) ){
-		  auto sft = conjugate(Cshift(oZProj,dir,1));
-		  autoView( sft_v    ,  sft  , AcceleratorWrite);
-		  autoView( A_pp     ,  A[pp], AcceleratorWrite);
-		  accelerator_for(ss, Grid()->oSites(), Fobj::Nsimd(),{ coalescedWrite(A_pp[ss](i,j),sft_v(ss)); });
-		}
+	    accelerator_for(ss, Grid()->oSites(), Fobj::Nsimd(),{
+	      for(int j=0;j<nbasis;j++){
+		coalescedWrite(A_p[ss](j,i),oProj_v(ss)(j));
+	      }
+	    });
+	  }
+	  if ( hermitian && (disp==-1) ) {
+	    for(int pp=0;pp<geom.npoint;pp++){// Find the opposite link and set <j|A|i> = <i|A|j>*
+	      int dirp   = geom.directions[pp];
+	      int dispp  = geom.displacements[pp];
+	      if ( (dirp==dir) && (dispp==1) ){
+		CoarseVector sft = conjugate(Cshift(oProj,dir,1));
+		autoView( sft_v    ,  sft  , AcceleratorRead);
+		autoView( A_pp     ,  A[pp], AcceleratorWrite);
+		accelerator_for(ss, Grid()->oSites(), Fobj::Nsimd(),{
+		  for(int j=0;j<nbasis;j++){
+		    coalescedWrite(A_pp[ss](i,j),sft_v(ss)(j));
+		  }
+		});
 	      }
 	    }
-
 	  }
 	}
       }
@@ -981,7 +1105,7 @@ public:
 	    });
 	}
 
-	blockProject(SelfProj,tmp,Subspace.subspace);
+	blockProjectFused(SelfProj,tmp,Subspace.subspace);
 
 	autoView( SelfProj_ , SelfProj, AcceleratorRead);
 	autoView( A_self  , A[self_stencil], AcceleratorWrite);
@@ -997,9 +1121,106 @@ public:
     if(hermitian) {
       std::cout << GridLogMessage << " ForceHermitian, new code "<<std::endl;
     }
+  }
 
-    InvertSelfStencilLink(); std::cout << GridLogMessage << "Coarse self link inverted" << std::endl;
-    FillHalfCbs(); std::cout << GridLogMessage << "Coarse half checkerboards filled" << std::endl;
+  ////////////////////////////////////////////////////////////////////////////
+  // Plane wave k has momentum sign_k*2pi/L along direction dir_k (k=0 is
+  // constant). Projecting Op acting on wave_k(x)|i> gives at coarse site x
+  //   wave_k(x) sum_p Lambda(k,p) A_p(x)(j,i),  Lambda(k,p) = wave_k(x+d_p)/wave_k(x)
+  // so A_p(x) = sum_k Lambda^-1(p,k) conj(wave_k(x)) proj_k(x).
+  // Hermiticity is not imposed; it holds to rounding for hermitian operators.
+  ////////////////////////////////////////////////////////////////////////////
+  void CoarsenLinksProbing(GridBase *FineGrid,LinearOperatorBase<Lattice<Fobj> > &linop,
+			   Aggregation<Fobj,CComplex,nbasis> & Subspace)
+  {
+    typedef typename vCplx::scalar_type Cscalar;
+
+    // The phase system only separates the nearest neighbour stencil
+    int npoint = geom.npoint;
+    assert(npoint==2*Grid()->_ndimension+1);
+    for(int p=0;p<npoint;p++) assert(std::abs(geom.displacements[p])<=1);
+    std::vector<int> kdir(1,-1);
+    std::vector<int> ksign(1,0);
+    for(int p=0;p<npoint;p++){
+      if ( geom.displacements[p]==1 ) {
+	kdir.push_back(geom.directions[p]); ksign.push_back( 1);
+	kdir.push_back(geom.directions[p]); ksign.push_back(-1);
+      }
+    }
+    assert(kdir.size()==npoint);
+
+    Eigen::MatrixXcd Lambda = Eigen::MatrixXcd::Ones(npoint,npoint);
+    for(int k=1;k<npoint;k++){
+      RealD theta = ksign[k]*2.0*M_PI/Grid()->_fdimensions[kdir[k]];
+      for(int p=0;p<npoint;p++){
+	if ( geom.directions[p]==kdir[k] && geom.displacements[p] ) {
+	  Lambda(k,p) = std::exp(ComplexD(0.0,theta*geom.displacements[p]));
+	}
+      }
+    }
+    Eigen::MatrixXcd LambdaInv = Lambda.inverse();
+    std::vector<Cscalar> Linv(npoint*npoint);
+    for(int p=0;p<npoint;p++){
+      for(int k=0;k<npoint;k++){
+	Linv[p*npoint+k] = Cscalar(LambdaInv(p,k).real(),LambdaInv(p,k).imag());
+      }
+    }
+
+    std::vector<CoarseComplexField> wave(npoint,Grid());
+    for(int k=0;k<npoint;k++){
+      Coordinate lstart = Grid()->_lstart;
+      int    dir   = kdir[k];
+      RealD  theta = (k==0) ? 0.0 : ksign[k]*2.0*M_PI/Grid()->_fdimensions[dir];
+      autoView(wave_v, wave[k], CpuWrite);
+      thread_for(site, Grid()->lSites(), {
+	Coordinate lcoor;
+	Grid()->LocalIndexToLocalCoor(site, lcoor);
+	RealD arg = (k==0) ? 0.0 : theta*(lcoor[dir]+lstart[dir]);
+	Cscalar w(std::cos(arg),std::sin(arg));
+	pokeLocalSite(w, wave_v, lcoor);
+      });
+    }
+
+    FineField     phi(FineGrid);
+    FineField    Mphi(FineGrid);
+    FineField      zz(FineGrid);
+    std::vector<CoarseVector> proj(npoint,Grid());
+    CoarseVector acc(Grid());
+
+    for(int i=0;i<nbasis;i++){
+
+      std::cout << GridLogMessage<< "CoarsenMatrix probing vector "<<i << std::endl;
+      zz = Zero(); zz.Checkerboard() = Subspace.subspace[i].Checkerboard();
+
+      for(int k=0;k<npoint;k++){
+	blockZAXPY(phi,wave[k],Subspace.subspace[i],zz);
+	linop.Op(phi,Mphi);
+	blockProjectFused(proj[k],Mphi,Subspace.subspace);
+
+	autoView( proj_v , proj[k], AcceleratorWrite);
+	autoView( wave_v , wave[k], AcceleratorRead);
+	accelerator_for(ss, Grid()->oSites(), Fobj::Nsimd(),{
+	  auto w = conjugate(wave_v(ss));
+	  auto v = proj_v(ss);
+	  for(int j=0;j<nbasis;j++){
+	    coalescedWrite(proj_v[ss](j),w*v(j));
+	  }
+	});
+      }
+
+      for(int p=0;p<npoint;p++){
+	acc = Linv[p*npoint]*proj[0];
+	for(int k=1;k<npoint;k++) acc = acc + Linv[p*npoint+k]*proj[k];
+
+	autoView( acc_v , acc , AcceleratorRead);
+	autoView( A_p   , A[p], AcceleratorWrite);
+	accelerator_for(ss, Grid()->oSites(), Fobj::Nsimd(),{
+	  for(int j=0;j<nbasis;j++){
+	    coalescedWrite(A_p[ss](j,i),acc_v(ss)(j));
+	  }
+	});
+      }
+    }
   }
 
   void InvertSelfStencilLink() {
@@ -1044,6 +1265,175 @@ public:
     }
     pickCheckerboard(Even, AselfInvEven, AselfInv);
     pickCheckerboard(Odd, AselfInvOdd, AselfInv);
+    if ( linkPrecision != LinksFull ) CompressLinks();
+  }
+
+  ////////////////////////////////////////////////////////////////////////////
+  // Hold the links used by M, Mdag, Mdir, MdirAll and Dhop in single or half
+  // precision; they are expanded row by row and accumulated in the precision
+  // of CComplex. Only the self links used by Mooee and its inverse are kept
+  // in full precision: the hopping terms of A, Aeven and Aodd are released
+  // once compressed, and reallocated by CoarsenOperator/UpdateOperator.
+  // Returning to a higher precision expands the compressed copy, so the
+  // rounding of the reduced storage is kept.
+  ////////////////////////////////////////////////////////////////////////////
+  void SetLinkPrecision(int prec) {
+    assert( (prec==LinksFull) || (prec==LinksSingle) || (prec==LinksHalf) );
+#ifdef GRID_SIMT
+    if ( prec != LinksFull ) {
+      std::cout << GridLogMessage << "CoarsenedMatrix: reduced precision links are host only; keeping full precision" << std::endl;
+      prec = LinksFull;
+    }
+#endif
+    if ( (prec==LinksSingle) && std::is_same<vCplx,vLinkSingle>::value ) prec = LinksFull;
+    if ( prec==LinksSingle ) assert( nbasis % (vLinkSingle::Nsimd()/vCplx::Nsimd()) == 0 );
+    if ( prec==LinksHalf   ) assert( nbasis % (vLinkHalf::Nsimd()  /vCplx::Nsimd()) == 0 );
+    if ( prec==linkPrecision ) return;
+    if ( !fullLinks ) {
+      AllocateLinks();
+      for(int p=0;p<geom.npoint-1;p++) {
+	ExpandLink(p,A[p]);
+	pickCheckerboard(Even, Aeven[p], A[p]);
+	pickCheckerboard(Odd , Aodd[p] , A[p]);
+      }
+    }
+    linkPrecision = prec;
+    CompressLinks();
+  }
+  int LinkPrecision(void) { return linkPrecision; }
+
+  // Full precision storage for the hopping terms, contents undefined if they were released
+  void AllocateLinks(void) {
+    if ( fullLinks ) return;
+    for(int p=0;p<geom.npoint-1;p++) {
+      A[p]     = CoarseMatrix(_grid);
+      Aeven[p] = CoarseMatrix(_cbgrid);
+      Aodd[p]  = CoarseMatrix(_cbgrid);
+    }
+    fullLinks = 1;
+  }
+  void ReleaseLinks(void) {
+    if ( !fullLinks ) return;
+    for(int p=0;p<geom.npoint-1;p++) { // moving out frees the storage
+      CoarseMatrix a(std::move(A[p]));
+      CoarseMatrix e(std::move(Aeven[p]));
+      CoarseMatrix o(std::move(Aodd[p]));
+    }
+    fullLinks = 0;
+  }
+
+  // Link p on the full grid in full precision, expanded from the compressed copy if need be
+  void Link(int p,CoarseMatrix &a) {
+    conformable(a.Grid(),_grid);
+    if ( fullLinks || (p==geom.npoint-1) ) a = A[p];
+    else                                   ExpandLink(p,a);
+  }
+  void ExpandLink(int p,CoarseMatrix &a) {
+    a.Checkerboard() = A[geom.npoint-1].Checkerboard();
+    if ( linkPrecision == LinksSingle ) ExpandLinks(SingleLinks[0][p],a);
+    else                                ExpandLinks(HalfLinks[0][p]  ,a);
+  }
+
+  void CompressLinks(void) {
+    for(int w=0;w<3;w++) { SingleLinks[w].resize(0); HalfLinks[w].resize(0); }
+    if ( linkPrecision == LinksSingle ) {
+      CompressLinks(A    ,SingleLinks[0]);
+      CompressLinks(Aeven,SingleLinks[1]);
+      CompressLinks(Aodd ,SingleLinks[2]);
+    }
+    if ( linkPrecision == LinksHalf ) {
+      CompressLinks(A    ,HalfLinks[0]);
+      CompressLinks(Aeven,HalfLinks[1]);
+      CompressLinks(Aodd ,HalfLinks[2]);
+    }
+    if ( linkPrecision != LinksFull ) ReleaseLinks();
+  }
+
+  template<class vLink>
+  void CompressLinks(std::vector<CoarseMatrix> &a,std::vector<Vector<vLink> > &c) {
+    const int ratio = vLink::Nsimd()/vCplx::Nsimd();
+    const int nb2   = nbasis*nbasis;
+    c.resize(a.size());
+    for(int p=0;p<a.size();p++){
+      uint64_t osites = a[p].Grid()->oSites();
+      c[p].resize(osites*nb2/ratio);
+      autoView( a_v, a[p], CpuRead);
+      vLink *c_p = &c[p][0];
+      thread_for(ss, osites, {
+	coarseLinkCompress(c_p+ss*(nb2/ratio),(vCplx *)&a_v[ss],nb2);
+      });
+    }
+  }
+
+  template<class vLink>
+  void ExpandLinks(Vector<vLink> &c,CoarseMatrix &a) {
+    const int ratio = vLink::Nsimd()/vCplx::Nsimd();
+    const int nb2   = nbasis*nbasis;
+    uint64_t osites = a.Grid()->oSites();
+    autoView( a_v, a, CpuWrite);
+    vLink *c_p = &c[0];
+    thread_for(ss, osites, {
+      coarseLinkExpand((vCplx *)&a_v[ss],c_p+ss*(nb2/ratio),nb2);
+    });
+  }
+
+  // Returns false when the links are held in full precision
+  bool CompressedApply(CartesianStencil<siteVector,siteVector,int> &st, std::vector<CoarseMatrix> &a,
+		       const std::vector<int> &points, const CoarseVector &in, CoarseVector &out, int dag) {
+    if ( linkPrecision == LinksFull ) return false;
+    int w = (&a==&A) ? 0 : ( (&a==&Aeven) ? 1 : 2 );
+    assert( (w!=2) || (&a==&Aodd) );
+    if ( linkPrecision == LinksSingle ) CompressedStencilApply(st,SingleLinks[w],points,in,out,dag);
+    else                                CompressedStencilApply(st,HalfLinks[w]  ,points,in,out,dag);
+    return true;
+  }
+
+  // Sum over the given points with halo already exchanged; dag applies dag_factor
+  template<class vLink>
+  void CompressedStencilApply(CartesianStencil<siteVector,siteVector,int> &st, std::vector<Vector<vLink> > &links,
+			      const std::vector<int> &points, const CoarseVector &in, CoarseVector &out, int dag) {
+    const int ratio  = vLink::Nsimd()/vCplx::Nsimd();
+    const int nb2    = nbasis*nbasis;
+    const int npoint = points.size();
+
+    std::vector<vLink *> links_p(geom.npoint,nullptr);
+    for(int p=0;p<npoint;p++) links_p[points[p]] = &links[points[p]][0];
+    RealD *dag_factor_p = &dag_factor[0];
+
+    autoView( in_v,  in,  CpuRead);
+    autoView( out_v, out, CpuWrite);
+    autoView( st_v , st,  CpuRead);
+
+    thread_for(ss, in.Grid()->oSites(), {
+      siteVector res = Zero();
+      siteVector nbr;
+      vCplx      row[nbasis];
+      CComplex  *rowc = (CComplex *)row;
+      int ptype;
+      StencilEntry *SE;
+
+      for(int p=0;p<npoint;p++){
+	int point = points[p];
+	SE=st_v.GetEntry(ptype,point,ss);
+
+	if(SE->_is_local) {
+	  nbr = coalescedReadPermute(in_v[SE->_offset],ptype,SE->_permute);
+	} else {
+	  nbr = st_v.CommBuf()[SE->_offset];
+	}
+
+	vLink *l = links_p[point] + ss*(nb2/ratio);
+	for(int b=0;b<nbasis;b++){
+	  coarseLinkExpand(row,l+b*(nbasis/ratio),nbasis);
+	  if ( dag ) {
+	    for(int bb=0;bb<nbasis;bb++) res(b) = res(b) + dag_factor_p[b*nbasis+bb]*rowc[bb]*nbr(bb);
+	  } else {
+	    for(int bb=0;bb<nbasis;bb++) res(b) = res(b) + rowc[bb]*nbr(bb);
+	  }
+	}
+      }
+      out_v[ss] = res;
+    });
   }
 };
 
@@ -106,17 +106,17 @@ class BiCGSTAB : public OperatorFunction<Field>
       GridStopWatch MatrixTimer;
       GridStopWatch SolverTimer;
 
+      // <rhat,r> for the next iteration is formed with the residual update
+      ComplexD Crho = a;
+
       SolverTimer.Start();
       int k;
       for (k = 1; k <= MaxIterations; k++) 
       {
         rho_prev = rho;
+        rho = Crho.real();
 
         LinalgTimer.Start();
-        InnerTimer.Start();
-        ComplexD Crho  = innerProduct(rhat,r);
-        InnerTimer.Stop();
-        rho = Crho.real();
 
         beta = (rho / rho_prev) * (alpha / omega);
 
@@ -153,10 +153,8 @@ class BiCGSTAB : public OperatorFunction<Field>
 	  autoView( s_v  ,  s, AcceleratorWrite);
 	  accelerator_for(ss, h_v.size(), Field::vector_object::Nsimd(),{
 	      coalescedWrite(h_v[ss], alpha*p_v(ss) + psi_v(ss));
-	    });
-	  accelerator_for(ss, s_v.size(), Field::vector_object::Nsimd(),{
 	      coalescedWrite(s_v[ss], -alpha*v_v(ss) + r_v(ss));
- 	  });
+	  });
         }
         LinearCombTimer.Stop();
         LinalgTimer.Stop();
@@ -167,25 +165,16 @@ class BiCGSTAB : public OperatorFunction<Field>
 
         LinalgTimer.Start();
         InnerTimer.Start();
-        ComplexD Comega = innerProduct(t,s);
+        ComplexD Comega;
+        RealD tt;
+        innerProductNorm(Comega, tt, t, s);
         InnerTimer.Stop();
-        omega = Comega.real() / norm2(t);
+        omega = Comega.real() / tt;
 
         LinearCombTimer.Start();
-	{
-	  autoView( psi_v,psi, AcceleratorWrite);
-	  autoView( r_v , r, AcceleratorWrite);
-	  autoView( h_v , h, AcceleratorRead);
-	  autoView( s_v , s, AcceleratorRead);
-	  autoView( t_v , t, AcceleratorRead);
-	  accelerator_for(ss, psi_v.size(), Field::vector_object::Nsimd(),{
-	      coalescedWrite(psi_v[ss], h_v(ss) + omega * s_v(ss));
-	      coalescedWrite(r_v[ss], -omega * t_v(ss) + s_v(ss));
-	    });
-	}
+        // psi = omega s + h ; r = -omega t + s ; cp = |r|^2 ; Crho = <rhat,r>
+        cp = axpy_axpy_norm_inner(Crho, psi, omega, s, h, r, -omega, t, s, rhat);
         LinearCombTimer.Stop();
-	
-        cp = norm2(r);
         LinalgTimer.Stop();
 
         std::cout << GridLogIterative << "BiCGSTAB: Iteration " << k << " residual " << sqrt(cp/ssq) << " target " << Tolerance << std::endl;
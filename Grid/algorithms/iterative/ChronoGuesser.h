@@ -0,0 +1,134 @@
+/*************************************************************************************
+
+    Grid physics library, www.github.com/paboyle/Grid
+
+    Source file: ./lib/algorithms/iterative/ChronoGuesser.h
+
+    Copyright (C) 2015
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License along
+    with this program; if not, write to the Free Software Foundation, Inc.,
+    51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+
+    See the full license in the file "LICENSE" in the top level distribution directory
+*************************************************************************************/
+/*  END LEGAL */
+#pragma once
+
+NAMESPACE_BEGIN(Grid);
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+// Chronological initial guesses for a sequence of Hermitian positive solves HermOp x = b
+// with a slowly varying operator, e.g. the pseudofermion force along an MD trajectory.
+//
+// The last Depth solutions are kept in a ring buffer; the guess is the minimal residual
+// (HermOp norm) combination of them, as in ChronoForecast (Brower et al., hep-lat/9509012).
+// Nearly dependent history vectors are dropped before the projection.
+//
+// The guess makes a solution depend on the history, so the MD is reversible only to the
+// accuracy of the solve: along a short force path the forward and backward forces differ
+// by one to two times the solver error (Test_chrono_force: about 1e-9 relative with a
+// 1e-10 CG, but 1e-7 with the 1e-8 CG common for MD forces). Guesses are therefore only
+// made for solvers whose stopping tolerance is at most MaxTolerance, by default 1e-10;
+// a larger MaxTolerance accepts the larger reversibility violation deliberately. The
+// history must be Reset whenever the trajectory is restarted (the actions do this in
+// refresh). One guesser per action: the history is the action's own solutions, and
+// sharing it between different systems defeats the extrapolation.
+///////////////////////////////////////////////////////////////////////////////////////////////////
+template<class Field>
+class ChronoGuesser {
+public:
+  ChronoGuesser(int _Depth,RealD _MaxTolerance=1.0e-10)
+    : Depth(_Depth), MaxTolerance(_MaxTolerance), next(0), count(0), warned(false)
+  {
+    assert(Depth>0);
+  };
+
+  int   Depth;
+  RealD MaxTolerance;
+
+  void Reset(void) { next=0; count=0; };
+  int  Size(void)  { return count; };
+
+  // Only ConjugateGradient reports its tolerance; other solvers are trusted
+  bool Admissible(OperatorFunction<Field> &Solver)
+  {
+    ConjugateGradient<Field> *CG = dynamic_cast<ConjugateGradient<Field> *>(&Solver);
+    if ( (CG==nullptr) || (CG->Tolerance<=MaxTolerance) ) return true;
+    if ( !warned ) {
+      std::cout << GridLogMessage << "ChronoGuesser: solver tolerance "<<CG->Tolerance
+		<<" above "<<MaxTolerance<<" is not reversibility safe; using zero initial guess"<<std::endl;
+      warned=true;
+    }
+    return false;
+  }
+
+  void Update(const Field &sol)
+  {
+    if ( history.size()<Depth ) history.push_back(sol);
+    else                        history[next] = sol;
+    next  = (next+1)%Depth;
+    count = std::min(count+1,Depth);
+  }
+
+  void Guess(LinearOperatorBase<Field> &HermOp,const Field &src,Field &guess)
+  {
+    guess.Checkerboard() = src.Checkerboard();
+    if ( count==0 ) {
+      guess = Zero();
+      return;
+    }
+
+    // Newest first, modified Gram-Schmidt
+    std::vector<Field> v;
+    for(int n=0;n<count;n++){
+      Field w = history[(next-1-n+Depth)%Depth];
+      RealD nw = norm2(w);
+      for(int j=0;j<v.size();j++) w = w - innerProduct(v[j],w)*v[j];
+      RealD nv = norm2(w);
+      if ( nv > 1.0e-12*nw ) v.push_back(w*(1.0/std::sqrt(nv)));
+    }
+    int k = v.size();
+
+    std::vector<Field> Av(k,src.Grid());
+    Eigen::MatrixXcd G(k,k);
+    Eigen::VectorXcd c(k);
+    for(int i=0;i<k;i++){
+      HermOp.HermOp(v[i],Av[i]);
+      c(i) = innerProduct(v[i],src);
+      for(int j=0;j<=i;j++){
+	G(j,i) = innerProduct(v[j],Av[i]);
+	G(i,j) = std::conj(G(j,i));
+      }
+    }
+    Eigen::VectorXcd a = G.ldlt().solve(c);
+
+    Field r(src);
+    guess = Zero();
+    for(int i=0;i<k;i++){
+      ComplexD ai = a(i);
+      guess = guess + ai*v[i];
+      r     = r     - ai*Av[i];
+    }
+    std::cout << GridLogMessage << "ChronoGuesser: "<<k<<" of "<<count<<" previous solutions; |res|/|src| = "
+	      << std::sqrt(norm2(r)/norm2(src)) << std::endl;
+  }
+
+private:
+  std::vector<Field> history;
+  int  next;
+  int  count;
+  bool warned;
+};
+
+NAMESPACE_END(Grid);
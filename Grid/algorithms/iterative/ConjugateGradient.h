@@ -140,15 +140,8 @@ public:
       b = cp / c;
 
       LinearCombTimer.Start();
-      {
-	autoView( psi_v , psi, AcceleratorWrite);
-	autoView( p_v   , p,   AcceleratorWrite);
-	autoView( r_v   , r,   AcceleratorWrite);
-	accelerator_for(ss,p_v.size(), Field::vector_object::Nsimd(),{
-	    coalescedWrite(psi_v[ss], a      *  p_v(ss) + psi_v(ss));
-	    coalescedWrite(p_v[ss]  , b      *  p_v(ss) + r_v  (ss));
-	});
-      }
+      // psi = a p + psi ; p = b p + r
+      axpy_axpy(psi, a, p, psi, p, b, p, r);
       LinearCombTimer.Stop();
       LinalgTimer.Stop();
 
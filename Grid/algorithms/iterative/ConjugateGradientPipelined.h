@@ -0,0 +1,369 @@
+/*************************************************************************************
+
+Grid physics library, www.github.com/paboyle/Grid
+
+Source file: ./lib/algorithms/iterative/ConjugateGradientPipelined.h
+
+Copyright (C) 2015
+
+This program is free software; you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation; either version 2 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along
+with this program; if not, write to the Free Software Foundation, Inc.,
+51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+
+See the full license in the file "LICENSE" in the top level distribution
+directory
+*************************************************************************************/
+			   /*  END LEGAL */
+#ifndef GRID_CONJUGATE_GRADIENT_PIPELINED_H
+#define GRID_CONJUGATE_GRADIENT_PIPELINED_H
+
+NAMESPACE_BEGIN(Grid);
+
+/////////////////////////////////////////////////////////////////////////////////
+// Communication reducing CG variants; both use ONE global reduction per iteration
+// against two for ConjugateGradient.
+//
+// CGChronopoulosGear : Chronopoulos and Gear, J. Comput. Appl. Math 25 (1989).
+//                      (r,r) and (w,r), w = A r, are summed in one GlobalSumVector.
+//
+// CGPipelined        : Ghysels and Vanroose, Parallel Computing 40 (2014).
+//                      Carries q = A w so the reduction of iteration k is
+//                      independent of the operator application of iteration k,
+//                      and the non-blocking global sum overlaps the two. All
+//                      vector updates and the local parts of the reductions are
+//                      fused into one sweep.
+//                      Recurrences for r,w,s,z drift from their true values;
+//                      ReplacementInterval>0 recomputes them from x and p.
+/////////////////////////////////////////////////////////////////////////////////
+enum PipelinedCGtype { CGPipelined, CGChronopoulosGear };
+
+template <class Field>
+class ConjugateGradientPipelined : public OperatorFunction<Field> {
+public:
+
+  using OperatorFunction<Field>::operator();
+
+  typedef typename Field::vector_object vobj;
+
+  PipelinedCGtype CGtype;
+  bool ErrorOnNoConverge;  // throw an assert when the CG fails to converge.
+                           // Defaults true.
+  RealD Tolerance;
+  Integer MaxIterations;
+  Integer IterationsToComplete; //Number of iterations the CG took to finish. Filled in upon completion
+  Integer ReplacementInterval;  //Residual replacement period for CGPipelined; zero disables
+  RealD TrueResidual;
+
+  ConjugateGradientPipelined(RealD tol, Integer maxit, bool err_on_no_conv = true,
+			     PipelinedCGtype cgtype = CGPipelined, Integer replace = 100)
+    : Tolerance(tol),
+      MaxIterations(maxit),
+      ErrorOnNoConverge(err_on_no_conv),
+      CGtype(cgtype),
+      ReplacementInterval(replace) {};
+
+  void operator()(LinearOperatorBase<Field> &Linop, const Field &src, Field &psi)
+  {
+    psi.Checkerboard() = src.Checkerboard();
+    conformable(psi, src);
+
+    RealD guess = norm2(psi);
+    assert(std::isnan(guess) == 0);
+
+    RealD ssq = norm2(src);
+    if (ssq == 0.){
+      psi = Zero();
+      IterationsToComplete = 1;
+      TrueResidual = 0.;
+      return;
+    }
+
+    std::cout << GridLogIterative << std::setprecision(8) << "ConjugateGradientPipelined: guess " << guess << std::endl;
+    std::cout << GridLogIterative << std::setprecision(8) << "ConjugateGradientPipelined:   src " << ssq << std::endl;
+
+    switch(CGtype){
+    case CGPipelined:
+      PipelinedSolve(Linop,src,psi,ssq);
+      break;
+    case CGChronopoulosGear:
+      ChronopoulosGearSolve(Linop,src,psi,ssq);
+      break;
+    default:
+      assert(0);
+    }
+  }
+
+  /////////////////////////////////////////////////////////////////
+  // Ghysels-Vanroose pipelined CG
+  /////////////////////////////////////////////////////////////////
+  void PipelinedSolve(LinearOperatorBase<Field> &Linop, const Field &src, Field &psi, RealD ssq)
+  {
+    GridBase *grid = src.Grid();
+
+    Field r(grid), w(grid), q(grid);
+    Field p(grid), s(grid), z(grid);
+    Field tmp(grid);
+    r.Checkerboard() = w.Checkerboard() = q.Checkerboard() = src.Checkerboard();
+    p.Checkerboard() = s.Checkerboard() = z.Checkerboard() = src.Checkerboard();
+    tmp.Checkerboard() = src.Checkerboard();
+
+    p = Zero();
+    s = Zero();
+    z = Zero();
+
+    Linop.HermOp(psi, tmp);
+    r = src - tmp;
+    Linop.HermOp(r, w);
+
+    ComplexD rw;
+    RealD gamma, delta;
+    innerProductNorm(rw, gamma, r, w);
+    delta = real(rw);
+
+    RealD rsq = Tolerance * Tolerance * ssq;
+    if (gamma <= rsq) {
+      TrueResidual = std::sqrt(gamma/ssq);
+      std::cout << GridLogMessage << "ConjugateGradientPipelined guess is converged already " << std::endl;
+      IterationsToComplete = 0;
+      return;
+    }
+    Linop.HermOp(w, q);
+
+    std::cout << GridLogIterative << std::setprecision(8)
+              << "ConjugateGradientPipelined: k=0 residual " << gamma << " target " << rsq << std::endl;
+
+    GridStopWatch LinalgTimer;
+    GridStopWatch MatrixTimer;
+    GridStopWatch ReduceTimer;
+    GridStopWatch SolverTimer;
+
+    RealD alpha = 0.0, beta = 0.0, gamma_old = 0.0;
+    const uint64_t sites = grid->oSites();
+
+    typedef decltype(innerProductD(vobj(),vobj())) inner_t;
+    Vector<inner_t> rr_tmp(sites);
+    Vector<inner_t> wr_tmp(sites);
+    auto rr_tmp_v = &rr_tmp[0];
+    auto wr_tmp_v = &wr_tmp[0];
+
+    SolverTimer.Start();
+    int k;
+    for (k = 1; k <= MaxIterations; k++) {
+
+      if ( k==1 ) {
+	beta  = 0.0;
+	alpha = gamma / delta;
+      } else {
+	beta  = gamma / gamma_old;
+	alpha = gamma / (delta - beta * gamma / alpha);
+      }
+
+      LinalgTimer.Start();
+      {
+	autoView( psi_v , psi, AcceleratorWrite);
+	autoView( p_v   , p  , AcceleratorWrite);
+	autoView( s_v   , s  , AcceleratorWrite);
+	autoView( z_v   , z  , AcceleratorWrite);
+	autoView( r_v   , r  , AcceleratorWrite);
+	autoView( w_v   , w  , AcceleratorWrite);
+	autoView( q_v   , q  , AcceleratorRead);
+	accelerator_for(ss, sites, 1, {
+	  auto zz = q_v[ss] + beta * z_v[ss];
+	  auto sv = w_v[ss] + beta * s_v[ss];
+	  auto pp = r_v[ss] + beta * p_v[ss];
+	  auto rn = r_v[ss] - alpha * sv;
+	  auto wn = w_v[ss] - alpha * zz;
+	  psi_v[ss] = psi_v[ss] + alpha * pp;
+	  z_v[ss] = zz;
+	  s_v[ss] = sv;
+	  p_v[ss] = pp;
+	  r_v[ss] = rn;
+	  w_v[ss] = wn;
+	  rr_tmp_v[ss] = innerProductD(rn,rn);
+	  wr_tmp_v[ss] = innerProductD(rn,wn);
+	});
+      }
+      LinalgTimer.Stop();
+
+      ComplexD red[2];
+      CommsRequest_t red_req;
+      bool replace = (ReplacementInterval > 0) && ((k % ReplacementInterval) == 0);
+      if ( replace ) {
+	// Replace recurred vectors with their true values
+	MatrixTimer.Start();
+	Linop.HermOp(psi, tmp);
+	r = src - tmp;
+	Linop.HermOp(r, w);
+	Linop.HermOp(p, s);
+	Linop.HermOp(s, z);
+	MatrixTimer.Stop();
+	ReduceTimer.Start();
+	RealD rr;
+	innerProductNorm(red[1], rr, r, w);
+	red[0] = rr;
+	ReduceTimer.Stop();
+      } else {
+	ReduceTimer.Start();
+	red[0] = TensorRemove(sum(rr_tmp_v,sites));
+	red[1] = TensorRemove(sum(wr_tmp_v,sites));
+	grid->GlobalSumVectorBegin(&red[0],2,red_req);
+	ReduceTimer.Stop();
+      }
+
+      // Reduction in flight while q = A w is applied
+      MatrixTimer.Start();
+      Linop.HermOp(w, q);
+      MatrixTimer.Stop();
+
+      if ( !replace ) {
+	ReduceTimer.Start();
+	grid->GlobalSumWait(red_req);
+	ReduceTimer.Stop();
+      }
+
+      gamma_old = gamma;
+      gamma = real(red[0]);
+      delta = real(red[1]);
+
+      std::cout << GridLogIterative << "ConjugateGradientPipelined: Iteration " << k
+                << " residual " << std::sqrt(gamma/ssq) << " target " << Tolerance << std::endl;
+
+      if (gamma <= rsq) {
+	SolverTimer.Stop();
+	std::cout << GridLogIterative << "Time breakdown "<<std::endl;
+	std::cout << GridLogIterative << "\tElapsed    " << SolverTimer.Elapsed() <<std::endl;
+	std::cout << GridLogIterative << "\tMatrix     " << MatrixTimer.Elapsed() <<std::endl;
+	std::cout << GridLogIterative << "\tLinalg     " << LinalgTimer.Elapsed() <<std::endl;
+	std::cout << GridLogIterative << "\tReduce     " << ReduceTimer.Elapsed() <<std::endl;
+	Finish(Linop,src,psi,ssq,gamma,k,true);
+	return;
+      }
+    }
+    Finish(Linop,src,psi,ssq,gamma,k,false);
+  }
+
+  /////////////////////////////////////////////////////////////////
+  // Chronopoulos-Gear CG
+  /////////////////////////////////////////////////////////////////
+  void ChronopoulosGearSolve(LinearOperatorBase<Field> &Linop, const Field &src, Field &psi, RealD ssq)
+  {
+    GridBase *grid = src.Grid();
+
+    Field r(grid), w(grid), p(grid), s(grid);
+    r.Checkerboard() = w.Checkerboard() = src.Checkerboard();
+    p.Checkerboard() = s.Checkerboard() = src.Checkerboard();
+
+    p = Zero();
+    s = Zero();
+
+    Linop.HermOp(psi, w);
+    r = src - w;
+
+    RealD rsq = Tolerance * Tolerance * ssq;
+
+    GridStopWatch LinalgTimer;
+    GridStopWatch MatrixTimer;
+    GridStopWatch ReduceTimer;
+    GridStopWatch SolverTimer;
+
+    RealD alpha = 0.0, beta = 0.0, gamma = 0.0, gamma_old = 0.0, delta;
+    const uint64_t sites = grid->oSites();
+
+    SolverTimer.Start();
+    int k;
+    for (k = 1; k <= MaxIterations; k++) {
+
+      MatrixTimer.Start();
+      Linop.HermOp(r, w);
+      MatrixTimer.Stop();
+
+      ReduceTimer.Start();
+      ComplexD rw;
+      gamma_old = gamma;
+      innerProductNorm(rw, gamma, r, w);
+      delta = real(rw);
+      ReduceTimer.Stop();
+
+      std::cout << GridLogIterative << "ConjugateGradientPipelined: Iteration " << k-1
+                << " residual " << std::sqrt(gamma/ssq) << " target " << Tolerance << std::endl;
+
+      if (gamma <= rsq) {
+	SolverTimer.Stop();
+	std::cout << GridLogIterative << "Time breakdown "<<std::endl;
+	std::cout << GridLogIterative << "\tElapsed    " << SolverTimer.Elapsed() <<std::endl;
+	std::cout << GridLogIterative << "\tMatrix     " << MatrixTimer.Elapsed() <<std::endl;
+	std::cout << GridLogIterative << "\tLinalg     " << LinalgTimer.Elapsed() <<std::endl;
+	std::cout << GridLogIterative << "\tReduce     " << ReduceTimer.Elapsed() <<std::endl;
+	Finish(Linop,src,psi,ssq,gamma,k-1,true);
+	return;
+      }
+
+      if ( k==1 ) {
+	beta  = 0.0;
+	alpha = gamma / delta;
+      } else {
+	beta  = gamma / gamma_old;
+	alpha = gamma / (delta - beta * gamma / alpha);
+      }
+
+      LinalgTimer.Start();
+      {
+	autoView( psi_v , psi, AcceleratorWrite);
+	autoView( p_v   , p  , AcceleratorWrite);
+	autoView( s_v   , s  , AcceleratorWrite);
+	autoView( r_v   , r  , AcceleratorWrite);
+	autoView( w_v   , w  , AcceleratorRead);
+	accelerator_for(ss, sites, vobj::Nsimd(), {
+	  auto pp = r_v(ss) + beta * p_v(ss);
+	  auto sv = w_v(ss) + beta * s_v(ss);
+	  coalescedWrite(psi_v[ss], psi_v(ss) + alpha * pp);
+	  coalescedWrite(r_v[ss]  , r_v(ss)   - alpha * sv);
+	  coalescedWrite(p_v[ss]  , pp);
+	  coalescedWrite(s_v[ss]  , sv);
+	});
+      }
+      LinalgTimer.Stop();
+    }
+    Finish(Linop,src,psi,ssq,gamma,k,false);
+  }
+
+private:
+
+  void Finish(LinearOperatorBase<Field> &Linop, const Field &src, Field &psi,
+	      RealD ssq, RealD cp, int k, bool converged)
+  {
+    Field mmp(src.Grid());
+    mmp.Checkerboard() = src.Checkerboard();
+    Linop.HermOp(psi, mmp);
+    mmp = mmp - src;
+
+    RealD true_residual = std::sqrt(norm2(mmp)/ssq);
+
+    IterationsToComplete = k;
+    TrueResidual = true_residual;
+
+    if ( converged ) {
+      std::cout << GridLogMessage << "ConjugateGradientPipelined Converged on iteration " << k
+		<< "\tComputed residual " << std::sqrt(cp / ssq)
+		<< "\tTrue residual " << true_residual
+		<< "\tTarget " << Tolerance << std::endl;
+      if (ErrorOnNoConverge) assert(true_residual / Tolerance < 10000.0);
+    } else {
+      std::cout << GridLogMessage << "ConjugateGradientPipelined did NOT converge "<<k<<" / "<< MaxIterations<< std::endl;
+      if (ErrorOnNoConverge) assert(0);
+    }
+  }
+};
+
+NAMESPACE_END(Grid);
+#endif
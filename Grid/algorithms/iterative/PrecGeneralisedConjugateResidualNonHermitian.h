@@ -194,9 +194,8 @@ public:
       rq= innerProduct(q[peri_k],r); // what if rAr not real?
       a = rq/qq[peri_k];
 
-      axpy(psi,a,p[peri_k],psi);         
-
-      cp = axpy_norm(r,-a,q[peri_k],r);
+      // psi = a p + psi ; r = -a q + r
+      cp = axpy_axpy_norm(psi,a,p[peri_k],psi,r,-a,q[peri_k],r);
       LinalgTimer.Stop();
 
       GCRLogLevel<< "PGCR step["<<steps<<"]  resid " << cp << " target " <<rsq<<std::endl; 
@@ -218,20 +217,27 @@ public:
 
       LinalgTimer.Start();
 
-      q[peri_kp]=Az;
-      p[peri_kp]=z;
-
       int northog = ((kp)>(mmax-1))?(mmax-1):(kp);  // if more than mmax done, we orthog all mmax history.
+      if ( northog==0 ) {
+	q[peri_kp]=Az;
+	p[peri_kp]=z;
+	qq[peri_kp]=norm2(q[peri_kp]);
+      }
       for(int back=0;back<northog;back++){
 
 	int peri_back=(k-back)%mmax;   	  assert((k-back)>=0);
 
 	b=-real(innerProduct(q[peri_back],Az))/qq[peri_back];
-	p[peri_kp]=p[peri_kp]+b*p[peri_back];
-	q[peri_kp]=q[peri_kp]+b*q[peri_back];
 
+	// First pass also does the copies p=z, q=Az; last pass also forms |q|^2
+	const Field &py = (back==0) ? z  : p[peri_kp];
+	const Field &qy = (back==0) ? Az : q[peri_kp];
+	if ( back==northog-1 ) {
+	  qq[peri_kp]=axpy_axpy_norm(p[peri_kp],b,p[peri_back],py,q[peri_kp],b,q[peri_back],qy);
+	} else {
+	  axpy_axpy(p[peri_kp],b,p[peri_back],py,q[peri_kp],b,q[peri_back],qy);
+	}
       }
-      qq[peri_kp]=norm2(q[peri_kp]); // could use axpy_norm
       LinalgTimer.Stop();
     }
     assert(0); // never reached
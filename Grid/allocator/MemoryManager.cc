@@ -1,4 +1,7 @@
 #include <Grid/GridCore.h>
+#ifdef __linux__
+#include <sys/mman.h>
+#endif
 
 NAMESPACE_BEGIN(Grid);
 
@@ -10,9 +13,9 @@ NAMESPACE_BEGIN(Grid);
 #define Shared   (4)
 #define SharedSmall (5)
 #undef GRID_MM_VERBOSE 
-uint64_t total_shared;
-uint64_t total_device;
-uint64_t total_host;;
+std::atomic<uint64_t> total_shared;
+std::atomic<uint64_t> total_device;
+std::atomic<uint64_t> total_host;
 void MemoryManager::PrintBytes(void)
 {
   std::cout << " MemoryManager : ------------------------------------ "<<std::endl;
@@ -38,10 +41,148 @@ void MemoryManager::PrintBytes(void)
 //////////////////////////////////////////////////////////////////////
 // Data tables for recently freed pooiniter caches
 //////////////////////////////////////////////////////////////////////
-MemoryManager::AllocationCacheEntry MemoryManager::Entries[MemoryManager::NallocType][MemoryManager::NallocCacheMax];
-int MemoryManager::Victim[MemoryManager::NallocType];
-int MemoryManager::Ncache[MemoryManager::NallocType] = { 2, 8, 2, 8, 2, 8 };
+MemoryManager::AllocationCacheEntry MemoryManager::Entries[MemoryManager::NallocType][MemoryManager::NsizeClass][MemoryManager::NallocCacheMax];
+int MemoryManager::Victim[MemoryManager::NallocType][MemoryManager::NsizeClass];
+// Large entries: room for a few lattice temporaries of an expression alive at once
+int MemoryManager::Ncache[MemoryManager::NallocType] = { 4, 8, 4, 8, 4, 8 };
+int MemoryManager::Nentries[MemoryManager::NallocType];
+int MemoryManager::ClassEntries[MemoryManager::NallocType][MemoryManager::NsizeClass];
+uint64_t MemoryManager::CacheStamp;
 uint64_t MemoryManager::CacheBytes[MemoryManager::NallocType];
+std::mutex MemoryManager::CacheMutex;
+MemoryManager::PoolCounters MemoryManager::Counters[MemoryManager::NallocType];
+
+//////////////////////////////////////////////////////////////////////
+// Size classes
+//////////////////////////////////////////////////////////////////////
+size_t MemoryManager::ClassBytes(size_t bytes)
+{
+  if ( bytes < GRID_ALLOC_SMALL_LIMIT ) {
+    size_t c = GRID_ALLOC_SMALL_MIN;
+    while ( c < bytes ) c*=2;
+    return c;
+  }
+  size_t page = (bytes >= GRID_ALLOC_HUGE_LIMIT) ? GRID_ALLOC_HUGE_PAGE : GRID_ALLOC_SMALL_LIMIT;
+  return ((bytes+page-1)/page)*page;
+}
+int MemoryManager::SizeClass(size_t bytes)
+{
+  // Quarter octave bins: exponent and the two bits below the leading one
+  int lg  = 63-__builtin_clzll((unsigned long long)bytes);
+  int sub = (bytes>>(lg-2))&0x3;
+  return 4*lg+sub;
+}
+
+//////////////////////////////////////////////////////////////////////
+// Pool accounting
+//////////////////////////////////////////////////////////////////////
+void MemoryManager::CountAllocate(int cache,size_t bytes,size_t cbytes,int hit)
+{
+  PoolCounters &c = Counters[cache];
+  c.requests.fetch_add(1,std::memory_order_relaxed);
+  if ( hit ) c.hits.fetch_add(1,std::memory_order_relaxed);
+  c.requestedBytes.fetch_add(bytes,std::memory_order_relaxed);
+  c.reservedBytes.fetch_add(cbytes,std::memory_order_relaxed);
+}
+void MemoryManager::CountFree(int cache,size_t bytes,size_t cbytes)
+{
+  PoolCounters &c = Counters[cache];
+  c.requestedBytes.fetch_sub(bytes,std::memory_order_relaxed);
+  c.reservedBytes.fetch_sub(cbytes,std::memory_order_relaxed);
+}
+void MemoryManager::CountSystem(int cache,int64_t bytes)
+{
+  PoolCounters &c = Counters[cache];
+  uint64_t now = c.systemBytes.fetch_add(bytes,std::memory_order_relaxed)+bytes;
+  uint64_t hw  = c.highWater.load(std::memory_order_relaxed);
+  while ( (now > hw) && !c.highWater.compare_exchange_weak(hw,now,std::memory_order_relaxed) );
+}
+MemoryPoolStats MemoryManager::PoolStatistics(int pool)
+{
+  MemoryPoolStats s;
+  for(int cache=pool;cache<=pool+1;cache++){
+    PoolCounters &c = Counters[cache];
+    s.requests      += c.requests;
+    s.hits          += c.hits;
+    s.requestedBytes+= c.requestedBytes;
+    s.reservedBytes += c.reservedBytes;
+    s.systemBytes   += c.systemBytes;
+    s.highWater     += c.highWater;
+  }
+  return s;
+}
+void MemoryManager::PrintPoolStatistics(void)
+{
+  const char *names[] = { "cpu", "acc", "shared" };
+  int pools[] = { PoolCpu, PoolAcc, PoolShared };
+  for(int p=0;p<3;p++){
+    MemoryPoolStats s = PoolStatistics(pools[p]);
+    if ( s.requests == 0 ) continue;
+    std::cout << GridLogMessage << "MemoryManager "<<names[p]<<" pool : "
+	      << s.requests<<" requests, hit rate "<<100.0*s.hitRate()<<" %"<<std::endl;
+    std::cout << GridLogMessage << "MemoryManager "<<names[p]<<" pool : live "<<memString(s.requestedBytes)
+	      << " held "<<memString(s.systemBytes)<<" high water "<<memString(s.highWater)<<std::endl;
+    std::cout << GridLogMessage << "MemoryManager "<<names[p]<<" pool : fragmentation "<<100.0*s.fragmentation()
+	      << " % of which size class rounding "<<100.0*s.roundingLoss()<<" %"<<std::endl;
+  }
+}
+
+//////////////////////////////////////////////////////////////////////
+// Host small object arena. Free blocks are chained through their first
+// word on per-thread lists; slabs are never returned to the system.
+// Plain pointers only so that nothing is destroyed at thread exit before
+// static lattices release their memory.
+//////////////////////////////////////////////////////////////////////
+static const int NsmallClass = 8;
+static thread_local void *HostSmallFreeList[NsmallClass];
+static thread_local char *HostSlabCursor[NsmallClass];
+static thread_local char *HostSlabEnd[NsmallClass];
+
+static inline int HostSmallClass(size_t cbytes)
+{
+  int c=0;
+  while ( (size_t(GRID_ALLOC_SMALL_MIN)<<c) < cbytes ) c++;
+  return c;
+}
+#ifdef GRID_UVM
+static inline void *HostAllocSystem(size_t bytes) { return acceleratorAllocShared(bytes); }
+static inline void  HostFreeSystem (void *ptr)    { acceleratorFreeShared(ptr); }
+#else
+static inline void *HostAllocSystem(size_t bytes) { return acceleratorAllocCpu(bytes); }
+static inline void  HostFreeSystem (void *ptr)    { acceleratorFreeCpu(ptr); }
+#endif
+
+void *MemoryManager::HostSmallAllocate(size_t bytes)
+{
+  size_t cbytes = ClassBytes(bytes);
+  int c = HostSmallClass(cbytes);
+  int hit = 1;
+  void *ptr = HostSmallFreeList[c];
+  if ( ptr ) {
+    HostSmallFreeList[c] = *(void **)ptr;
+  } else {
+    if ( HostSlabCursor[c] == HostSlabEnd[c] ) {
+      HostSlabCursor[c] = (char *)HostAllocSystem(GRID_ALLOC_SMALL_SLAB);
+      assert(HostSlabCursor[c]!=NULL);
+      HostSlabEnd[c]    = HostSlabCursor[c] + GRID_ALLOC_SMALL_SLAB;
+      CountSystem(CpuSmall,GRID_ALLOC_SMALL_SLAB);
+      hit = 0;
+    }
+    ptr = (void *)HostSlabCursor[c];
+    HostSlabCursor[c] += cbytes;
+  }
+  CountAllocate(CpuSmall,bytes,cbytes,hit);
+  return ptr;
+}
+void MemoryManager::HostSmallFree(void *ptr,size_t bytes)
+{
+  size_t cbytes = ClassBytes(bytes);
+  int c = HostSmallClass(cbytes);
+  *(void **)ptr = HostSmallFreeList[c];
+  HostSmallFreeList[c] = ptr;
+  CountFree(CpuSmall,bytes,cbytes);
+}
+
 //////////////////////////////////////////////////////////////////////
 // Actual allocation and deallocation utils
 //////////////////////////////////////////////////////////////////////
@@ -50,7 +191,8 @@ void *MemoryManager::AcceleratorAllocate(size_t bytes)
   total_device+=bytes;
   void *ptr = (void *) Lookup(bytes,Acc);
   if ( ptr == (void *) NULL ) {
-    ptr = (void *) acceleratorAllocDevice(bytes);
+    ptr = (void *) acceleratorAllocDevice(ClassBytes(bytes));
+    CountSystem(Acc+(bytes<GRID_ALLOC_SMALL_LIMIT),ClassBytes(bytes));
   }
 #ifdef GRID_MM_VERBOSE
   std::cout <<"AcceleratorAllocate "<<std::endl;
@@ -75,7 +217,8 @@ void *MemoryManager::SharedAllocate(size_t bytes)
   total_shared+=bytes;
   void *ptr = (void *) Lookup(bytes,Shared);
   if ( ptr == (void *) NULL ) {
-    ptr = (void *) acceleratorAllocShared(bytes);
+    ptr = (void *) acceleratorAllocShared(ClassBytes(bytes));
+    CountSystem(Shared+(bytes<GRID_ALLOC_SMALL_LIMIT),ClassBytes(bytes));
   }
 #ifdef GRID_MM_VERBOSE
   std::cout <<"SharedAllocate "<<std::endl;
@@ -95,13 +238,21 @@ void  MemoryManager::SharedFree    (void *ptr,size_t bytes)
   PrintBytes();
 #endif
 }
-#ifdef GRID_UVM
 void *MemoryManager::CpuAllocate(size_t bytes)
 {
   total_host+=bytes;
+#ifdef ALLOCATION_CACHE
+  if ( bytes < GRID_ALLOC_SMALL_LIMIT ) return HostSmallAllocate(bytes);
+#endif
   void *ptr = (void *) Lookup(bytes,Cpu);
   if ( ptr == (void *) NULL ) {
-    ptr = (void *) acceleratorAllocShared(bytes);
+    size_t cbytes = ClassBytes(bytes);
+    ptr = (void *) HostAllocSystem(cbytes);
+    CountSystem(Cpu+(bytes<GRID_ALLOC_SMALL_LIMIT),cbytes);
+#if defined(MADV_HUGEPAGE) && !defined(GRID_UVM)
+    // Large host arenas are backed by transparent huge pages
+    if ( cbytes >= GRID_ALLOC_HUGE_LIMIT ) madvise(ptr,cbytes,MADV_HUGEPAGE);
+#endif
   }
 #ifdef GRID_MM_VERBOSE
   std::cout <<"CpuAllocate "<<std::endl;
@@ -113,43 +264,21 @@ void  MemoryManager::CpuFree    (void *_ptr,size_t bytes)
 {
   total_host-=bytes;
   NotifyDeletion(_ptr);
-  void *__freeme = Insert(_ptr,bytes,Cpu);
-  if ( __freeme ) { 
-    acceleratorFreeShared(__freeme);
-  }
-#ifdef GRID_MM_VERBOSE
-  std::cout <<"CpuFree "<<std::endl;
-  PrintBytes();
-#endif
-}
-#else
-void *MemoryManager::CpuAllocate(size_t bytes)
-{
-  total_host+=bytes;
-  void *ptr = (void *) Lookup(bytes,Cpu);
-  if ( ptr == (void *) NULL ) {
-    ptr = (void *) acceleratorAllocCpu(bytes);
+#ifdef ALLOCATION_CACHE
+  if ( bytes < GRID_ALLOC_SMALL_LIMIT ) {
+    HostSmallFree(_ptr,bytes);
+    return;
   }
-#ifdef GRID_MM_VERBOSE
-  std::cout <<"CpuAllocate "<<std::endl;
-  PrintBytes();
 #endif
-  return ptr;
-}
-void  MemoryManager::CpuFree    (void *_ptr,size_t bytes)
-{
-  total_host-=bytes;
-  NotifyDeletion(_ptr);
   void *__freeme = Insert(_ptr,bytes,Cpu);
   if ( __freeme ) { 
-    acceleratorFreeCpu(__freeme);
+    HostFreeSystem(__freeme);
   }
 #ifdef GRID_MM_VERBOSE
   std::cout <<"CpuFree "<<std::endl;
   PrintBytes();
 #endif
 }
-#endif
 
 //////////////////////////////////////////
 // call only once
@@ -190,7 +319,8 @@ void MemoryManager::InitMessage(void) {
   
   std::cout << GridLogMessage<< "MemoryManager::Init() setting up"<<std::endl;
 #ifdef ALLOCATION_CACHE
-  std::cout << GridLogMessage<< "MemoryManager::Init() cache pool for recent allocations: SMALL "<<Ncache[CpuSmall]<<" LARGE "<<Ncache[Cpu]<<std::endl;
+  std::cout << GridLogMessage<< "MemoryManager::Init() cache pool for recent allocations: SMALL "<<Ncache[CpuSmall]<<" LARGE "<<Ncache[Cpu]<<" entries"<<std::endl;
+  std::cout << GridLogMessage<< "MemoryManager::Init() host objects below "<<GRID_ALLOC_SMALL_LIMIT<<" bytes from per-thread slabs"<<std::endl;
 #endif
   
 #ifdef GRID_UVM
@@ -221,11 +351,31 @@ void MemoryManager::InitMessage(void) {
 
 void *MemoryManager::Insert(void *ptr,size_t bytes,int type) 
 {
-#ifdef ALLOCATION_CACHE
   bool small = (bytes < GRID_ALLOC_SMALL_LIMIT);
   int cache = type + small;
-  return Insert(ptr,bytes,Entries[cache],Ncache[cache],Victim[cache],CacheBytes[cache]);  
+  size_t cbytes = ClassBytes(bytes);
+  CountFree(cache,bytes,cbytes);
+#ifdef ALLOCATION_CACHE
+  int sc = SizeClass(cbytes);
+  std::lock_guard<std::mutex> lock(CacheMutex);
+  if ( Ncache[cache]==0 ) {
+    CountSystem(cache,-(int64_t)cbytes);
+    return ptr;
+  }
+  uint64_t before = CacheBytes[cache];
+  // The type is full: make room by dropping its oldest entry, of any class.
+  // A class then never holds Ncache entries, so the class insert evicts nothing.
+  void *ret = NULL;
+  if ( Nentries[cache] >= Ncache[cache] ) ret = EvictOldest(cache);
+  void *evicted = Insert(ptr,cbytes,Entries[cache][sc],Ncache[cache],Victim[cache][sc],CacheBytes[cache]);
+  assert(evicted==NULL);
+  Nentries[cache]++;
+  ClassEntries[cache][sc]++;
+  // An evicted block may be of a different size
+  if ( ret ) CountSystem(cache,-(int64_t)(before+cbytes-CacheBytes[cache]));
+  return ret;
 #else
+  CountSystem(cache,-(int64_t)cbytes);
   return ptr;
 #endif
 }
@@ -233,9 +383,6 @@ void *MemoryManager::Insert(void *ptr,size_t bytes,int type)
 void *MemoryManager::Insert(void *ptr,size_t bytes,AllocationCacheEntry *entries,int ncache,int &victim, uint64_t &cacheBytes) 
 {
   assert(ncache>0);
-#ifdef GRID_OMP
-  assert(omp_in_parallel()==0);
-#endif 
 
   void * ret = NULL;
   int v = -1;
@@ -263,6 +410,7 @@ void *MemoryManager::Insert(void *ptr,size_t bytes,AllocationCacheEntry *entries
   entries[v].address=ptr;
   entries[v].bytes  =bytes;
   entries[v].valid  =1;
+  entries[v].stamp  =++CacheStamp;
   cacheBytes += bytes;
 
   return ret;
@@ -270,21 +418,54 @@ void *MemoryManager::Insert(void *ptr,size_t bytes,AllocationCacheEntry *entries
 
 void *MemoryManager::Lookup(size_t bytes,int type)
 {
-#ifdef ALLOCATION_CACHE
   bool small = (bytes < GRID_ALLOC_SMALL_LIMIT);
   int cache = type+small;
-  return Lookup(bytes,Entries[cache],Ncache[cache],CacheBytes[cache]);
+  size_t cbytes = ClassBytes(bytes);
+#ifdef ALLOCATION_CACHE
+  int sc = SizeClass(cbytes);
+  void *ret;
+  {
+    std::lock_guard<std::mutex> lock(CacheMutex);
+    ret = Lookup(cbytes,Entries[cache][sc],Ncache[cache],CacheBytes[cache]);
+    if ( ret ) {
+      Nentries[cache]--;
+      ClassEntries[cache][sc]--;
+    }
+  }
+  CountAllocate(cache,bytes,cbytes,ret!=NULL);
+  return ret;
 #else
+  CountAllocate(cache,bytes,cbytes,0);
   return NULL;
 #endif
 }
 
+// Remove the least recently inserted entry of a type; CacheMutex held
+void *MemoryManager::EvictOldest(int cache)
+{
+  int osc=-1, oe=-1;
+  for(int sc=0;sc<NsizeClass;sc++){
+    if ( ClassEntries[cache][sc]==0 ) continue;
+    for(int e=0;e<Ncache[cache];e++){
+      AllocationCacheEntry &entry = Entries[cache][sc][e];
+      if ( entry.valid && ( (osc<0) || (entry.stamp < Entries[cache][osc][oe].stamp) ) ) { osc=sc; oe=e; }
+    }
+  }
+  assert(osc>=0);
+  AllocationCacheEntry &entry = Entries[cache][osc][oe];
+  void *ret = entry.address;
+  CacheBytes[cache] -= entry.bytes;
+  entry.valid   = 0;
+  entry.address = NULL;
+  entry.bytes   = 0;
+  Nentries[cache]--;
+  ClassEntries[cache][osc]--;
+  return ret;
+}
+
 void *MemoryManager::Lookup(size_t bytes,AllocationCacheEntry *entries,int ncache,uint64_t & cacheBytes) 
 {
   assert(ncache>0);
-#ifdef GRID_OMP
-  assert(omp_in_parallel()==0);
-#endif 
   for(int e=0;e<ncache;e++){
     if ( entries[e].valid && ( entries[e].bytes == bytes ) ) {
       entries[e].valid = 0;
@@ -29,12 +29,18 @@ Author: Peter Boyle <paboyle@ph.ed.ac.uk>
 #pragma once
 #include <list> 
 #include <unordered_map>  
+#include <mutex>
+#include <atomic>
 
 NAMESPACE_BEGIN(Grid);
 
 // Move control to configure.ac and Config.h?
 
 #define GRID_ALLOC_SMALL_LIMIT (4096)
+#define GRID_ALLOC_SMALL_MIN   (64)
+#define GRID_ALLOC_SMALL_SLAB  (64*1024)
+#define GRID_ALLOC_HUGE_PAGE   (2*1024*1024)
+#define GRID_ALLOC_HUGE_LIMIT  (32*1024*1024)
 
 /*Pinning pages is costly*/
 ////////////////////////////////////////////////////////////////////////////
@@ -69,20 +75,51 @@ class MemoryManager {
 private:
 
   ////////////////////////////////////////////////////////////
-  // For caching recently freed allocations
+  // Size class pools for recently freed allocations.
+  //
+  // Requests below GRID_ALLOC_SMALL_LIMIT are rounded up to a power of two.
+  // Host small objects are carved from slabs and recycled through per-thread
+  // free lists, so helper threads may allocate without taking a lock.
+  // Larger requests are rounded up to whole pages (whole huge pages above
+  // GRID_ALLOC_HUGE_LIMIT) so a field of given grid and type always lands
+  // in the same class; classes are binned per quarter octave.
+  // Ncache bounds the entries of a type over all its classes; when
+  // full the oldest entry of the type is evicted.
   ////////////////////////////////////////////////////////////
   typedef struct { 
     void *address;
     size_t bytes;
     int valid;
+    uint64_t stamp;
   } AllocationCacheEntry;
 
   static const int NallocCacheMax=128; 
   static const int NallocType=6;
-  static AllocationCacheEntry Entries[NallocType][NallocCacheMax];
-  static int Victim[NallocType];
+  static const int NsizeClass=256;
+  static AllocationCacheEntry Entries[NallocType][NsizeClass][NallocCacheMax];
+  static int Victim[NallocType][NsizeClass];
   static int Ncache[NallocType];
+  static int Nentries[NallocType];
+  static int ClassEntries[NallocType][NsizeClass];
+  static uint64_t CacheStamp;
   static uint64_t CacheBytes[NallocType];
+  static std::mutex CacheMutex;
+
+  struct PoolCounters {
+    std::atomic<uint64_t> requests;
+    std::atomic<uint64_t> hits;
+    std::atomic<uint64_t> requestedBytes;
+    std::atomic<uint64_t> reservedBytes;
+    std::atomic<uint64_t> systemBytes;
+    std::atomic<uint64_t> highWater;
+  };
+  static PoolCounters Counters[NallocType];
+
+  static size_t ClassBytes(size_t bytes);
+  static int    SizeClass(size_t bytes);
+  static void   CountAllocate(int cache,size_t bytes,size_t cbytes,int hit);
+  static void   CountFree(int cache,size_t bytes,size_t cbytes);
+  static void   CountSystem(int cache,int64_t bytes);
 
   /////////////////////////////////////////////////
   // Free pool
@@ -91,6 +128,9 @@ private:
   static void *Lookup(size_t bytes,int type) ;
   static void *Insert(void *ptr,size_t bytes,AllocationCacheEntry *entries,int ncache,int &victim,uint64_t &cbytes) ;
   static void *Lookup(size_t bytes,AllocationCacheEntry *entries,int ncache,uint64_t &cbytes) ;
+  static void *EvictOldest(int cache);
+  static void *HostSmallAllocate(size_t bytes);
+  static void  HostSmallFree(void *ptr,size_t bytes);
 
   static void PrintBytes(void);
  public:
@@ -103,6 +143,13 @@ private:
   static void *CpuAllocate(size_t bytes);
   static void  CpuFree    (void *ptr,size_t bytes);
 
+  ////////////////////////////////////////////////////////
+  // Pool statistics; pool is one of PoolCpu, PoolAcc, PoolShared
+  ////////////////////////////////////////////////////////
+  enum { PoolCpu=0, PoolAcc=2, PoolShared=4 };
+  static MemoryPoolStats PoolStatistics(int pool);
+  static void PrintPoolStatistics(void);
+
   ////////////////////////////////////////////////////////
   // Footprint tracking
   ////////////////////////////////////////////////////////
@@ -38,6 +38,29 @@ struct MemoryStats
   size_t totalAllocated{0}, maxAllocated{0}, 
     currentlyAllocated{0}, totalFreed{0};
 };
+
+////////////////////////////////////////////////////////////////////////////
+// Size class pool accounting kept by the MemoryManager.
+//   requested : live bytes as asked for by callers
+//   reserved  : live bytes after rounding up to the size class
+//   system    : bytes currently obtained from the system (live + cached + slabs)
+//   highWater : peak of system
+////////////////////////////////////////////////////////////////////////////
+struct MemoryPoolStats
+{
+  uint64_t requests{0}, hits{0};
+  uint64_t requestedBytes{0}, reservedBytes{0}, systemBytes{0}, highWater{0};
+
+  double hitRate(void) const { return requests ? (double)hits/(double)requests : 0.0; };
+  // Fraction of memory held from the system that is not holding live data
+  double fragmentation(void) const {
+    return systemBytes ? 1.0-(double)requestedBytes/(double)systemBytes : 0.0;
+  };
+  // Part of the above that is lost to size class rounding
+  double roundingLoss(void) const {
+    return systemBytes ? (double)(reservedBytes-requestedBytes)/(double)systemBytes : 0.0;
+  };
+};
     
 class MemoryProfiler
 {
@@ -32,6 +32,10 @@
 
 NAMESPACE_BEGIN(Grid);
 
+// Apply a GridBase site layout table (LexToSiteTable/SiteToLexTable)
+// inside accelerator loops; a null table is the identity
+accelerator_inline int oLayoutMap(const int *table,int idx) { return table ? table[idx] : idx; }
+
 //////////////////////////////////////////////////////////////////////
 // Commicator provides information on the processor grid
 //////////////////////////////////////////////////////////////////////
@@ -47,16 +51,16 @@ public:
   // Give Lattice access
   template<class object> friend class Lattice;
 
-  GridBase(const Coordinate & processor_grid) : CartesianCommunicator(processor_grid) { LocallyPeriodic=0;}; 
+  GridBase(const Coordinate & processor_grid) : CartesianCommunicator(processor_grid) { LocallyPeriodic=0; LexicographicLayout();}; 
 
   GridBase(const Coordinate & processor_grid,
 	   const CartesianCommunicator &parent,
 	   int &split_rank) 
-    : CartesianCommunicator(processor_grid,parent,split_rank) {LocallyPeriodic=0;};
+    : CartesianCommunicator(processor_grid,parent,split_rank) {LocallyPeriodic=0; LexicographicLayout();};
 
   GridBase(const Coordinate & processor_grid,
 	   const CartesianCommunicator &parent) 
-    : CartesianCommunicator(processor_grid,parent,dummy) {LocallyPeriodic=0;};
+    : CartesianCommunicator(processor_grid,parent,dummy) {LocallyPeriodic=0; LexicographicLayout();};
 
   virtual ~GridBase() = default;
 
@@ -83,6 +87,23 @@ public:
   int        LocallyPeriodic;
   Coordinate _checker_dim_mask;
 
+  ////////////////////////////////////////////////////////////////
+  // Outer site memory layout. By default the storage index of an
+  // outer site is its lexicographic index. A grid may instead store
+  // outer sites in blocked Morton or Hilbert curve order: tiles of
+  // block^nd sites are laid out along the curve, lexicographic within
+  // a tile, so that stencil neighbours stay close in memory for large
+  // local volumes. The first _site_layout_inner dimensions are kept
+  // innermost and lexicographic (the s direction of a 5d grid).
+  // _lex2site/_site2lex are empty for lexicographic grids.
+  ////////////////////////////////////////////////////////////////
+  enum SiteLayout_t { SiteLayoutLexicographic, SiteLayoutMorton, SiteLayoutHilbert };
+  int _site_layout;
+  int _site_layout_block;
+  int _site_layout_inner;
+  Vector<int> _lex2site;
+  Vector<int> _site2lex;
+
 public:
 
   ////////////////////////////////////////////////////////////////
@@ -114,7 +135,7 @@ public:
     int idx=0;
     // Works with either global or local coordinates
     for(int d=0;d<_ndimension;d++) idx+=_ostride[d]*(coor[d]%_rdimensions[d]);
-    return idx;
+    return oIndexFromLex(idx);
   }
   virtual int iIndex(Coordinate &lcoor)
   {
@@ -128,12 +149,146 @@ public:
     // ocoor is already reduced so can eliminate the modulo operation
     // for fast indexing and inline the routine
     for(int d=0;d<_ndimension;d++) idx+=_ostride[d]*ocoor[d];
-    return idx;
+    return oIndexFromLex(idx);
   }
   inline void oCoorFromOindex (Coordinate& coor,int Oindex){
-    Lexicographic::CoorFromIndex(coor,Oindex,_rdimensions);
+    Lexicographic::CoorFromIndex(coor,oLexFromIndex(Oindex),_rdimensions);
   }
 
+  //////////////////////////////////////////////////////////
+  // Outer site layout. Stride arithmetic (_ostride,
+  // _slice_stride etc.) yields lexicographic indices; these
+  // map them to and from storage indices. The raw tables are
+  // for accelerator loops and are null when lexicographic.
+  //////////////////////////////////////////////////////////
+  inline int oIndexFromLex(int lex)  const { return _lex2site.size() ? _lex2site[lex]  : lex;  }
+  inline int oLexFromIndex(int site) const { return _site2lex.size() ? _site2lex[site] : site; }
+  inline int *LexToSiteTable(void) { return _lex2site.size() ? &_lex2site[0] : nullptr; }
+  inline int *SiteToLexTable(void) { return _site2lex.size() ? &_site2lex[0] : nullptr; }
+  inline int  SiteLayout(void) const { return _site_layout; }
+  inline int  SiteLayoutBlock(void) const { return _site_layout_block; }
+
+  void LexicographicLayout(void)
+  {
+    _site_layout       = SiteLayoutLexicographic;
+    _site_layout_block = 1;
+    _site_layout_inner = 0;
+    _lex2site.resize(0);
+    _site2lex.resize(0);
+  }
+
+  // Must be called before any field or stencil is built on the grid.
+  // Checkerboarded grids are always lexicographic.
+  void SetSiteLayout(int layout,int block=2,int inner=0)
+  {
+    LexicographicLayout();
+    if ( layout == SiteLayoutLexicographic ) return;
+
+    assert(!_isCheckerBoarded);
+    assert(block>=1);
+    assert((inner>=0)&&(inner<_ndimension));
+    assert((layout==SiteLayoutMorton)||(layout==SiteLayoutHilbert));
+
+    int nc = _ndimension-inner;  // dimensions ordered along the curve
+    Coordinate tile(nc);
+    int bits=0;
+    int tvol=1;
+    int ivol=1;
+    for(int d=0;d<inner;d++) ivol*=_rdimensions[d];
+    for(int d=0;d<nc;d++){
+      tile[d] = std::min(block,_rdimensions[inner+d]);
+      int ntile = (_rdimensions[inner+d]+tile[d]-1)/tile[d];
+      while ( (1<<bits) < ntile ) bits++;
+      tvol*=tile[d];
+    }
+    assert(bits*nc <= 64);
+
+    std::vector<uint64_t> curve(_osites);
+    std::vector<uint64_t> local(_osites);
+    std::vector<int>      order(_osites);
+    std::vector<uint64_t> t(nc);
+    Coordinate coor;
+    for(int lex=0;lex<_osites;lex++){
+      Lexicographic::CoorFromIndex(coor,lex,_rdimensions);
+      uint64_t w=0;
+      for(int d=nc-1;d>=0;d--){
+	t[d] = coor[inner+d]/tile[d];
+	w    = w*tile[d] + coor[inner+d]%tile[d];
+      }
+      uint64_t i=0;
+      for(int d=inner-1;d>=0;d--) i = i*_rdimensions[d]+coor[d];
+      curve[lex] = (layout==SiteLayoutMorton) ? MortonKey(t,bits) : HilbertKey(t,bits);
+      local[lex] = w*ivol+i;
+      order[lex] = lex;
+    }
+    std::sort(order.begin(),order.end(),[&](int a,int b){
+	return (curve[a]<curve[b]) || ( (curve[a]==curve[b]) && (local[a]<local[b]) );
+      });
+
+    _site_layout       = layout;
+    _site_layout_block = block;
+    _site_layout_inner = inner;
+    _lex2site.resize(_osites);
+    _site2lex.resize(_osites);
+    for(int site=0;site<_osites;site++){
+      _site2lex[site]        = order[site];
+      _lex2site[order[site]] = site;
+    }
+  }
+  // Same layout as another grid, with any extra leading dimensions of
+  // this grid innermost; e.g. a 5d grid following its 4d gauge grid
+  void InheritSiteLayout(const GridBase *base)
+  {
+    int inner = _ndimension-base->_ndimension;
+    assert(inner>=0);
+    for(int d=0;d<base->_ndimension;d++) assert(_rdimensions[inner+d]==base->_rdimensions[d]);
+    SetSiteLayout(base->_site_layout,base->_site_layout_block,inner);
+  }
+private:
+  static uint64_t MortonKey(const std::vector<uint64_t> &x,int bits)
+  {
+    uint64_t key=0;
+    int n=x.size();
+    for(int b=0;b<bits;b++){
+      for(int d=0;d<n;d++){
+	key |= ((x[d]>>b)&0x1) << (b*n+d);
+      }
+    }
+    return key;
+  }
+  // Skilling, "Programming the Hilbert curve", AIP Conf. Proc. 707 (2004)
+  static uint64_t HilbertKey(std::vector<uint64_t> x,int bits)
+  {
+    if ( bits==0 ) return 0;
+    int n=x.size();
+    uint64_t M = 1ULL<<(bits-1);
+    for(uint64_t Q=M;Q>1;Q>>=1){
+      uint64_t P=Q-1;
+      for(int i=0;i<n;i++){
+	if ( x[i] & Q ) x[0] ^= P;
+	else {
+	  uint64_t t = (x[0]^x[i]) & P;
+	  x[0] ^= t;
+	  x[i] ^= t;
+	}
+      }
+    }
+    for(int i=1;i<n;i++) x[i] ^= x[i-1];
+    uint64_t t=0;
+    for(uint64_t Q=M;Q>1;Q>>=1){
+      if ( x[n-1] & Q ) t ^= Q-1;
+    }
+    for(int i=0;i<n;i++) x[i] ^= t;
+    uint64_t key=0;
+    for(int b=bits-1;b>=0;b--){
+      for(int i=0;i<n;i++){
+	key = (key<<1) | ((x[i]>>b)&0x1);
+      }
+    }
+    return key;
+  }
+public:
+
   inline void InOutCoorToLocalCoor (Coordinate &ocoor, Coordinate &icoor, Coordinate &lcoor) {
     lcoor.resize(_ndimension);
     for (int d = 0; d < _ndimension; d++)
@@ -209,6 +364,10 @@ public:
     std::cout << GridLogMessage << "\tlSites             : " << lSites() << std::endl;        
     std::cout << GridLogMessage << "\tgSites             : " << gSites() << std::endl;
     std::cout << GridLogMessage << "\tNd                 : " << _ndimension << std::endl;             
+    if ( _site_layout != SiteLayoutLexicographic ) {
+    std::cout << GridLogMessage << "\tSite layout        : " << ((_site_layout==SiteLayoutMorton) ? "Morton" : "Hilbert")
+	      << " block " << _site_layout_block << std::endl;
+    }
   } 
 
   ////////////////////////////////////////////////////////////////
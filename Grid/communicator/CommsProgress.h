@@ -0,0 +1,145 @@
+/*************************************************************************************
+
+    Grid physics library, www.github.com/paboyle/Grid
+
+    Source file: ./lib/communicator/CommsProgress.h
+
+    Copyright (C) 2015
+
+Author: Peter Boyle <paboyle@ph.ed.ac.uk>
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License along
+    with this program; if not, write to the Free Software Foundation, Inc.,
+    51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+
+    See the full license in the file "LICENSE" in the top level distribution directory
+*************************************************************************************/
+/*  END LEGAL */
+#ifndef GRID_COMMS_PROGRESS_H
+#define GRID_COMMS_PROGRESS_H
+
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <functional>
+#include <atomic>
+#ifdef __linux__
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+NAMESPACE_BEGIN(Grid);
+
+//////////////////////////////////////////////////////////////////////////////
+// One helper thread per rank that drives communication while the OpenMP
+// threads compute. Work is handed over with Launch and collected with Wait;
+// only one item is in flight at a time. The thread is pinned to the last
+// core of the process affinity mask, spins briefly for new work and then
+// sleeps so that it does not compete with compute between halo exchanges.
+//
+// MPI is initialised with MPI_THREAD_SERIALIZED; the caller must not enter
+// MPI between Launch and Wait.
+//////////////////////////////////////////////////////////////////////////////
+class CommsProgressThread {
+public:
+  static CommsProgressThread & Instance(void) {
+    static CommsProgressThread engine;
+    return engine;
+  }
+
+  void Launch(std::function<void(void)> work)
+  {
+    assert(done.load(std::memory_order_acquire));
+    {
+      std::lock_guard<std::mutex> lock(mtx);
+      task = work;
+      done.store(0,std::memory_order_relaxed);
+      pending.store(1,std::memory_order_release);
+    }
+    cv.notify_one();
+  }
+
+  void Wait(void)
+  {
+    while( !done.load(std::memory_order_acquire) ) {
+      std::this_thread::yield();
+    }
+  }
+
+  int Core(void) { return core; }
+
+  ~CommsProgressThread()
+  {
+    {
+      std::lock_guard<std::mutex> lock(mtx);
+      stop = 1;
+    }
+    cv.notify_one();
+    worker.join();
+  }
+
+private:
+  std::thread worker;
+  std::mutex mtx;
+  std::condition_variable cv;
+  std::function<void(void)> task;
+  std::atomic<int> pending;
+  std::atomic<int> done;
+  int stop;
+  int core;
+
+  static const int spin_count = 1<<16;
+
+  CommsProgressThread() : pending(0), done(1), stop(0), core(-1)
+  {
+    worker = std::thread([this](){ this->Loop(); });
+    Pin();
+  }
+
+  void Pin(void)
+  {
+#ifdef __linux__
+    cpu_set_t mask;
+    CPU_ZERO(&mask);
+    if ( sched_getaffinity(0,sizeof(mask),&mask) ) return;
+    if ( CPU_COUNT(&mask) < 2 ) return;
+    for(int c=CPU_SETSIZE-1;c>=0;c--){
+      if ( CPU_ISSET(c,&mask) ) { core = c; break; }
+    }
+    cpu_set_t mine;
+    CPU_ZERO(&mine);
+    CPU_SET(core,&mine);
+    pthread_setaffinity_np(worker.native_handle(),sizeof(mine),&mine);
+#endif
+  }
+
+  void Loop(void)
+  {
+    while(1) {
+      int spin=0;
+      while( !pending.load(std::memory_order_acquire) && (spin<spin_count) ) spin++;
+      if ( !pending.load(std::memory_order_acquire) ) {
+	std::unique_lock<std::mutex> lock(mtx);
+	cv.wait(lock,[this]{ return pending.load(std::memory_order_acquire) || stop; });
+	if ( stop && !pending.load(std::memory_order_acquire) ) return;
+      }
+      pending.store(0,std::memory_order_relaxed);
+      task();
+      done.store(1,std::memory_order_release);
+    }
+  }
+};
+
+NAMESPACE_END(Grid);
+
+#endif
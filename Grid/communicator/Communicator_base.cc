@@ -41,6 +41,7 @@ bool Stencil_force_mpi = true;
 CartesianCommunicator::CommunicatorPolicy_t  
 CartesianCommunicator::CommunicatorPolicy= CartesianCommunicator::CommunicatorPolicyConcurrent;
 int CartesianCommunicator::nCommThreads = -1;
+int CartesianCommunicator::UseProgressThread = 0;
 
 /////////////////////////////////
 // Grid information queries
@@ -73,6 +74,14 @@ void CartesianCommunicator::GlobalSumVector(ComplexD *c,int N)
 {
   GlobalSumVector((double *)c,2*N);
 }
+void CartesianCommunicator::GlobalSumVectorBegin(ComplexF *c,int N,CommsRequest_t &req)
+{
+  GlobalSumVectorBegin((float *)c,2*N,req);
+}
+void CartesianCommunicator::GlobalSumVectorBegin(ComplexD *c,int N,CommsRequest_t &req)
+{
+  GlobalSumVectorBegin((double *)c,2*N,req);
+}
   
 NAMESPACE_END(Grid);
 
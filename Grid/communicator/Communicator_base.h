@@ -44,10 +44,11 @@ public:
   ////////////////////////////////////////////
   // Policies
   ////////////////////////////////////////////
-  enum CommunicatorPolicy_t { CommunicatorPolicyConcurrent, CommunicatorPolicySequential };
+  enum CommunicatorPolicy_t { CommunicatorPolicyConcurrent, CommunicatorPolicySequential, CommunicatorPolicyPersistent };
   static CommunicatorPolicy_t CommunicatorPolicy;
   static void SetCommunicatorPolicy(CommunicatorPolicy_t policy ) { CommunicatorPolicy = policy; }
   static int       nCommThreads;
+  static int       UseProgressThread;
 
   ////////////////////////////////////////////
   // Communicator should know nothing of the physics grid, only processor grid.
@@ -65,6 +66,9 @@ public:
   // Must call in Grid startup
   ////////////////////////////////////////////////
   static void Init(int *argc, char ***argv);
+  // MPI may be entered from a thread other than the main one (one at a time);
+  // required by the comms progress thread
+  static int  ThreadSerialized(void);
 
   ////////////////////////////////////////////////
   // Constructors to sub-divide a parent communicator
@@ -131,7 +135,19 @@ public:
     scalar_type * ptr = (scalar_type *)& o;
     GlobalSumVector(ptr,words);
   }
-  
+
+  ////////////////////////////////////////////////////////////
+  // Non-blocking reduction, in place. The buffer must not be
+  // touched until GlobalSumTest returns true or GlobalSumWait
+  // returns.
+  ////////////////////////////////////////////////////////////
+  void GlobalSumVectorBegin(RealF *,int N,CommsRequest_t &req);
+  void GlobalSumVectorBegin(RealD *,int N,CommsRequest_t &req);
+  void GlobalSumVectorBegin(ComplexF *c,int N,CommsRequest_t &req);
+  void GlobalSumVectorBegin(ComplexD *c,int N,CommsRequest_t &req);
+  int  GlobalSumTest(CommsRequest_t &req);
+  void GlobalSumWait(CommsRequest_t &req);
+
   ////////////////////////////////////////////////////////////
   // Face exchange, buffer swap in translational invariant way
   ////////////////////////////////////////////////////////////
@@ -156,8 +172,34 @@ public:
   
   
   void StencilSendToRecvFromComplete(std::vector<CommsRequest_t> &waitall,int i);
+  // Non-blocking check for completion; drives MPI progress. Works for both
+  // ordinary and persistent requests and leaves the list for Complete.
+  int  StencilSendToRecvFromTest(std::vector<CommsRequest_t> &list);
   void StencilBarrier(void);
 
+  ////////////////////////////////////////////////////////////
+  // Persistent halo exchange. Requests are created once with
+  // Init, restarted by Begin on every exchange (which also
+  // performs any intra-node copy), waited on by Complete and
+  // released by Free.
+  ////////////////////////////////////////////////////////////
+  double StencilSendToRecvFromPersistentInit(std::vector<CommsRequest_t> &list,
+					     void *xmit,
+					     int xmit_to_rank,
+					     void *recv,
+					     int recv_from_rank,
+					     int bytes,int dir);
+
+  double StencilSendToRecvFromPersistentBegin(std::vector<CommsRequest_t> &list,
+					      void *xmit,
+					      int xmit_to_rank,
+					      void *recv,
+					      int recv_from_rank,
+					      int bytes,int dir);
+
+  void StencilSendToRecvFromPersistentComplete(std::vector<CommsRequest_t> &list,int i);
+  void StencilSendToRecvFromPersistentFree(std::vector<CommsRequest_t> &list);
+
   ////////////////////////////////////////////////////////////
   // Barrier
   ////////////////////////////////////////////////////////////
@@ -74,6 +74,13 @@ void CartesianCommunicator::Init(int *argc, char ***argv)
   Grid_unquiesce_nodes();
 }
 
+int CartesianCommunicator::ThreadSerialized(void)
+{
+  int provided;
+  MPI_Query_thread(&provided);
+  return provided >= MPI_THREAD_SERIALIZED;
+}
+
 ///////////////////////////////////////////////////////////////////////////
 // Use cartesian communicators now even in MPI3
 ///////////////////////////////////////////////////////////////////////////
@@ -304,6 +311,28 @@ void CartesianCommunicator::GlobalSumVector(double *d,int N)
   int ierr = MPI_Allreduce(MPI_IN_PLACE,d,N,MPI_DOUBLE,MPI_SUM,communicator);
   assert(ierr==0);
 }
+void CartesianCommunicator::GlobalSumVectorBegin(float *f,int N,CommsRequest_t &req)
+{
+  int ierr=MPI_Iallreduce(MPI_IN_PLACE,f,N,MPI_FLOAT,MPI_SUM,communicator,&req);
+  assert(ierr==0);
+}
+void CartesianCommunicator::GlobalSumVectorBegin(double *d,int N,CommsRequest_t &req)
+{
+  int ierr=MPI_Iallreduce(MPI_IN_PLACE,d,N,MPI_DOUBLE,MPI_SUM,communicator,&req);
+  assert(ierr==0);
+}
+int CartesianCommunicator::GlobalSumTest(CommsRequest_t &req)
+{
+  int flag;
+  int ierr=MPI_Test(&req,&flag,MPI_STATUS_IGNORE);
+  assert(ierr==0);
+  return flag;
+}
+void CartesianCommunicator::GlobalSumWait(CommsRequest_t &req)
+{
+  int ierr=MPI_Wait(&req,MPI_STATUS_IGNORE);
+  assert(ierr==0);
+}
 // Basic Halo comms primitive
 void CartesianCommunicator::SendToRecvFrom(void *xmit,
 					   int dest,
@@ -412,6 +441,115 @@ void CartesianCommunicator::StencilSendToRecvFromComplete(std::vector<CommsReque
   assert(ierr==0);
   list.resize(0);
 }
+int CartesianCommunicator::StencilSendToRecvFromTest(std::vector<CommsRequest_t> &list)
+{
+  int nreq=list.size();
+
+  if (nreq==0) return 1;
+
+  // Completed requests become MPI_REQUEST_NULL, or inactive if persistent,
+  // so a subsequent Complete returns immediately
+  int flag;
+  int ierr = MPI_Testall(nreq,&list[0],&flag,MPI_STATUSES_IGNORE);
+  assert(ierr==0);
+  return flag;
+}
+double CartesianCommunicator::StencilSendToRecvFromPersistentInit(std::vector<CommsRequest_t> &list,
+								  void *xmit,
+								  int dest,
+								  void *recv,
+								  int from,
+								  int bytes,int dir)
+{
+  int ncomm  =communicator_halo.size();
+  int commdir=dir%ncomm;
+
+  MPI_Request xrq;
+  MPI_Request rrq;
+
+  int ierr;
+  int gdest = ShmRanks[dest];
+  int gfrom = ShmRanks[from];
+  int gme   = ShmRanks[_processor];
+
+  assert(dest != _processor);
+  assert(from != _processor);
+  assert(gme  == ShmRank);
+  assert(list.size()==0);
+  double off_node_bytes=0.0;
+  int tag;
+
+  if ( (gfrom ==MPI_UNDEFINED) || Stencil_force_mpi ) {
+    tag= dir+from*32;
+    ierr=MPI_Recv_init(recv, bytes, MPI_CHAR,from,tag,communicator_halo[commdir],&rrq);
+    assert(ierr==0);
+    list.push_back(rrq);
+    off_node_bytes+=bytes;
+  }
+
+  if ( (gdest == MPI_UNDEFINED) || Stencil_force_mpi ) {
+    tag= dir+_processor*32;
+    ierr=MPI_Send_init(xmit, bytes, MPI_CHAR,dest,tag,communicator_halo[commdir],&xrq);
+    assert(ierr==0);
+    list.push_back(xrq);
+    off_node_bytes+=bytes;
+  }
+  return off_node_bytes;
+}
+double CartesianCommunicator::StencilSendToRecvFromPersistentBegin(std::vector<CommsRequest_t> &list,
+								   void *xmit,
+								   int dest,
+								   void *recv,
+								   int from,
+								   int bytes,int dir)
+{
+  int gdest = ShmRanks[dest];
+  int gfrom = ShmRanks[from];
+  double off_node_bytes=0.0;
+
+  if ( list.size() ) {
+    int ierr = MPI_Startall(list.size(),&list[0]);
+    assert(ierr==0);
+  }
+
+  if ( (gfrom ==MPI_UNDEFINED) || Stencil_force_mpi ) off_node_bytes+=bytes;
+
+  if ( (gdest == MPI_UNDEFINED) || Stencil_force_mpi ) {
+    off_node_bytes+=bytes;
+  } else {
+    void *shm = (void *) this->ShmBufferTranslate(dest,recv);
+    assert(shm!=NULL);
+    acceleratorCopyDeviceToDeviceAsynch(xmit,shm,bytes);
+  }
+  return off_node_bytes;
+}
+void CartesianCommunicator::StencilSendToRecvFromPersistentComplete(std::vector<CommsRequest_t> &list,int dir)
+{
+  acceleratorCopySynchronise();
+
+  int nreq=list.size();
+
+  if (nreq==0) return;
+
+  // Persistent requests become inactive, not freed, on completion
+  int ierr = MPI_Waitall(nreq,&list[0],MPI_STATUSES_IGNORE);
+  assert(ierr==0);
+}
+void CartesianCommunicator::StencilSendToRecvFromPersistentFree(std::vector<CommsRequest_t> &list)
+{
+  // Stencils may outlive Grid_finalize when declared in main
+  int finalised;
+  MPI_Finalized(&finalised);
+  if ( finalised ) {
+    list.resize(0);
+    return;
+  }
+  for(int i=0;i<list.size();i++){
+    int ierr = MPI_Request_free(&list[i]);
+    assert(ierr==0);
+  }
+  list.resize(0);
+}
 void CartesianCommunicator::StencilBarrier(void)
 {
   MPI_Barrier  (ShmComm);
@@ -42,6 +42,8 @@ void CartesianCommunicator::Init(int *argc, char *** arv)
 					   GlobalSharedMemory::Hugepages);
 }
 
+int CartesianCommunicator::ThreadSerialized(void) { return 1; }
+
 CartesianCommunicator::CartesianCommunicator(const Coordinate &processors,const CartesianCommunicator &parent,int &srank) 
   : CartesianCommunicator(processors) 
 {
@@ -78,6 +80,10 @@ void CartesianCommunicator::GlobalSum(uint64_t &){}
 void CartesianCommunicator::GlobalSumVector(uint64_t *,int N){}
 void CartesianCommunicator::GlobalXOR(uint32_t &){}
 void CartesianCommunicator::GlobalXOR(uint64_t &){}
+void CartesianCommunicator::GlobalSumVectorBegin(float *,int N,CommsRequest_t &req){}
+void CartesianCommunicator::GlobalSumVectorBegin(double *,int N,CommsRequest_t &req){}
+int  CartesianCommunicator::GlobalSumTest(CommsRequest_t &req){ return 1; }
+void CartesianCommunicator::GlobalSumWait(CommsRequest_t &req){}
 
 
 // Basic Halo comms primitive -- should never call in single node
@@ -130,6 +136,35 @@ double CartesianCommunicator::StencilSendToRecvFromBegin(std::vector<CommsReques
 void CartesianCommunicator::StencilSendToRecvFromComplete(std::vector<CommsRequest_t> &waitall,int dir)
 {
 }
+int CartesianCommunicator::StencilSendToRecvFromTest(std::vector<CommsRequest_t> &list)
+{
+  return 1;
+}
+
+double CartesianCommunicator::StencilSendToRecvFromPersistentInit(std::vector<CommsRequest_t> &list,
+								  void *xmit,
+								  int xmit_to_rank,
+								  void *recv,
+								  int recv_from_rank,
+								  int bytes, int dir)
+{
+  return 2.0*bytes;
+}
+double CartesianCommunicator::StencilSendToRecvFromPersistentBegin(std::vector<CommsRequest_t> &list,
+								   void *xmit,
+								   int xmit_to_rank,
+								   void *recv,
+								   int recv_from_rank,
+								   int bytes, int dir)
+{
+  return 2.0*bytes;
+}
+void CartesianCommunicator::StencilSendToRecvFromPersistentComplete(std::vector<CommsRequest_t> &list,int dir)
+{
+}
+void CartesianCommunicator::StencilSendToRecvFromPersistentFree(std::vector<CommsRequest_t> &list)
+{
+}
 
 void CartesianCommunicator::StencilBarrier(void){};
 
@@ -57,7 +57,7 @@ Gather_plane_simple (const Lattice<vobj> &rhs,cshiftVector<vobj> &buffer,int dim
       for(int b=0;b<e2;b++){
 	int o  = n*stride;
 	int bo = n*e2;
-	Cshift_table[ent++] = std::pair<int,int>(off+bo+b,so+o+b);
+	Cshift_table[ent++] = std::pair<int,int>(off+bo+b,rhs.Grid()->oIndexFromLex(so+o+b));
       }
     }
   } else { 
@@ -67,7 +67,7 @@ Gather_plane_simple (const Lattice<vobj> &rhs,cshiftVector<vobj> &buffer,int dim
 	 int o  = n*stride;
 	 int ocb=1<<rhs.Grid()->CheckerBoardFromOindex(o+b);
 	 if ( ocb &cbmask ) {
-	   Cshift_table[ent++]=std::pair<int,int> (off+bo++,so+o+b);
+	   Cshift_table[ent++]=std::pair<int,int> (off+bo++,rhs.Grid()->oIndexFromLex(so+o+b));
 	 }
        }
      }
@@ -108,6 +108,7 @@ Gather_plane_extract(const Lattice<vobj> &rhs,
   int e1=rhs.Grid()->_slice_nblock[dimension];
   int e2=rhs.Grid()->_slice_block[dimension];
   int n1=rhs.Grid()->_slice_stride[dimension];
+  int *l2s=rhs.Grid()->LexToSiteTable();
 
   if ( cbmask ==0x3){
 #ifdef ACCELERATOR_CSHIFT
@@ -118,7 +119,7 @@ Gather_plane_extract(const Lattice<vobj> &rhs,
 	int o      =   n*n1;
 	int offset = b+n*e2;
 	
-	vobj temp =rhs_v[so+o+b];
+	vobj temp =rhs_v[oLayoutMap(l2s,so+o+b)];
 	extract<vobj>(temp,pointers,offset);
       });
 #else
@@ -127,7 +128,7 @@ Gather_plane_extract(const Lattice<vobj> &rhs,
 	int o      =   n*n1;
 	int offset = b+n*e2;
 	
-	vobj temp =rhs_v[so+o+b];
+	vobj temp =rhs_v[oLayoutMap(l2s,so+o+b)];
 	extract<vobj>(temp,pointers,offset);
       });
 #endif
@@ -152,7 +153,7 @@ Gather_plane_extract(const Lattice<vobj> &rhs,
 	int offset = b+n*e2;
 
 	if ( ocb & cbmask ) {
-	  vobj temp =rhs_v[so+o+b];
+	  vobj temp =rhs_v[oLayoutMap(l2s,so+o+b)];
 	  extract<vobj>(temp,pointers,offset);
 	}
       });
@@ -171,7 +172,7 @@ Gather_plane_extract(const Lattice<vobj> &rhs,
 	int offset = b+n*e2;
 
 	if ( ocb & cbmask ) {
-	  vobj temp =rhs_v[so+o+b];
+	  vobj temp =rhs_v[oLayoutMap(l2s,so+o+b)];
 	  extract<vobj>(temp,pointers,offset);
 	}
       });
@@ -206,7 +207,7 @@ template<class vobj> void Scatter_plane_simple (Lattice<vobj> &rhs,cshiftVector<
       for(int b=0;b<e2;b++){
 	int o   =n*rhs.Grid()->_slice_stride[dimension];
 	int bo  =n*rhs.Grid()->_slice_block[dimension];
-	Cshift_table[ent++] = std::pair<int,int>(so+o+b,bo+b);
+	Cshift_table[ent++] = std::pair<int,int>(rhs.Grid()->oIndexFromLex(so+o+b),bo+b);
       }
     }
 
@@ -217,7 +218,7 @@ template<class vobj> void Scatter_plane_simple (Lattice<vobj> &rhs,cshiftVector<
 	int o   =n*rhs.Grid()->_slice_stride[dimension];
 	int ocb=1<<rhs.Grid()->CheckerBoardFromOindex(o+b);// Could easily be a table lookup
 	if ( ocb & cbmask ) {
-	  Cshift_table[ent++]=std::pair<int,int> (so+o+b,bo++);
+	  Cshift_table[ent++]=std::pair<int,int> (rhs.Grid()->oIndexFromLex(so+o+b),bo++);
 	}
       }
     }
@@ -255,6 +256,7 @@ template<class vobj> void Scatter_plane_merge(Lattice<vobj> &rhs,ExtractPointerA
     
   int e1=rhs.Grid()->_slice_nblock[dimension];
   int e2=rhs.Grid()->_slice_block[dimension];
+  int *l2s=rhs.Grid()->LexToSiteTable();
 
   if(cbmask ==0x3 ) {
     int _slice_stride = rhs.Grid()->_slice_stride[dimension];
@@ -266,14 +268,14 @@ template<class vobj> void Scatter_plane_merge(Lattice<vobj> &rhs,ExtractPointerA
 	int b = nn/e1;
 	int o      = n*_slice_stride;
 	int offset = b+n*_slice_block;
-	merge(rhs_v[so+o+b],pointers,offset);
+	merge(rhs_v[oLayoutMap(l2s,so+o+b)],pointers,offset);
       });
 #else
     autoView( rhs_v , rhs, CpuWrite);
     thread_for2d(n,e1,b,e2,{
 	int o      = n*_slice_stride;
 	int offset = b+n*_slice_block;
-	merge(rhs_v[so+o+b],pointers,offset);
+	merge(rhs_v[oLayoutMap(l2s,so+o+b)],pointers,offset);
     });
 #endif
   } else { 
@@ -290,7 +292,7 @@ template<class vobj> void Scatter_plane_merge(Lattice<vobj> &rhs,ExtractPointerA
 	int offset = b+n*rhs.Grid()->_slice_block[dimension];
 	int ocb=1<<rhs.Grid()->CheckerBoardFromOindex(o+b);
 	if ( ocb&cbmask ) {
-	  merge(rhs_v[so+o+b],pointers,offset);
+	  merge(rhs_v[oLayoutMap(l2s,so+o+b)],pointers,offset);
 	}
       }
     }
@@ -324,7 +326,7 @@ template<class vobj> void Copy_plane(Lattice<vobj>& lhs,const Lattice<vobj> &rhs
     for(int n=0;n<e1;n++){
       for(int b=0;b<e2;b++){
         int o =n*stride+b;
-	Cshift_table[ent++] = std::pair<int,int>(lo+o,ro+o);
+	Cshift_table[ent++] = std::pair<int,int>(lhs.Grid()->oIndexFromLex(lo+o),rhs.Grid()->oIndexFromLex(ro+o));
       }
     }
   } else { 
@@ -333,7 +335,7 @@ template<class vobj> void Copy_plane(Lattice<vobj>& lhs,const Lattice<vobj> &rhs
         int o =n*stride+b;
         int ocb=1<<lhs.Grid()->CheckerBoardFromOindex(o);
         if ( ocb&cbmask ) {
-	  Cshift_table[ent++] = std::pair<int,int>(lo+o,ro+o);
+	  Cshift_table[ent++] = std::pair<int,int>(lhs.Grid()->oIndexFromLex(lo+o),rhs.Grid()->oIndexFromLex(ro+o));
 	}
       }
     }
@@ -380,14 +382,14 @@ template<class vobj> void Copy_plane_permute(Lattice<vobj>& lhs,const Lattice<vo
     for(int n=0;n<e1;n++){
     for(int b=0;b<e2;b++){
       int o  =n*stride;
-      Cshift_table[ent++] = std::pair<int,int>(lo+o+b,ro+o+b);
+      Cshift_table[ent++] = std::pair<int,int>(lhs.Grid()->oIndexFromLex(lo+o+b),rhs.Grid()->oIndexFromLex(ro+o+b));
     }}
   } else {
     for(int n=0;n<e1;n++){
     for(int b=0;b<e2;b++){
       int o  =n*stride;
       int ocb=1<<lhs.Grid()->CheckerBoardFromOindex(o+b);
-      if ( ocb&cbmask ) Cshift_table[ent++] = std::pair<int,int>(lo+o+b,ro+o+b);
+      if ( ocb&cbmask ) Cshift_table[ent++] = std::pair<int,int>(lhs.Grid()->oIndexFromLex(lo+o+b),rhs.Grid()->oIndexFromLex(ro+o+b));
     }}
   }
 
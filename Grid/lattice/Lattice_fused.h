@@ -0,0 +1,348 @@
+/*************************************************************************************
+
+    Grid physics library, www.github.com/paboyle/Grid
+
+    Source file: ./lib/lattice/Lattice_fused.h
+
+    Copyright (C) 2015
+
+This program is free software; you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation; either version 2 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along
+with this program; if not, write to the Free Software Foundation, Inc.,
+51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+
+    See the full license in the file "LICENSE" in the top level distribution directory
+*************************************************************************************/
+/*  END LEGAL */
+#pragma once
+
+NAMESPACE_BEGIN(Grid);
+
+//////////////////////////////////////////////////////////////////////////////////////
+// Fused BLAS-1 kernels for the Krylov solvers.
+//
+// Each routine makes a single pass over its operands and, where a reduction is
+// returned, performs a single global sum. Naming follows axpy(ret,a,x,y):
+//
+//   z1 = a x1 + y1 ; z2 = b x2 + y2
+//
+// Outputs may alias any input; every site is read completely before it is
+// written, so e.g. the CG update
+//
+//   psi = a p + psi ; p = b p + r      ->   axpy_axpy(psi,a,p,psi,p,b,p,r)
+//
+// is valid.
+//////////////////////////////////////////////////////////////////////////////////////
+template<class sobj,class vobj> inline void
+axpy_axpy(Lattice<vobj> &z1,sobj a,const Lattice<vobj> &x1,const Lattice<vobj> &y1,
+	  Lattice<vobj> &z2,sobj b,const Lattice<vobj> &x2,const Lattice<vobj> &y2)
+{
+  conformable(x1,y1);
+  conformable(x1,x2);
+  conformable(x2,y2);
+  z1.Checkerboard() = x1.Checkerboard();
+  z2.Checkerboard() = x2.Checkerboard();
+  conformable(z1,x1);
+  conformable(z2,x2);
+
+  autoView( x1_v, x1, AcceleratorRead);
+  autoView( y1_v, y1, AcceleratorRead);
+  autoView( x2_v, x2, AcceleratorRead);
+  autoView( y2_v, y2, AcceleratorRead);
+  autoView( z1_v, z1, AcceleratorWrite);
+  autoView( z2_v, z2, AcceleratorWrite);
+  accelerator_for(ss,x1_v.size(),vobj::Nsimd(),{
+    auto t1 = a*x1_v(ss)+y1_v(ss);
+    auto t2 = b*x2_v(ss)+y2_v(ss);
+    coalescedWrite(z1_v[ss],t1);
+    coalescedWrite(z2_v[ss],t2);
+  });
+}
+
+// As axpy_axpy, returning |z2|^2
+template<class sobj,class vobj> inline RealD
+axpy_axpy_norm(Lattice<vobj> &z1,sobj a,const Lattice<vobj> &x1,const Lattice<vobj> &y1,
+	       Lattice<vobj> &z2,sobj b,const Lattice<vobj> &x2,const Lattice<vobj> &y2)
+{
+  conformable(x1,y1);
+  conformable(x1,x2);
+  conformable(x2,y2);
+  z1.Checkerboard() = x1.Checkerboard();
+  z2.Checkerboard() = x2.Checkerboard();
+  conformable(z1,x1);
+  conformable(z2,x2);
+
+  GridBase *grid = x1.Grid();
+  const uint64_t sites = grid->oSites();
+
+  typedef decltype(innerProductD(vobj(),vobj())) inner_t;
+  Vector<inner_t> norm_tmp(sites);
+  auto norm_tmp_v = &norm_tmp[0];
+  {
+    autoView( x1_v, x1, AcceleratorRead);
+    autoView( y1_v, y1, AcceleratorRead);
+    autoView( x2_v, x2, AcceleratorRead);
+    autoView( y2_v, y2, AcceleratorRead);
+    autoView( z1_v, z1, AcceleratorWrite);
+    autoView( z2_v, z2, AcceleratorWrite);
+    accelerator_for(ss,sites,1,{
+      auto t1 = a*x1_v[ss]+y1_v[ss];
+      auto t2 = b*x2_v[ss]+y2_v[ss];
+      norm_tmp_v[ss]=innerProductD(t2,t2);
+      z1_v[ss]=t1;
+      z2_v[ss]=t2;
+    });
+  }
+  RealD nrm = real(TensorRemove(sum(norm_tmp_v,sites)));
+  grid->GlobalSum(nrm);
+  return nrm;
+}
+
+// As axpy_axpy_norm, also returning ip = <w,z2> in the same reduction
+template<class sobj,class vobj> inline RealD
+axpy_axpy_norm_inner(ComplexD &ip,
+		     Lattice<vobj> &z1,sobj a,const Lattice<vobj> &x1,const Lattice<vobj> &y1,
+		     Lattice<vobj> &z2,sobj b,const Lattice<vobj> &x2,const Lattice<vobj> &y2,
+		     const Lattice<vobj> &w)
+{
+  conformable(x1,y1);
+  conformable(x1,x2);
+  conformable(x2,y2);
+  conformable(x2,w);
+  z1.Checkerboard() = x1.Checkerboard();
+  z2.Checkerboard() = x2.Checkerboard();
+  conformable(z1,x1);
+  conformable(z2,x2);
+
+  GridBase *grid = x1.Grid();
+  const uint64_t sites = grid->oSites();
+
+  typedef decltype(innerProductD(vobj(),vobj())) inner_t;
+  Vector<inner_t> norm_tmp(sites);
+  Vector<inner_t> inner_tmp(sites);
+  auto norm_tmp_v  = &norm_tmp[0];
+  auto inner_tmp_v = &inner_tmp[0];
+  {
+    autoView( x1_v, x1, AcceleratorRead);
+    autoView( y1_v, y1, AcceleratorRead);
+    autoView( x2_v, x2, AcceleratorRead);
+    autoView( y2_v, y2, AcceleratorRead);
+    autoView( w_v , w , AcceleratorRead);
+    autoView( z1_v, z1, AcceleratorWrite);
+    autoView( z2_v, z2, AcceleratorWrite);
+    accelerator_for(ss,sites,1,{
+      auto t1 = a*x1_v[ss]+y1_v[ss];
+      auto t2 = b*x2_v[ss]+y2_v[ss];
+      norm_tmp_v[ss] =innerProductD(t2,t2);
+      inner_tmp_v[ss]=innerProductD(w_v[ss],t2);
+      z1_v[ss]=t1;
+      z2_v[ss]=t2;
+    });
+  }
+  ComplexD tmp[2];
+  tmp[0] = TensorRemove(sum(norm_tmp_v,sites));
+  tmp[1] = TensorRemove(sum(inner_tmp_v,sites));
+  grid->GlobalSumVector(&tmp[0],2);
+  ip = tmp[1];
+  return real(tmp[0]);
+}
+
+//////////////////////////////////////////////////////////////////////////////////////
+// Deferred, fused evaluation of expression templates.
+//
+// Each statement is recorded as an expression AST (the same LatticeUnaryExpression,
+// LatticeBinaryExpression, ... trees used by Lattice::operator=) and nothing is
+// evaluated until fusedEval, which runs every statement in ONE site loop, in
+// argument order, followed by a single global sum for all reductions:
+//
+//   RealD n;
+//   fusedEval( fusedAssign(a, b*c),
+//              fusedAssign(d, a+e),
+//              fusedNorm2 (n, d) );
+//
+// is equivalent to  a = b*c; d = a+e; n = norm2(d);  but streams b,c,e once,
+// writes a and d once and never re-reads them from memory.
+//
+// Statements are site local so in-order evaluation per site gives the same
+// result as sequential evaluation. The checkerboard of each output is taken from
+// its expression; an output reused as an input to a later statement must already
+// carry that checkerboard (always true on full grids).
+//////////////////////////////////////////////////////////////////////////////////////
+template<class vobj,class Expr>
+class FusedAssign {
+public:
+  Lattice<vobj> *lhs;
+  LatticeView<vobj> lhs_v;
+  Expr expr;
+
+  FusedAssign(Lattice<vobj> &_lhs,const Expr &_expr) : lhs(&_lhs), lhs_v(_lhs), expr(_expr) {};
+
+  int  Reductions(void) const { return 0; }
+  void Open(GridBase *&grid)
+  {
+    GridFromExpression(grid,expr);
+    assert(grid!=nullptr);
+    conformable(lhs->Grid(),grid);
+    int cb=-1;
+    CBFromExpression(cb,expr);
+    assert( (cb==Odd) || (cb==Even));
+    lhs->Checkerboard() = cb;
+    ExpressionViewOpen(expr);
+    lhs_v.ViewOpen(AcceleratorWrite);
+  }
+  void Close(void)
+  {
+    lhs_v.ViewClose();
+    ExpressionViewClose(expr);
+  }
+  void LocalSum(ComplexD *red,uint64_t sites) {}
+  void Result(const ComplexD *red) {}
+
+  accelerator_inline void operator()(uint64_t ss) const {
+    lhs_v[ss] = vecEval(ss,expr);
+  }
+};
+
+template<class Left,class Right>
+class FusedInnerProduct {
+public:
+  typedef decltype(innerProductD(vecEval(0,std::declval<Left>()),vecEval(0,std::declval<Right>()))) inner_t;
+  Left  left;
+  Right right;
+  ComplexD *result;
+  Vector<inner_t> *tmp;
+  inner_t *tmp_v;
+
+  FusedInnerProduct(ComplexD *_result,const Left &_left,const Right &_right)
+    : left(_left), right(_right), result(_result), tmp(nullptr), tmp_v(nullptr) {};
+
+  int  Reductions(void) const { return 1; }
+  void Open(GridBase *&grid)
+  {
+    GridFromExpression(grid,left);
+    GridFromExpression(grid,right);
+    assert(grid!=nullptr);
+    ExpressionViewOpen(left);
+    ExpressionViewOpen(right);
+    tmp   = new Vector<inner_t>(grid->oSites());
+    tmp_v = &(*tmp)[0];
+  }
+  void Close(void)
+  {
+    ExpressionViewClose(left);
+    ExpressionViewClose(right);
+  }
+  void LocalSum(ComplexD *red,uint64_t sites)
+  {
+    red[0] = TensorRemove(sum(tmp_v,sites));
+    delete tmp;
+    tmp = nullptr;
+  }
+  void Result(const ComplexD *red) { *result = red[0]; }
+
+  accelerator_inline void operator()(uint64_t ss) const {
+    tmp_v[ss] = innerProductD(vecEval(ss,left),vecEval(ss,right));
+  }
+};
+
+template<class Arg>
+class FusedNorm2 : public FusedInnerProduct<Arg,Arg> {
+public:
+  RealD *nrm;
+  FusedNorm2(RealD &_nrm,const Arg &_arg) : FusedInnerProduct<Arg,Arg>(nullptr,_arg,_arg), nrm(&_nrm) {};
+  void Result(const ComplexD *red) { *nrm = real(red[0]); }
+};
+
+// Recursive statement list; a single object the site loop can capture by value
+template<class... Statements> class FusedStatementList;
+
+template<> class FusedStatementList<> {
+public:
+  int  Reductions(void) const { return 0; }
+  void Open(GridBase *&grid) {}
+  void Close(void) {}
+  void LocalSum(ComplexD *red,uint64_t sites) {}
+  void Result(const ComplexD *red) {}
+  accelerator_inline void operator()(uint64_t ss) const {}
+};
+
+template<class Head,class... Tail>
+class FusedStatementList<Head,Tail...> {
+public:
+  Head head;
+  FusedStatementList<Tail...> tail;
+
+  FusedStatementList(const Head &_head,const Tail &... _tail) : head(_head), tail(_tail...) {};
+
+  int  Reductions(void) const { return head.Reductions()+tail.Reductions(); }
+  void Open(GridBase *&grid) { head.Open(grid); tail.Open(grid); }
+  void Close(void)           { head.Close(); tail.Close(); }
+  void LocalSum(ComplexD *red,uint64_t sites) { head.LocalSum(red,sites); tail.LocalSum(red+head.Reductions(),sites); }
+  void Result(const ComplexD *red)            { head.Result(red);         tail.Result(red+head.Reductions()); }
+  accelerator_inline void operator()(uint64_t ss) const {
+    head(ss);
+    tail(ss);
+  }
+};
+
+// Statement constructors
+template<class vobj,class Expr,
+	 typename std::enable_if<is_lattice_expr<Expr>::value,Expr>::type * = nullptr>
+inline FusedAssign<vobj,Expr> fusedAssign(Lattice<vobj> &lhs,const Expr &expr)
+{
+  return FusedAssign<vobj,Expr>(lhs,expr);
+}
+template<class vobj>
+inline FusedAssign<vobj,LatticeView<vobj> > fusedAssign(Lattice<vobj> &lhs,const Lattice<vobj> &rhs)
+{
+  return FusedAssign<vobj,LatticeView<vobj> >(lhs,LatticeView<vobj>(rhs));
+}
+template<class Left,class Right>
+inline FusedInnerProduct<typename ViewMap<Left>::Type,typename ViewMap<Right>::Type>
+fusedInnerProduct(ComplexD &result,const Left &left,const Right &right)
+{
+  typedef typename ViewMap<Left>::Type  L;
+  typedef typename ViewMap<Right>::Type R;
+  return FusedInnerProduct<L,R>(&result,L(left),R(right));
+}
+template<class Arg>
+inline FusedNorm2<typename ViewMap<Arg>::Type> fusedNorm2(RealD &result,const Arg &arg)
+{
+  typedef typename ViewMap<Arg>::Type A;
+  return FusedNorm2<A>(result,A(arg));
+}
+
+template<class... Statements>
+inline void fusedEval(const Statements &... statements)
+{
+  FusedStatementList<Statements...> list(statements...);
+
+  GridBase *grid = nullptr;
+  list.Open(grid);
+  assert(grid!=nullptr);
+
+  const uint64_t sites = grid->oSites();
+  accelerator_for(ss,sites,1,{
+    list(ss);
+  });
+  list.Close();
+
+  int nred = list.Reductions();
+  if ( nred ) {
+    std::vector<ComplexD> red(nred);
+    list.LocalSum(&red[0],sites);
+    grid->GlobalSumVector(&red[0],nred);
+    list.Result(&red[0]);
+  }
+}
+
+NAMESPACE_END(Grid);
@@ -63,16 +63,16 @@ static void sliceMaddMatrix (Lattice<vobj> &R,Eigen::MatrixXcd &aa,const Lattice
 	int o  = n*stride + b;
 
 	for(int i=0;i<Nblock;i++){
-	  s_x[i] = X_v[o+i*ostride];
+	  s_x[i] = X_v[FullGrid->oIndexFromLex(o+i*ostride)];
 	}
 
 	vobj dot;
 	for(int i=0;i<Nblock;i++){
-	  dot = Y_v[o+i*ostride];
+	  dot = Y_v[FullGrid->oIndexFromLex(o+i*ostride)];
 	  for(int j=0;j<Nblock;j++){
 	    dot = dot + s_x[j]*(scale*aa(j,i));
 	  }
-	  R_v[o+i*ostride]=dot;
+	  R_v[FullGrid->oIndexFromLex(o+i*ostride)]=dot;
 	}
       }});
   }
@@ -109,7 +109,7 @@ static void sliceMulMatrix (Lattice<vobj> &R,Eigen::MatrixXcd &aa,const Lattice<
 	int o  = n*stride + b;
 
 	for(int i=0;i<Nblock;i++){
-	  s_x[i] = X_v[o+i*ostride];
+	  s_x[i] = X_v[FullGrid->oIndexFromLex(o+i*ostride)];
 	}
 
 	vobj dot;
@@ -118,7 +118,7 @@ static void sliceMulMatrix (Lattice<vobj> &R,Eigen::MatrixXcd &aa,const Lattice<
 	  for(int j=1;j<Nblock;j++){
 	    dot = dot + s_x[j]*(scale*aa(j,i));
 	  }
-	  R_v[o+i*ostride]=dot;
+	  R_v[FullGrid->oIndexFromLex(o+i*ostride)]=dot;
 	}
     }});
   }
@@ -169,8 +169,8 @@ static void sliceInnerProductMatrix(  Eigen::MatrixXcd &mat, const Lattice<vobj>
 	int o  = n*stride + b;
 
 	for(int i=0;i<Nblock;i++){
-	  Left [i] = lhs_v[o+i*ostride];
-	  Right[i] = rhs_v[o+i*ostride];
+	  Left [i] = lhs_v[FullGrid->oIndexFromLex(o+i*ostride)];
+	  Right[i] = rhs_v[FullGrid->oIndexFromLex(o+i*ostride)];
 	}
 
 	for(int i=0;i<Nblock;i++){
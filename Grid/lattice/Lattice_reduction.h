@@ -262,6 +262,60 @@ inline ComplexD innerProduct(const Lattice<vobj> &left,const Lattice<vobj> &righ
   return nrm;
 }
 
+/////////////////////////////////////////////////////////////////////////////
+// Non-blocking reductions. The local sum is formed immediately and the
+// global sum is left in flight; wait() returns the reduced value.
+//
+//   auto ip = innerProductBegin(p,Ap);
+//   ... local work not touching the result ...
+//   ComplexD pAp = ip.wait();
+//
+// The result buffer is heap allocated so the future may be moved while
+// the reduction is in flight. Destroying an incomplete future waits.
+/////////////////////////////////////////////////////////////////////////////
+template<class scalar>
+class GlobalSumFuture {
+private:
+  GridBase *grid;
+  std::unique_ptr<scalar> result;
+  CommsRequest_t request;
+  bool pending;
+public:
+  GlobalSumFuture(GridBase *_grid,const scalar &local)
+    : grid(_grid), result(new scalar(local)), pending(true)
+  {
+    grid->GlobalSumVectorBegin(result.get(),1,request);
+  }
+  GlobalSumFuture(GlobalSumFuture &&other) = default;
+  GlobalSumFuture(const GlobalSumFuture &other) = delete;
+  GlobalSumFuture &operator=(const GlobalSumFuture &other) = delete;
+  ~GlobalSumFuture() { if ( result && pending ) grid->GlobalSumWait(request); }
+
+  // Progress the reduction; true once the value is available
+  bool test(void) {
+    if ( pending && grid->GlobalSumTest(request) ) pending = false;
+    return !pending;
+  }
+  scalar wait(void) {
+    if ( pending ) {
+      grid->GlobalSumWait(request);
+      pending = false;
+    }
+    return *result;
+  }
+};
+
+template<class vobj>
+inline GlobalSumFuture<ComplexD> innerProductBegin(const Lattice<vobj> &left,const Lattice<vobj> &right) {
+  conformable(left,right);
+  return GlobalSumFuture<ComplexD>(left.Grid(),rankInnerProduct(left,right));
+}
+
+template<class vobj>
+inline GlobalSumFuture<RealD> norm2Begin(const Lattice<vobj> &arg) {
+  return GlobalSumFuture<RealD>(arg.Grid(),real(rankInnerProduct(arg,arg)));
+}
+
 
 /////////////////////////
 // Fast axpby_norm
@@ -420,7 +474,7 @@ template<class vobj> inline void sliceSum(const Lattice<vobj> &Data,std::vector<
     int so=r*grid->_ostride[orthogdim]; // base offset for start of plane 
     for(int n=0;n<e1;n++){
       for(int b=0;b<e2;b++){
-	int ss= so+n*stride+b;
+	int ss= grid->oIndexFromLex(so+n*stride+b);
 	lvSum[r]=lvSum[r]+Data_v[ss];
       }
     }
@@ -500,7 +554,7 @@ static void sliceInnerProductVector( std::vector<ComplexD> & result, const Latti
 
     for(int n=0;n<e1;n++){
       for(int b=0;b<e2;b++){
-	int ss= so+n*stride+b;
+	int ss= grid->oIndexFromLex(so+n*stride+b);
 	vector_type vv = TensorRemove(innerProduct(lhv[ss],rhv[ss]));
 	lvSum[r]=lvSum[r]+vv;
       }
@@ -604,7 +658,7 @@ static void sliceMaddVector(Lattice<vobj> &R,std::vector<RealD> &a,const Lattice
     autoView( Xv, X, CpuRead);
     autoView( Yv, Y, CpuRead);
     thread_for2d( n, e1, b,e2, {
-	int ss= so+n*stride+b;
+	int ss= grid->oIndexFromLex(so+n*stride+b);
 	Rv[ss] = at*Xv[ss]+Yv[ss];
     });
   }
@@ -670,16 +724,16 @@ static void sliceMaddMatrix (Lattice<vobj> &R,Eigen::MatrixXcd &aa,const Lattice
       int o  = n*stride + b;
 
       for(int i=0;i<Nblock;i++){
-	s_x[i] = X_v[o+i*ostride];
+	s_x[i] = X_v[FullGrid->oIndexFromLex(o+i*ostride)];
       }
 
       vobj dot;
       for(int i=0;i<Nblock;i++){
-	dot = Y_v[o+i*ostride];
+	dot = Y_v[FullGrid->oIndexFromLex(o+i*ostride)];
 	for(int j=0;j<Nblock;j++){
 	  dot = dot + s_x[j]*(scale*aa(j,i));
 	}
-	R_v[o+i*ostride]=dot;
+	R_v[FullGrid->oIndexFromLex(o+i*ostride)]=dot;
       }
     }});
   }
@@ -723,7 +777,7 @@ static void sliceMulMatrix (Lattice<vobj> &R,Eigen::MatrixXcd &aa,const Lattice<
       int o  = n*stride + b;
 
       for(int i=0;i<Nblock;i++){
-	s_x[i] = X_v[o+i*ostride];
+	s_x[i] = X_v[FullGrid->oIndexFromLex(o+i*ostride)];
       }
 
       vobj dot;
@@ -732,7 +786,7 @@ static void sliceMulMatrix (Lattice<vobj> &R,Eigen::MatrixXcd &aa,const Lattice<
 	for(int j=1;j<Nblock;j++){
 	  dot = dot + s_x[j]*(scale*aa(j,i));
 	}
-	R_v[o+i*ostride]=dot;
+	R_v[FullGrid->oIndexFromLex(o+i*ostride)]=dot;
       }
     }});
   }
@@ -784,8 +838,8 @@ static void sliceInnerProductMatrix(  Eigen::MatrixXcd &mat, const Lattice<vobj>
       int o  = n*stride + b;
 
       for(int i=0;i<Nblock;i++){
-	Left [i] = lhs_v[o+i*ostride];
-	Right[i] = rhs_v[o+i*ostride];
+	Left [i] = lhs_v[FullGrid->oIndexFromLex(o+i*ostride)];
+	Right[i] = rhs_v[FullGrid->oIndexFromLex(o+i*ostride)];
       }
 
       for(int i=0;i<Nblock;i++){
@@ -425,23 +425,26 @@ public:
     // in principle this is possible
     ////////////////////////////////////////////////
 
-    // Everybody loops over global volume.
-    thread_for( gidx, _grid->_gsites, {
-	// Where is it?
-	int rank;
-	int o_idx;
-	int i_idx;
-
-	Coordinate gcoor;
-	_grid->GlobalIndexToGlobalCoor(gidx,gcoor);
-	_grid->GlobalCoorToRankIndex(rank,o_idx,i_idx,gcoor);
-	
-	// If this is one of mine we take it
-	if( rank == _grid->ThisRank() ){
-	  int l_idx=generator_idx(o_idx,i_idx);
-	  _generators[l_idx] = master_engine;
-	  Skip(_generators[l_idx],gidx); // Skip to next RNG sequence
+    // Each rank visits only its own sites, jumping the single stream to the
+    // lexicographic global index of the site; identical to looping over the
+    // global volume and keeping the sites we own, at O(local volume) cost.
+    Coordinate lstart = _grid->_lstart;
+    Coordinate gdims  = _grid->_gdimensions;
+    int nd = _grid->_ndimension;
+    thread_for( lidx, _grid->lSites(), {
+	Coordinate lcoor;
+	_grid->LocalIndexToLocalCoor(lidx,lcoor);
+
+	uint64_t gidx=0;
+	uint64_t mult=1;
+	for(int mu=0;mu<nd;mu++) {
+	  gidx+=mult*(lcoor[mu]+lstart[mu]);
+	  mult*=gdims[mu];
 	}
+
+	int l_idx=generator_idx(_grid->oIndex(lcoor),_grid->iIndex(lcoor));
+	_generators[l_idx] = master_engine;
+	Skip(_generators[l_idx],gidx); // Skip to next RNG sequence
     });
 #else 
     ////////////////////////////////////////////////////////////////
@@ -513,10 +516,191 @@ public:
 
 };
 
+//////////////////////////////////////////////////////////////////////////////////////////
+// Counter based parallel RNG (Philox4x32-10, Salmon et al, SC11).
+//
+// There is no per-site state: the 128 bit counter is (global site index, word pair, draw)
+// and the 64 bit key comes from the seeds; draw counts the fills made so far. Every value
+// therefore depends only on the seeds, the global site, the position in the site object
+// and the number of preceding fills, so fields are bit-for-bit identical across
+// decompositions, SIMD layouts and site orderings, and a field of any grid can be filled
+// without a generator grid. Checkerboarded fields use the full lattice site index, so a
+// checkerboard fill equals that half of a full fill with the same draw number.
+//
+// Each Philox call gives two 64 bit words which become two uniforms, two gaussians
+// (Box-Muller) or two bernoulli bits; a site object is filled two real words at a time
+// (real and imaginary part for complex types). All lanes of an outer site are generated
+// together and written straight into the SIMD vectors; no merge.
+//////////////////////////////////////////////////////////////////////////////////////////
+accelerator_inline void Philox4x32_10(uint32_t ctr[4],uint32_t key0,uint32_t key1)
+{
+  for(int r=0;r<10;r++){
+    if ( r ) { key0 += 0x9E3779B9; key1 += 0xBB67AE85; }
+    uint64_t p0 = (uint64_t)0xD2511F53 * ctr[0];
+    uint64_t p1 = (uint64_t)0xCD9E8D57 * ctr[2];
+    uint32_t c0 = (uint32_t)(p1>>32) ^ ctr[1] ^ key0;
+    uint32_t c2 = (uint32_t)(p0>>32) ^ ctr[3] ^ key1;
+    ctr[1] = (uint32_t)p1;
+    ctr[3] = (uint32_t)p0;
+    ctr[0] = c0;
+    ctr[2] = c2;
+  }
+}
+
+class GridCounterRNG {
+public:
+  enum { Uniform=0, Gaussian=1, Bernoulli=2 };
+
+  GridCounterRNG() : _draw(0), _time_counter(0) { _key[0]=_key[1]=0; }
+
+  void SeedFixedIntegers(const std::vector<int> &seeds){
+    CartesianCommunicator::BroadcastWorld(0,(void *)&seeds[0],sizeof(int)*seeds.size());
+    std::seed_seq src(seeds.begin(),seeds.end());
+    src.generate(&_key[0],&_key[2]);
+    _draw = 0;
+  }
+  void SeedUniqueString(const std::string &s){
+    std::vector<int> seeds;
+    seeds = GridChecksum::sha256_seeds(s);
+    std::cout << GridLogMessage << "Intialising counter RNG with unique string '" 
+	      << s << "'" << std::endl;
+    std::cout << GridLogMessage << "Seed SHA256: " << GridChecksum::sha256_string(seeds) << std::endl;
+    SeedFixedIntegers(seeds);
+  }
+
+  // The whole state: key and number of fills
+  void GetState(std::vector<uint32_t> &saved) { saved = { _key[0], _key[1], _draw }; }
+  void SetState(const std::vector<uint32_t> &saved) {
+    assert(saved.size()==3);
+    _key[0]=saved[0]; _key[1]=saved[1]; _draw=saved[2];
+  }
+  uint32_t Draws(void) { return _draw; }
+
+  // Two 64 bit words mapped to two variates of the distribution
+  static accelerator_inline void Transform(int dist,uint64_t a,uint64_t b,RealD &x0,RealD &x1)
+  {
+    const RealD twom53 = 1.0/9007199254740992.0;
+    if ( dist==Gaussian ) {
+      RealD u1  = ((a>>11)+1)*twom53;  // (0,1]
+      RealD u2  = (b>>11)*twom53;      // [0,1)
+      RealD rad = sqrt(-2.0*log(u1));
+      RealD phi = 2.0*M_PI*u2;
+      x0 = rad*cos(phi);
+      x1 = rad*sin(phi);
+    } else if ( dist==Bernoulli ) {
+      x0 = (RealD)(a>>63);
+      x1 = (RealD)(b>>63);
+    } else {
+      x0 = (a>>11)*twom53;
+      x1 = (b>>11)*twom53;
+    }
+  }
+  static accelerator_inline void Words(uint32_t key0,uint32_t key1,uint64_t gsite,uint32_t pair,uint32_t draw,
+				       uint64_t &a,uint64_t &b)
+  {
+    uint32_t ctr[4] = { (uint32_t)gsite, (uint32_t)(gsite>>32), pair, draw };
+    Philox4x32_10(ctr,key0,key1);
+    a = ((uint64_t)ctr[1]<<32) | ctr[0];
+    b = ((uint64_t)ctr[3]<<32) | ctr[2];
+  }
+
+  // Real word `word` of global site gsite as written by fill number `draw`; for testing
+  RealD Value(uint64_t gsite,int word,uint32_t draw,int dist)
+  {
+    uint64_t a,b;
+    RealD x0,x1;
+    Words(_key[0],_key[1],gsite,word/2,draw,a,b);
+    Transform(dist,a,b,x0,x1);
+    return (word&0x1) ? x1 : x0;
+  }
+
+  template<class vobj> void fill(Lattice<vobj> &l,int dist)
+  {
+    typedef typename vobj::vector_type vector_type;
+    typedef typename vobj::scalar_type scalar_type;
+    typedef typename RealPart<scalar_type>::type real_type;
+    static_assert(std::is_floating_point<real_type>::value,"GridCounterRNG fills floating point fields");
+
+    double inner_time_counter = usecond();
+
+    GridBase *grid = l.Grid();
+    constexpr int Nsimd = vector_type::Nsimd();
+    assert(grid->Nsimd()==Nsimd);
+    const int cplx   = is_complex<scalar_type>::value ? 2 : 1;
+    const int nreal  = cplx*sizeof(vobj)/sizeof(vector_type);
+    const int npair  = (nreal+1)/2;
+    const int nd     = grid->_ndimension;
+    Coordinate rdims = grid->_rdimensions;
+    Coordinate simd  = grid->_simd_layout;
+    Coordinate lstart= grid->_lstart;
+    Coordinate fdims = grid->_fdimensions;
+    int *s2l = grid->SiteToLexTable();
+    GridRedBlackCartesian *rb = dynamic_cast<GridRedBlackCartesian *>(grid);
+    int cbdim = rb ? rb->_checker_dim : -1;
+    int cb    = l.Checkerboard();
+    Coordinate cbmask(nd);
+    for(int d=0;d<nd;d++) cbmask[d] = rb ? rb->_checker_dim_mask[d] : 0;
+    uint32_t key0 = _key[0];
+    uint32_t key1 = _key[1];
+    uint32_t draw = _draw++;
+
+    autoView(l_v, l, AcceleratorWrite);
+    accelerator_for(ss, grid->oSites(), 1, {
+
+      Coordinate ocoor(nd);
+      Coordinate icoor(nd);
+      Coordinate gcoor(nd);
+      uint64_t gsite[Nsimd];
+      Lexicographic::CoorFromIndex(ocoor,oLayoutMap(s2l,ss),rdims);
+      for(int lane=0;lane<Nsimd;lane++){
+	Lexicographic::CoorFromIndex(icoor,lane,simd);
+	for(int d=0;d<nd;d++) gcoor[d] = lstart[d] + ocoor[d] + rdims[d]*icoor[d];
+	if ( cbdim>=0 ) { // reduced to full coordinate
+	  int parity = cb;
+	  for(int d=0;d<nd;d++) if ( cbmask[d] && (d!=cbdim) ) parity += gcoor[d];
+	  gcoor[cbdim] = 2*gcoor[cbdim] + (parity&0x1);
+	}
+	uint64_t g=0;
+	for(int d=nd-1;d>=0;d--) g = g*fdims[d] + gcoor[d];
+	gsite[lane]=g;
+      }
+
+      real_type *out = (real_type *)&l_v[ss];
+      for(int p=0;p<npair;p++){
+	uint64_t a[Nsimd], b[Nsimd];
+	RealD   x0[Nsimd], x1[Nsimd];
+	for(int lane=0;lane<Nsimd;lane++) Words(key0,key1,gsite[lane],p,draw,a[lane],b[lane]);
+	for(int lane=0;lane<Nsimd;lane++) Transform(dist,a[lane],b[lane],x0[lane],x1[lane]);
+	for(int lane=0;lane<Nsimd;lane++){
+	  int r = 2*p;
+	  out[(r/cplx)*cplx*Nsimd + lane*cplx + r%cplx] = x0[lane];
+	  r++;
+	  if ( r<nreal ) out[(r/cplx)*cplx*Nsimd + lane*cplx + r%cplx] = x1[lane];
+	}
+      }
+    });
+
+    _time_counter += usecond()- inner_time_counter;
+  }
+
+  void Report(){
+    std::cout << GridLogMessage << "Time spent in the fill() routine by GridCounterRNG: "<< _time_counter/1e3 << " ms" << std::endl;
+  }
+
+private:
+  uint32_t _key[2];
+  uint32_t _draw;
+  double   _time_counter;
+};
+
 template <class vobj> inline void random(GridParallelRNG &rng,Lattice<vobj> &l)   { rng.fill(l,rng._uniform);  }
 template <class vobj> inline void gaussian(GridParallelRNG &rng,Lattice<vobj> &l) { rng.fill(l,rng._gaussian); }
 template <class vobj> inline void bernoulli(GridParallelRNG &rng,Lattice<vobj> &l){ rng.fill(l,rng._bernoulli);}
 
+template <class vobj> inline void random(GridCounterRNG &rng,Lattice<vobj> &l)   { rng.fill(l,GridCounterRNG::Uniform);  }
+template <class vobj> inline void gaussian(GridCounterRNG &rng,Lattice<vobj> &l) { rng.fill(l,GridCounterRNG::Gaussian); }
+template <class vobj> inline void bernoulli(GridCounterRNG &rng,Lattice<vobj> &l){ rng.fill(l,GridCounterRNG::Bernoulli);}
+
 template <class sobj> inline void random(GridSerialRNG &rng,sobj &l)   { rng.fill(l,rng._uniform  ); }
 template <class sobj> inline void gaussian(GridSerialRNG &rng,sobj &l) { rng.fill(l,rng._gaussian ); }
 template <class sobj> inline void bernoulli(GridSerialRNG &rng,sobj &l){ rng.fill(l,rng._bernoulli); }
@@ -95,13 +95,14 @@ template<class vobj> inline void acceleratorPickCheckerboard(int cb,Lattice<vobj
   unsigned long ndim_half          = half.Grid()->_ndimension;
   Coordinate checker_dim_mask_half = half.Grid()->_checker_dim_mask;
   Coordinate ostride_half          = half.Grid()->_ostride;
+  int *s2l_full                    = full.Grid()->SiteToLexTable();
   accelerator_for(ss, full.Grid()->oSites(),full.Grid()->Nsimd(),{
     
     Coordinate coor;
     int cbos;
     int linear=0;
 
-    Lexicographic::CoorFromIndex(coor,ss,rdim_full);
+    Lexicographic::CoorFromIndex(coor,oLayoutMap(s2l_full,ss),rdim_full);
     assert(coor.size()==ndim_half);
 
     for(int d=0;d<ndim_half;d++){ 
@@ -129,13 +130,14 @@ template<class vobj> inline void acceleratorSetCheckerboard(Lattice<vobj> &full,
   unsigned long ndim_half          = half.Grid()->_ndimension;
   Coordinate checker_dim_mask_half = half.Grid()->_checker_dim_mask;
   Coordinate ostride_half          = half.Grid()->_ostride;
+  int *s2l_full                    = full.Grid()->SiteToLexTable();
   accelerator_for(ss,full.Grid()->oSites(),full.Grid()->Nsimd(),{
 
     Coordinate coor;
     int cbos;
     int linear=0;
   
-    Lexicographic::CoorFromIndex(coor,ss,rdim_full);
+    Lexicographic::CoorFromIndex(coor,oLayoutMap(s2l_full,ss),rdim_full);
     assert(coor.size()==ndim_half);
 
     for(int d=0;d<ndim_half;d++){ 
@@ -290,6 +292,73 @@ inline void blockProject(Lattice<iVector<CComplex,nbasis > > &coarseData,
 }
 
 
+////////////////////////////////////////////////////////////////////////////////////////////
+// Projection onto all basis vectors in one sweep: each fine site is read once and
+// dotted against every basis vector, instead of nbasis block inner products; sums are
+// accumulated in double as blockInnerProductD does. blockProject also deflates each
+// projection from the field before the next, which leaves the result unchanged only
+// if the basis is block orthonormal: use this on orthogonalised subspaces alone.
+////////////////////////////////////////////////////////////////////////////////////////////
+template<class vobj,class CComplex,int nbasis,class VLattice>
+inline void blockProjectFused(Lattice<iVector<CComplex,nbasis > > &coarseData,
+			      const             Lattice<vobj>   &fineData,
+			      const VLattice &Basis)
+{
+  GridBase * fine  = fineData.Grid();
+  GridBase * coarse= coarseData.Grid();
+
+  subdivides(coarse,fine); // require they map
+  assert(Basis.size()>=nbasis);
+
+  int _ndimension = coarse->_ndimension;
+  Coordinate  block_r      (_ndimension);
+  for(int d=0 ; d<_ndimension;d++){
+    block_r[d] = fine->_rdimensions[d] / coarse->_rdimensions[d];
+  }
+  int blockVol = fine->oSites()/coarse->oSites();
+
+  typedef LatticeView<vobj> Bview;
+  Vector<Bview> BasisViewContainer;
+  for(int v=0;v<nbasis;v++) BasisViewContainer.push_back(Basis[v].View(AcceleratorRead));
+  Bview *Basis_p = &BasisViewContainer[0];
+
+  autoView( coarseData_ , coarseData, AcceleratorWrite);
+  autoView( fineData_   , fineData, AcceleratorRead);
+
+  Coordinate fine_rdimensions = fine->_rdimensions;
+  Coordinate coarse_rdimensions = coarse->_rdimensions;
+  int *fine_l2s   = fine->LexToSiteTable();
+  int *coarse_s2l = coarse->SiteToLexTable();
+
+  accelerator_for(sc,coarse->oSites(),1,{
+
+      Coordinate coor_c(_ndimension);
+      Lexicographic::CoorFromIndex(coor_c,oLayoutMap(coarse_s2l,sc),coarse_rdimensions);
+
+      typedef decltype(TensorRemove(innerProductD2(Basis_p[0][0],fineData_[0]))) accum_t;
+      accum_t cd[nbasis];
+      for(int v=0;v<nbasis;v++) cd[v] = Zero();
+
+      for(int sb=0;sb<blockVol;sb++){
+
+	int sf;
+	Coordinate coor_b(_ndimension);
+	Coordinate coor_f(_ndimension);
+	Lexicographic::CoorFromIndex(coor_b,sb,block_r);
+	for(int d=0;d<_ndimension;d++) coor_f[d]=coor_c[d]*block_r[d] + coor_b[d];
+	Lexicographic::IndexFromCoor(coor_f,sf,fine_rdimensions);
+	sf = oLayoutMap(fine_l2s,sf);
+
+	for(int v=0;v<nbasis;v++){
+	  cd[v] = cd[v] + TensorRemove(innerProductD2(Basis_p[v][sf],fineData_[sf]));
+	}
+      }
+      for(int v=0;v<nbasis;v++) convertType(coarseData_[sc](v),cd[v]);
+    });
+
+  for(int v=0;v<nbasis;v++) BasisViewContainer[v].ViewClose();
+}
+
 template<class vobj,class vobj2,class CComplex>
   inline void blockZAXPY(Lattice<vobj> &fineZ,
 			 const Lattice<CComplex> &coarseA,
@@ -321,6 +390,8 @@ template<class vobj,class vobj2,class CComplex>
   autoView( coarseA_, coarseA, AcceleratorRead);
   Coordinate fine_rdimensions = fine->_rdimensions;
   Coordinate coarse_rdimensions = coarse->_rdimensions;
+  int *fine_s2l   = fine->SiteToLexTable();
+  int *coarse_l2s = coarse->LexToSiteTable();
 
   accelerator_for(sf, fine->oSites(), CComplex::Nsimd(), {
 
@@ -328,9 +399,10 @@ template<class vobj,class vobj2,class CComplex>
       Coordinate coor_c(_ndimension);
       Coordinate coor_f(_ndimension);
 
-      Lexicographic::CoorFromIndex(coor_f,sf,fine_rdimensions);
+      Lexicographic::CoorFromIndex(coor_f,oLayoutMap(fine_s2l,sf),fine_rdimensions);
       for(int d=0;d<_ndimension;d++) coor_c[d]=coor_f[d]/block_r[d];
       Lexicographic::IndexFromCoor(coor_c,sc,coarse_rdimensions);
+      sc = oLayoutMap(coarse_l2s,sc);
 
       // z = A x + y
 #ifdef GRID_SIMT
@@ -439,6 +511,8 @@ inline void blockSum(Lattice<vobj> &coarseData,const Lattice<vobj> &fineData)
   
   Coordinate fine_rdimensions = fine->_rdimensions;
   Coordinate coarse_rdimensions = coarse->_rdimensions;
+  int *fine_l2s   = fine->LexToSiteTable();
+  int *coarse_s2l = coarse->SiteToLexTable();
 
   vobj zz = Zero();
   
@@ -446,7 +520,7 @@ inline void blockSum(Lattice<vobj> &coarseData,const Lattice<vobj> &fineData)
 
       // One thread per sub block
       Coordinate coor_c(_ndimension);
-      Lexicographic::CoorFromIndex(coor_c,sc,coarse_rdimensions);  // Block coordinate
+      Lexicographic::CoorFromIndex(coor_c,oLayoutMap(coarse_s2l,sc),coarse_rdimensions);  // Block coordinate
 
       vobj cd = zz;
       
@@ -459,7 +533,7 @@ inline void blockSum(Lattice<vobj> &coarseData,const Lattice<vobj> &fineData)
 	for(int d=0;d<_ndimension;d++) coor_f[d]=coor_c[d]*block_r[d] + coor_b[d];
 	Lexicographic::IndexFromCoor(coor_f,sf,fine_rdimensions);
 
-	cd=cd+fineData_p[sf];
+	cd=cd+fineData_p[oLayoutMap(fine_l2s,sf)];
       }
 
       coarseData_p[sc] = cd;
@@ -547,15 +621,19 @@ inline void blockPromote(const Lattice<iVector<CComplex,nbasis > > &coarseData,
   autoView( fineData_   , fineData, AcceleratorWrite);
   autoView( coarseData_ , coarseData, AcceleratorRead);
 
+  int *fine_s2l   = fine->SiteToLexTable();
+  int *coarse_l2s = coarse->LexToSiteTable();
+
   // Loop with a cache friendly loop ordering
   accelerator_for(sf,fine->oSites(),1,{
     int sc;
     Coordinate coor_c(_ndimension);
     Coordinate coor_f(_ndimension);
 
-    Lexicographic::CoorFromIndex(coor_f,sf,fine->_rdimensions);
+    Lexicographic::CoorFromIndex(coor_f,oLayoutMap(fine_s2l,sf),fine->_rdimensions);
     for(int d=0;d<_ndimension;d++) coor_c[d]=coor_f[d]/block_r[d];
     Lexicographic::IndexFromCoor(coor_c,sc,coarse->_rdimensions);
+    sc = oLayoutMap(coarse_l2s,sc);
 
     for(int i=0;i<nbasis;i++) {
       /*      auto basis_ = Basis[i],  );*/
@@ -657,6 +735,8 @@ void localCopyRegion(const Lattice<vobj> &From,Lattice<vobj> & To,Coordinate Fro
   Coordinate rdt = Tg->_rdimensions;
   Coordinate ist = Tg->_istride;
   Coordinate ost = Tg->_ostride;
+  int *l2s_f = Fg->LexToSiteTable();
+  int *l2s_t = Tg->LexToSiteTable();
 
   autoView( t_v , To, AcceleratorWrite);
   autoView( f_v , From, AcceleratorRead);
@@ -677,8 +757,8 @@ void localCopyRegion(const Lattice<vobj> &From,Lattice<vobj> & To,Coordinate Fro
       Integer idx_t = 0; for(int d=0;d<nd;d++) idx_t+=ist[d]*(Tcoor[d]/rdt[d]);
       Integer odx_f = 0; for(int d=0;d<nd;d++) odx_f+=osf[d]*(Fcoor[d]%rdf[d]);
       Integer odx_t = 0; for(int d=0;d<nd;d++) odx_t+=ost[d]*(Tcoor[d]%rdt[d]);
-      scalar_type * fp = (scalar_type *)&f_v[odx_f];
-      scalar_type * tp = (scalar_type *)&t_v[odx_t];
+      scalar_type * fp = (scalar_type *)&f_v[oLayoutMap(l2s_f,odx_f)];
+      scalar_type * tp = (scalar_type *)&t_v[oLayoutMap(l2s_t,odx_t)];
       for(int w=0;w<words;w++){
 	tp[idx_t+w*Nsimd] = fp[idx_f+w*Nsimd];  // FIXME IF RRII layout, type pun no worke
       }
@@ -1080,54 +1160,115 @@ vectorizeFromRevLexOrdArray( std::vector<sobj> &in, Lattice<vobj> &out)
   });
 }
 
-//Convert a Lattice from one precision to another
-template<class VobjOut, class VobjIn>
-void precisionChange(Lattice<VobjOut> &out, const Lattice<VobjIn> &in)
-{
-  assert(out.Grid()->Nd() == in.Grid()->Nd());
-  for(int d=0;d<out.Grid()->Nd();d++){
-    assert(out.Grid()->FullDimensions()[d] == in.Grid()->FullDimensions()[d]);
-  }
-  out.Checkerboard() = in.Checkerboard();
-  GridBase *in_grid=in.Grid();
-  GridBase *out_grid = out.Grid();
+////////////////////////////////////////////////////////////////////////////////
+// Precision change works directly between the two SIMD layouts.
+// The map from (out osite, out lane) to (in osite, in lane) depends only on
+// the geometry of the two grids; it is built once and cached so that repeated
+// conversions (e.g. every outer iteration of a mixed precision solver) reduce
+// to a single lane copy kernel with no scalar intermediate.
+////////////////////////////////////////////////////////////////////////////////
+class precisionChangeWorkspace {
+public:
+  typedef std::pair<Integer,Integer> LaneIndex;
+private:
+  Vector<LaneIndex> fmap;
+  int out_nsimd;
+public:
+  precisionChangeWorkspace(GridBase *out_grid, GridBase *in_grid)
+  {
+    int ndim = out_grid->Nd();
+    assert(ndim == in_grid->Nd());
+    for(int d=0;d<ndim;d++){
+      assert(out_grid->FullDimensions()[d] == in_grid->FullDimensions()[d]);
+      assert(out_grid->_ldimensions[d]     == in_grid->_ldimensions[d]);
+    }
+    out_nsimd = out_grid->Nsimd();
 
-  typedef typename VobjOut::scalar_object SobjOut;
-  typedef typename VobjIn::scalar_object SobjIn;
+    std::vector<Coordinate> out_icoor(out_nsimd);
+    for(int lane=0; lane < out_nsimd; lane++){
+      out_grid->iCoorFromIindex(out_icoor[lane], lane);
+    }
 
-  int ndim = out.Grid()->Nd();
-  int out_nsimd = out_grid->Nsimd();
-    
-  std::vector<Coordinate > out_icoor(out_nsimd);
-      
-  for(int lane=0; lane < out_nsimd; lane++){
-    out_icoor[lane].resize(ndim);
-    out_grid->iCoorFromIindex(out_icoor[lane], lane);
+    fmap.resize(out_grid->lSites());
+    thread_for(out_oidx,out_grid->oSites(),{
+      Coordinate out_ocoor(ndim);
+      Coordinate lcoor(ndim);
+      out_grid->oCoorFromOindex(out_ocoor, out_oidx);
+      for(int out_lane=0; out_lane < out_nsimd; out_lane++){
+	out_grid->InOutCoorToLocalCoor(out_ocoor, out_icoor[out_lane], lcoor);
+	// oIndex/iIndex are defined on full lattice coordinates; on a checkerboarded
+	// grid the reduced coordinate must be split directly with the in grid strides
+	Integer in_oidx = 0;
+	Integer in_lane = 0;
+	for(int d=0;d<ndim;d++){
+	  in_oidx += in_grid->_ostride[d] * ( lcoor[d] % in_grid->_rdimensions[d] );
+	  in_lane += in_grid->_istride[d] * ( lcoor[d] / in_grid->_rdimensions[d] );
+	}
+	in_oidx = in_grid->oIndexFromLex(in_oidx);
+	fmap[out_lane + out_nsimd*out_oidx] = LaneIndex(in_oidx,in_lane);
+      }
+    });
   }
-        
-  std::vector<SobjOut> in_slex_conv(in_grid->lSites());
-  unvectorizeToLexOrdArray(in_slex_conv, in);
-    
-  autoView( out_v , out, CpuWrite);
-  thread_for(out_oidx,out_grid->oSites(),{
-    Coordinate out_ocoor(ndim);
-    out_grid->oCoorFromOindex(out_ocoor, out_oidx);
+  const LaneIndex *Map(void) const { return &fmap[0]; }
+  int Nsimd(void) const { return out_nsimd; }
 
-    ExtractPointerArray<SobjOut> ptrs(out_nsimd);      
+  // One workspace per geometry pair; keyed on geometry rather than GridBase
+  // pointer so that a recycled grid address can never alias a stale map.
+  static precisionChangeWorkspace &Get(GridBase *out_grid, GridBase *in_grid)
+  {
+    static std::map<std::vector<int>,precisionChangeWorkspace *> cache;
+    std::vector<int> key;
+    GridBase *grids[2] = { out_grid, in_grid };
+    for(int g=0;g<2;g++){
+      for(int d=0;d<grids[g]->Nd();d++){
+	key.push_back(grids[g]->_ldimensions[d]);
+	key.push_back(grids[g]->_rdimensions[d]);
+	key.push_back(grids[g]->_simd_layout[d]);
+      }
+      key.push_back(grids[g]->_site_layout);
+      key.push_back(grids[g]->_site_layout_block);
+      key.push_back(grids[g]->_site_layout_inner);
+    }
+    auto it = cache.find(key);
+    if ( it != cache.end() ) return *it->second;
+    precisionChangeWorkspace *ws = new precisionChangeWorkspace(out_grid,in_grid);
+    cache[key] = ws;
+    return *ws;
+  }
+};
 
-    Coordinate lcoor(out_grid->Nd());
-      
-    for(int lane=0; lane < out_nsimd; lane++){
-      for(int mu=0;mu<ndim;mu++)
-	lcoor[mu] = out_ocoor[mu] + out_grid->_rdimensions[mu]*out_icoor[lane][mu];
-	
-      int llex; Lexicographic::IndexFromCoor(lcoor, llex, out_grid->_ldimensions);
-      ptrs[lane] = &in_slex_conv[llex];
+//Convert a Lattice from one precision to another using a precomputed lane map
+template<class VobjOut, class VobjIn>
+void precisionChange(Lattice<VobjOut> &out, const Lattice<VobjIn> &in, const precisionChangeWorkspace &workspace)
+{
+  constexpr int Nsimd_out = VobjOut::Nsimd();
+  assert(workspace.Nsimd() == Nsimd_out);
+  assert(out.Grid()->lSites() == in.Grid()->lSites());
+
+  out.Checkerboard() = in.Checkerboard();
+
+  const precisionChangeWorkspace::LaneIndex *fmap = workspace.Map();
+
+  autoView( out_v , out, AcceleratorWrite);
+  autoView( in_v  , in , AcceleratorRead);
+  accelerator_for(out_oidx,out.Grid()->oSites(),1,{
+    const precisionChangeWorkspace::LaneIndex *fmap_osite = fmap + out_oidx*Nsimd_out;
+    for(int out_lane=0; out_lane < Nsimd_out; out_lane++){
+      int in_oidx = fmap_osite[out_lane].first;
+      int in_lane = fmap_osite[out_lane].second;
+      copyLane(out_v[out_oidx], out_lane, in_v[in_oidx], in_lane);
     }
-    merge(out_v[out_oidx], ptrs, 0);
   });
 }
 
+//Convert a Lattice from one precision to another
+template<class VobjOut, class VobjIn>
+void precisionChange(Lattice<VobjOut> &out, const Lattice<VobjIn> &in)
+{
+  precisionChangeWorkspace &workspace = precisionChangeWorkspace::Get(out.Grid(),in.Grid());
+  precisionChange(out,in,workspace);
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 // Communicate between grids
 ////////////////////////////////////////////////////////////////////////////////
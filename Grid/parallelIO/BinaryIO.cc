@@ -2,3 +2,11 @@
 
 int                    Grid::BinaryIO::latticeWriteMaxRetry = -1;
 Grid::BinaryIO::IoPerf Grid::BinaryIO::lastPerf;
+int                    Grid::BinaryIO::asyncWrite = 0;
+int                    Grid::BinaryIOAsyncEngine::Threads = 1;
+int                    Grid::BinaryIO::useCrc32c = 0;
+uint32_t               Grid::BinaryIO::lastCrc32c = 0;
+int                    Grid::BinaryIO::mmapRead = 0;
+Grid::BinaryIO::IoPerf Grid::CompressedIO::lastPerf;
+double                 Grid::CompressedIO::lastRatio = 0.0;
+int                    Grid::BinaryIO::aggregation = 0;
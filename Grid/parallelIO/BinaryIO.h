@@ -40,6 +40,15 @@
 
 #include <arpa/inet.h>
 #include <algorithm>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <deque>
+#include <mutex>
+#include <condition_variable>
+#include <thread>
+#include <atomic>
 
 NAMESPACE_BEGIN(Grid);
 
@@ -73,6 +82,154 @@ inline void removeWhitespace(std::string &key)
   key.erase(std::remove_if(key.begin(), key.end(), ::isspace),key.end());
 }
 
+///////////////////////////////////////////////////////////////////////////////////////////////////
+// Background writer for BinaryIO. Jobs run in submission order on one helper
+// thread with its own OpenMP team of Threads threads. At most MaxPending
+// staging buffers are alive; a further Submit blocks until the oldest has
+// drained (double buffering).
+//
+// MPI is initialised MPI_THREAD_SERIALIZED so the helper only does POSIX
+// I/O; global checksum reductions happen in the caller's wait().
+///////////////////////////////////////////////////////////////////////////////////////////////////
+class BinaryIOAsyncEngine {
+public:
+  static const int MaxPending = 2;
+  static int Threads;
+
+  static BinaryIOAsyncEngine & Instance(void) {
+    static BinaryIOAsyncEngine engine;
+    return engine;
+  }
+
+  void Submit(std::function<void(void)> job)
+  {
+    std::unique_lock<std::mutex> lock(mtx);
+    cv_done.wait(lock,[this]{ return pending < MaxPending; });
+    pending++;
+    jobs.push_back(job);
+    cv_work.notify_one();
+  }
+
+  ~BinaryIOAsyncEngine()
+  {
+    {
+      std::lock_guard<std::mutex> lock(mtx);
+      stop = 1;
+    }
+    cv_work.notify_one();
+    worker.join();
+  }
+
+private:
+  std::thread worker;
+  std::mutex mtx;
+  std::condition_variable cv_work;
+  std::condition_variable cv_done;
+  std::deque<std::function<void(void)> > jobs;
+  int pending;
+  int stop;
+
+  BinaryIOAsyncEngine() : pending(0), stop(0)
+  {
+    worker = std::thread([this](){ this->Loop(); });
+  }
+
+  void Loop(void)
+  {
+#ifdef GRID_OMP
+    omp_set_num_threads(Threads);
+#endif
+    while(1) {
+      std::function<void(void)> job;
+      {
+	std::unique_lock<std::mutex> lock(mtx);
+	cv_work.wait(lock,[this]{ return (!jobs.empty()) || stop; });
+	if ( jobs.empty() ) return; // stop only once drained
+	job = std::move(jobs.front());
+	jobs.pop_front();
+      }
+      job();
+      job = nullptr; // release the staging buffers before signalling
+      {
+	std::lock_guard<std::mutex> lock(mtx);
+	pending--;
+      }
+      cv_done.notify_all();
+    }
+  }
+};
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+// Handle on an asynchronous write. test() is local and never communicates;
+// wait() is collective over the grid: it waits for the local write, combines
+// the checksums over ranks and runs the finaliser (e.g. rewriting a header).
+// The grid must outlive the handle.
+///////////////////////////////////////////////////////////////////////////////////////////////////
+class BinaryIOAsyncHandle {
+public:
+  typedef std::function<void(uint32_t,uint32_t,uint32_t)> Finaliser;
+  struct State {
+    std::atomic<int> done{0};
+    GridBase *grid{nullptr};
+    std::string file;
+    uint32_t nersc_csum{0}, scidac_csuma{0}, scidac_csumb{0}, crc32c_csum{0};
+    uint64_t bytes{0};
+    double   iotime{0}, bstime{0};
+    int      ok{1};
+    Finaliser finalise;
+  };
+
+  BinaryIOAsyncHandle() {};
+  BinaryIOAsyncHandle(std::shared_ptr<State> _state) : state(_state) {};
+
+  int valid(void) const { return state!=nullptr; }
+  int test(void)  const { return (!state) || state->done.load(std::memory_order_acquire); }
+  uint32_t crc32c(void) const { return crc32c_csum; } // valid after wait() when BinaryIO::useCrc32c
+
+  void wait(void) { uint32_t n,a,b; wait(n,a,b); }
+  void wait(uint32_t &nersc_csum,uint32_t &scidac_csuma,uint32_t &scidac_csumb)
+  {
+    nersc_csum=scidac_csuma=scidac_csumb=0;
+    if ( !state ) return;
+    GridStopWatch timer; timer.Start();
+    while ( !test() ) std::this_thread::yield();
+    timer.Stop();
+
+    GridBase *grid = state->grid;
+    nersc_csum   = state->nersc_csum;
+    scidac_csuma = state->scidac_csuma;
+    scidac_csumb = state->scidac_csumb;
+    crc32c_csum  = state->crc32c_csum;
+    uint32_t ok = state->ok;
+    grid->GlobalSum(nersc_csum);
+    grid->GlobalXOR(scidac_csuma);
+    grid->GlobalXOR(scidac_csumb);
+    grid->GlobalXOR(crc32c_csum);
+    grid->GlobalSum(ok);
+    if ( ok != (uint32_t)grid->ProcessorCount() ) {
+      std::cout << GridLogError << "Asynchronous write of "<<state->file<<" failed on "
+		<< grid->ProcessorCount()-ok<<" rank(s)"<<std::endl;
+#ifdef USE_MPI_IO
+      MPI_Abort(MPI_COMM_WORLD,1);
+#else
+      exit(1);
+#endif
+    }
+    uint64_t bytes = state->bytes;
+    grid->GlobalSum(bytes);
+    std::cout<<GridLogMessage<<"IOobject: async write "<<state->file<<" "<<bytes<<" bytes; "
+	     <<state->iotime/1.0e3<<" ms I/O and "<<state->bstime/1.0e3<<" ms endian and checksum in background; "
+	     <<timer.useconds()/1.0e3<<" ms exposed in wait"<<std::endl;
+    if ( state->finalise ) state->finalise(nersc_csum,scidac_csuma,scidac_csumb);
+    grid->Barrier(); // header rewritten before any rank reopens the file
+    state = nullptr;
+  }
+
+private:
+  std::shared_ptr<State> state;
+  uint32_t crc32c_csum{0};
+};
+
 ///////////////////////////////////////////////////////////////////////////////////////////////////
 // Static class holding the parallel IO code
 // Could just use a namespace
@@ -83,26 +240,46 @@ class BinaryIO {
   {
     uint64_t size{0},time{0};
     double   mbytesPerSecond{0.};
+    uint64_t aggregators{0},requests{0}; // aggregated I/O only
   };
 
   static IoPerf lastPerf;
   static int latticeWriteMaxRetry;
+  static int asyncWrite; // checkpointers write configurations in the background
+  static int useCrc32c;  // also accumulate a Castagnoli crc alongside the SciDAC checksum
+  static int mmapRead;   // readLatticeObject decodes straight from a mapping of the file
+  static int aggregation;// 0: every rank does I/O; n>0: one rank in n; -1: one rank per node
+  static uint32_t lastCrc32c;
 
   /////////////////////////////////////////////////////////////////////////////
   // more byte manipulation helpers
   /////////////////////////////////////////////////////////////////////////////
 
+  // The NERSC sum is order independent, so it runs straight over the SIMD
+  // layout: every 32 bit word of every lane belongs to exactly one site.
   template<class vobj> static inline void Uint32Checksum(Lattice<vobj> &lat,uint32_t &nersc_csum)
   {
-    typedef typename vobj::scalar_object sobj;
-
     GridBase *grid = lat.Grid();
-    uint64_t lsites = grid->lSites();
-
-    std::vector<sobj> scalardata(lsites); 
-    unvectorizeToLexOrdArray(scalardata,lat);    
+    const uint64_t size32 = sizeof(vobj) / sizeof(uint32_t);
+    uint64_t osites = grid->oSites();
 
-    NerscChecksum(grid,scalardata,nersc_csum);
+    autoView(lat_v,lat,CpuRead);
+    thread_region
+    {
+      uint32_t nersc_csum_thr = 0;
+      thread_for_in_region( ss, osites, 
+      {
+        uint32_t *site_buf = (uint32_t *)&lat_v[ss];
+        for (uint64_t j = 0; j < size32; j++)
+        {
+          nersc_csum_thr = nersc_csum_thr + site_buf[j];
+        }
+      });
+      thread_critical
+      {
+        nersc_csum += nersc_csum_thr;
+      }
+    }
   }
 
   template <class fobj>
@@ -181,8 +358,8 @@ class BinaryIO {
 	site_crc = crc32(0,(unsigned char *)site_buf,sizeof(fobj));
 	//	std::cout << "Site "<<local_site << " crc "<<std::hex<<site_crc<<std::dec<<std::endl;
 	//	std::cout << "Site "<<local_site << std::hex<<site_buf[0] <<site_buf[1]<<std::dec <<std::endl;
-	scidac_csuma_thr ^= site_crc<<gsite29 | site_crc>>(32-gsite29);
-	scidac_csumb_thr ^= site_crc<<gsite31 | site_crc>>(32-gsite31);
+	scidac_csuma_thr ^= site_crc<<gsite29 | site_crc>>((32-gsite29)&31);
+	scidac_csumb_thr ^= site_crc<<gsite31 | site_crc>>((32-gsite31)&31);
       });
 
       thread_critical
@@ -193,6 +370,111 @@ class BinaryIO {
     }
   }
 
+  // Per thread checksum and byte order state for the fused pass below
+  struct SiteChecksum {
+    int ieee32big, ieee32, ieee64big, ieee64, crc32c;
+    uint32_t nersc{0}, scidaca{0}, scidacb{0}, castagnoli{0};
+    SiteChecksum(const std::string &format) {
+      ieee32big = (format == std::string("IEEE32BIG"));
+      ieee32    = (format == std::string("IEEE32"));
+      ieee64big = (format == std::string("IEEE64BIG"));
+      ieee64    = (format == std::string("IEEE64") || format == std::string("IEEE64LITTLE"));
+      crc32c    = useCrc32c;
+    }
+    template<class fobj> inline void swap(fobj &site) {
+      const uint64_t size32 = sizeof(fobj) / sizeof(uint32_t);
+      const uint64_t size64 = sizeof(fobj) / sizeof(uint64_t);
+      uint32_t *site32 = (uint32_t *)&site;
+      uint64_t *site64 = (uint64_t *)&site;
+      if (ieee32big) for(uint64_t j=0;j<size32;j++) site32[j] = ntohl(site32[j]);
+      if (ieee32)    for(uint64_t j=0;j<size32;j++) site32[j] = ntohl(byte_reverse32(site32[j]));
+      if (ieee64big) for(uint64_t j=0;j<size64;j++) site64[j] = Grid_ntohll(site64[j]);
+      if (ieee64)    for(uint64_t j=0;j<size64;j++) site64[j] = Grid_ntohll(byte_reverse64(site64[j]));
+    }
+    template<class fobj> inline void sum(fobj &site) {
+      const uint64_t size32 = sizeof(fobj) / sizeof(uint32_t);
+      uint32_t *site32 = (uint32_t *)&site;
+      for(uint64_t j=0;j<size32;j++) nersc += site32[j];
+    }
+    template<class fobj> inline void crc(fobj &site,uint64_t global_site) {
+      uint32_t gsite29 = global_site%29;
+      uint32_t gsite31 = global_site%31;
+      uint32_t site_crc = GridChecksum::crc32(&site,sizeof(fobj));
+      scidaca ^= site_crc<<gsite29 | site_crc>>((32-gsite29)&31);
+      scidacb ^= site_crc<<gsite31 | site_crc>>((32-gsite31)&31);
+      if ( crc32c ) {
+	uint32_t site_crcc = GridChecksum::crc32c(&site,sizeof(fobj));
+	castagnoli ^= site_crcc<<gsite29 | site_crcc>>((32-gsite29)&31);
+      }
+    }
+    template<class fobj> inline void write(fobj &site,uint64_t global_site) { sum(site); swap(site); crc(site,global_site); }
+    template<class fobj> inline void read (fobj &site,uint64_t global_site) { crc(site,global_site); swap(site); sum(site); }
+    inline void reduce(uint32_t &nersc_csum,uint32_t &scidac_csuma,uint32_t &scidac_csumb,uint32_t &crc32c_csum) {
+      nersc_csum  += nersc;
+      scidac_csuma^= scidaca;
+      scidac_csumb^= scidacb;
+      crc32c_csum ^= castagnoli;
+    }
+  };
+
+  /////////////////////////////////////////////////////////////////////////////
+  // One cache-resident pass per site: NERSC sum on host order words, byte
+  // order conversion, and SciDAC crc32 (plus crc32c when useCrc32c is set)
+  // on file order bytes. Writes sum before swapping and reads after, as the
+  // separate routines above do.
+  /////////////////////////////////////////////////////////////////////////////
+  template<class fobj> static inline void FusedChecksum(GridBase *grid,std::vector<fobj> &fbuf,int control,
+							const std::string &format,
+							uint32_t &nersc_csum,uint32_t &scidac_csuma,uint32_t &scidac_csumb,
+							uint32_t &crc32c_csum)
+  {
+    FusedChecksum(grid,fbuf,control,format,nersc_csum,scidac_csuma,scidac_csumb,crc32c_csum,
+		  [](uint64_t site){});
+  }
+  // siteop(local_site) runs on each site before the checksums on a write and
+  // after them on a read, so a munge can share the same pass over memory.
+  template<class fobj,class SiteOp> static inline void FusedChecksum(GridBase *grid,std::vector<fobj> &fbuf,int control,
+								      const std::string &format,
+								      uint32_t &nersc_csum,uint32_t &scidac_csuma,uint32_t &scidac_csumb,
+								      uint32_t &crc32c_csum,SiteOp siteop)
+  {
+    int write = control & BINARYIO_WRITE;
+    int nd = grid->_ndimension;
+    uint64_t lsites = grid->lSites();
+    if (fbuf.size()==1) {
+      lsites=1;
+    }
+    Coordinate local_vol   =grid->LocalDimensions();
+    Coordinate local_start =grid->LocalStarts();
+    Coordinate global_vol  =grid->FullDimensions();
+
+    thread_region
+    { 
+      Coordinate coor(nd);
+      SiteChecksum csum(format);
+
+      thread_for_in_region( local_site, lsites, 
+      {
+	uint64_t global_site=0;
+	Lexicographic::CoorFromIndex(coor,local_site,local_vol);
+	for(int d=nd-1;d>=0;d--) global_site = global_site*global_vol[d] + coor[d]+local_start[d];
+
+	if ( write ) {
+	  siteop(local_site);
+	  csum.write(fbuf[local_site],global_site);
+	} else {
+	  csum.read(fbuf[local_site],global_site);
+	  siteop(local_site);
+	}
+      });
+
+      thread_critical
+      {
+	csum.reduce(nersc_csum,scidac_csuma,scidac_csumb,crc32c_csum);
+      }
+    }
+  }
+
   // Network is big endian
   static inline void htobe32_v(void *file_object,uint32_t bytes){ be32toh_v(file_object,bytes);} 
   static inline void htobe64_v(void *file_object,uint32_t bytes){ be64toh_v(file_object,bytes);} 
@@ -277,6 +559,7 @@ class BinaryIO {
     nersc_csum=0;
     scidac_csuma=0;
     scidac_csumb=0;
+    uint32_t crc32c_csum=0;
 
     int ndim                 = grid->Dimensions();
     int nrank                = grid->ProcessorCount();
@@ -354,11 +637,26 @@ class BinaryIO {
     //////////////////////////////////////////////////////////////////////////////
     // Do the I/O
     //////////////////////////////////////////////////////////////////////////////
+    lastPerf.aggregators = 0;
+    lastPerf.requests    = 0;
     if ( control & BINARYIO_READ ) { 
 
       timer.Start();
 
-      if ( (control & BINARYIO_LEXICOGRAPHIC) && (nrank > 1) ) {
+      if ( (control & BINARYIO_LEXICOGRAPHIC) && (nrank > 1) && aggregation ) {
+#ifdef USE_MPI_IO
+	std::cout<< GridLogMessage<<"IOobject: aggregated read I/O "<< file<< std::endl;
+	MPI_Type_free(&fileArray);
+	MPI_Type_free(&localArray);
+	int ok = AggregatedIO(grid,BINARYIO_READ,file,offset,(char *)&iodata[0],sizeof(fobj));
+	if ( !ok ) {
+	  std::cout << GridLogError << "Aggregated read of " << file << " failed" << std::endl;
+	  MPI_Abort(MPI_COMM_WORLD,1);
+	}
+#else 
+	assert(0);
+#endif
+      } else if ( (control & BINARYIO_LEXICOGRAPHIC) && (nrank > 1) ) {
 #ifdef USE_MPI_IO
 	std::cout<< GridLogMessage<<"IOobject: MPI read I/O "<< file<< std::endl;
 	ierr=MPI_File_open(grid->communicator,(char *) file.c_str(), MPI_MODE_RDONLY, MPI_INFO_NULL, &fh);    assert(ierr==0);
@@ -392,30 +690,34 @@ class BinaryIO {
       grid->Barrier();
 
       bstimer.Start();
-      ScidacChecksum(grid,iodata,scidac_csuma,scidac_csumb);
-      if (ieee32big) be32toh_v((void *)&iodata[0], sizeof(fobj)*iodata.size());
-      if (ieee32)    le32toh_v((void *)&iodata[0], sizeof(fobj)*iodata.size());
-      if (ieee64big) be64toh_v((void *)&iodata[0], sizeof(fobj)*iodata.size());
-      if (ieee64)    le64toh_v((void *)&iodata[0], sizeof(fobj)*iodata.size());
-      NerscChecksum(grid,iodata,nersc_csum);
+      FusedChecksum(grid,iodata,BINARYIO_READ,format,nersc_csum,scidac_csuma,scidac_csumb,crc32c_csum);
       bstimer.Stop();
     }
     
     if ( control & BINARYIO_WRITE ) { 
 
       bstimer.Start();
-      NerscChecksum(grid,iodata,nersc_csum);
-      if (ieee32big) htobe32_v((void *)&iodata[0], sizeof(fobj)*iodata.size());
-      if (ieee32)    htole32_v((void *)&iodata[0], sizeof(fobj)*iodata.size());
-      if (ieee64big) htobe64_v((void *)&iodata[0], sizeof(fobj)*iodata.size());
-      if (ieee64)    htole64_v((void *)&iodata[0], sizeof(fobj)*iodata.size());
-      ScidacChecksum(grid,iodata,scidac_csuma,scidac_csumb);
+      FusedChecksum(grid,iodata,BINARYIO_WRITE,format,nersc_csum,scidac_csuma,scidac_csumb,crc32c_csum);
       bstimer.Stop();
 
       grid->Barrier();
 
       timer.Start();
-      if ( (control & BINARYIO_LEXICOGRAPHIC) && (nrank > 1) ) {
+      if ( (control & BINARYIO_LEXICOGRAPHIC) && (nrank > 1) && aggregation ) {
+#ifdef USE_MPI_IO
+        std::cout << GridLogMessage <<"IOobject: aggregated write I/O " << file << std::endl;
+	MPI_Type_free(&fileArray);
+	MPI_Type_free(&localArray);
+	int ok = AggregatedIO(grid,BINARYIO_WRITE,file,offset,(char *)&iodata[0],sizeof(fobj));
+	if ( !ok ) {
+	  std::cout << GridLogError << "Aggregated write of " << file << " failed" << std::endl;
+	  MPI_Abort(MPI_COMM_WORLD,1);
+	}
+	offset = offset + sizeof(fobj)*lsites*nrank;
+#else 
+	assert(0);
+#endif
+      } else if ( (control & BINARYIO_LEXICOGRAPHIC) && (nrank > 1) ) {
 #ifdef USE_MPI_IO
         std::cout << GridLogMessage <<"IOobject: MPI write I/O " << file << std::endl;
         ierr = MPI_File_open(grid->communicator, (char *)file.c_str(), MPI_MODE_RDWR | MPI_MODE_CREATE, MPI_INFO_NULL, &fh);
@@ -530,8 +832,10 @@ class BinaryIO {
       grid->GlobalSum(nersc_csum);
       grid->GlobalXOR(scidac_csuma);
       grid->GlobalXOR(scidac_csumb);
+      grid->GlobalXOR(crc32c_csum);
       grid->Barrier();
     }
+    lastCrc32c = crc32c_csum;
   }
 
   /////////////////////////////////////////////////////////////////////////////
@@ -553,6 +857,11 @@ class BinaryIO {
     GridBase *grid = Umu.Grid();
     uint64_t lsites = grid->lSites();
 
+    if ( mmapRead && !grid->_isCheckerBoarded ) {
+      readLatticeObjectMmap<vobj,fobj>(Umu,file,munge,offset,format,nersc_csum,scidac_csuma,scidac_csumb);
+      return;
+    }
+
     std::vector<sobj> scalardata(lsites); 
     std::vector<fobj>     iodata(lsites); // Munge, checksum, byte order in here
     
@@ -571,6 +880,114 @@ class BinaryIO {
     std::cout<<GridLogMessage<<"readLatticeObject: vectorize overhead "<<timer.Elapsed()  <<std::endl;
   }
 
+  /////////////////////////////////////////////////////////////////////////////
+  // Read a Lattice of object through a read-only mapping of the file. Each
+  // thread owns whole SIMD objects: it gathers the lanes of an outer site
+  // from the mapping, checksums and byte swaps them in a stack copy, munges
+  // and stores them. Nothing larger than one site is ever staged, so peak
+  // memory is the field itself plus whatever pages the kernel caches.
+  // Every rank maps the file, so this needs a node-local or shared
+  // filesystem; checkerboarded grids use the staged reader above.
+  //////////////////////////////////////////////////////////////////////////////////////
+  template<class vobj,class fobj,class munger>
+  static inline void readLatticeObjectMmap(Lattice<vobj> &Umu,
+					   std::string file,
+					   munger munge,
+					   uint64_t offset,
+					   const std::string &format,
+					   uint32_t &nersc_csum,
+					   uint32_t &scidac_csuma,
+					   uint32_t &scidac_csumb)
+  {
+    typedef typename vobj::scalar_object sobj;
+    typedef typename vobj::scalar_type scalar_type;
+
+    GridBase *grid = Umu.Grid();
+    assert(!grid->_isCheckerBoarded);
+
+    nersc_csum=0;
+    scidac_csuma=0;
+    scidac_csumb=0;
+    uint32_t crc32c_csum=0;
+
+    int nd      = grid->_ndimension;
+    int Nsimd   = grid->Nsimd();
+    int nrank   = grid->ProcessorCount();
+    uint64_t osites = grid->oSites();
+    uint64_t lsites = grid->lSites();
+    Coordinate local_start =grid->LocalStarts();
+    Coordinate global_vol  =grid->FullDimensions();
+    uint64_t gsites = 1;
+    for(int d=0;d<nd;d++) gsites *= global_vol[d];
+
+    GridStopWatch timer; 
+    timer.Start();
+
+    int fd = open(file.c_str(),O_RDONLY);
+    assert(fd >= 0);
+    struct stat st;
+    int rc = fstat(fd,&st);
+    if ( rc != 0 ) {
+      std::cout << GridLogError << "readLatticeObjectMmap: fstat failed on "<<file<<" : "<<strerror(errno)<<std::endl;
+      exit(1);
+    }
+    uint64_t length = offset + gsites*sizeof(fobj);
+    assert((uint64_t)st.st_size >= length);
+    void *map = mmap(nullptr,length,PROT_READ,MAP_PRIVATE,fd,0);
+    close(fd);
+    assert(map != MAP_FAILED);
+    if ( nrank==1 ) madvise(map,length,MADV_SEQUENTIAL);
+    const char *base = (const char *)map + offset;
+
+    {
+      autoView(Umu_v,Umu,CpuWrite);
+      thread_region
+      {
+	Coordinate ocoor(nd), icoor(nd), lcoor(nd);
+	SiteChecksum csum(format);
+	thread_for_in_region( ss, osites,
+        {
+	  grid->oCoorFromOindex(ocoor,ss);
+	  scalar_type *vp = (scalar_type *)&Umu_v[ss];
+	  for(int lane=0;lane<Nsimd;lane++){
+	    grid->iCoorFromIindex(icoor,lane);
+	    grid->InOutCoorToLocalCoor(ocoor,icoor,lcoor);
+	    uint64_t global_site=0;
+	    for(int d=nd-1;d>=0;d--) global_site = global_site*global_vol[d] + lcoor[d]+local_start[d];
+
+	    fobj fsite;
+	    sobj ssite;
+	    memcpy(&fsite,base+global_site*sizeof(fobj),sizeof(fobj));
+	    csum.read(fsite,global_site);
+	    munge(fsite,ssite);
+
+	    scalar_type *pt = (scalar_type *)&ssite;
+	    for(int w=0;w<sizeof(sobj)/sizeof(scalar_type);w++) vp[lane+w*Nsimd] = pt[w];
+	  }
+        });
+	thread_critical
+	{
+	  csum.reduce(nersc_csum,scidac_csuma,scidac_csumb,crc32c_csum);
+	}
+      }
+    }
+    munmap(map,length);
+    timer.Stop();
+
+    lastPerf.size            = sizeof(fobj)*lsites*nrank;
+    lastPerf.time            = timer.useconds();
+    lastPerf.mbytesPerSecond = lastPerf.size/1024./1024./(lastPerf.time/1.0e6);
+    std::cout<<GridLogMessage<<"readLatticeObjectMmap: read "<< lastPerf.size <<" bytes in "<< timer.Elapsed() <<" "
+	     << lastPerf.mbytesPerSecond <<" MB/s including endian, checksum and vectorize"<<std::endl;
+
+    grid->Barrier();
+    grid->GlobalSum(nersc_csum);
+    grid->GlobalXOR(scidac_csuma);
+    grid->GlobalXOR(scidac_csumb);
+    grid->GlobalXOR(crc32c_csum);
+    lastCrc32c = crc32c_csum;
+  }
+
   /////////////////////////////////////////////////////////////////////////////
   // Write a Lattice of object
   //////////////////////////////////////////////////////////////////////////////////////
@@ -638,6 +1055,258 @@ class BinaryIO {
     std::cout<<GridLogMessage<<"writeLatticeObject: unvectorize overhead "<<timer.Elapsed()  <<std::endl;
   }
   
+  /////////////////////////////////////////////////////////////////////////////
+  // This rank's block of a lexicographic file with positioned POSIX I/O:
+  // one call per contiguous run of sites, no communication.
+  //////////////////////////////////////////////////////////////////////////////////////
+  /////////////////////////////////////////////////////////////////////////////
+  // Contiguous runs of one rank's slab in a lexicographic file: dimensions held
+  // entirely on the rank, plus the first split one, are contiguous.
+  /////////////////////////////////////////////////////////////////////////////
+  struct FileRun { uint64_t file, buf, bytes; };
+  static inline void LexicographicRuns(std::vector<FileRun> &runs,uint64_t offset,uint64_t bufoffset,uint64_t objbytes,
+				       const Coordinate &gLattice,const Coordinate &lLattice,const Coordinate &pcoor)
+  {
+    int ndim = gLattice.size();
+    int k=0;
+    while ( (k<ndim-1) && (lLattice[k]==gLattice[k]) ) k++;
+    uint64_t run=1;
+    Coordinate outer(ndim);
+    for(int d=0;d<ndim;d++){
+      if ( d<=k ) { run*= lLattice[d]; outer[d]=1; }
+      else        { outer[d]=lLattice[d]; }
+    }
+    uint64_t nrun=1;
+    for(int d=0;d<ndim;d++) nrun*=outer[d];
+
+    Coordinate rcoor(ndim);
+    for(uint64_t r=0;r<nrun;r++){
+      Lexicographic::CoorFromIndex(rcoor,r,outer);
+      uint64_t gidx=0;
+      for(int d=ndim-1;d>=0;d--) gidx = gidx*gLattice[d] + rcoor[d]+lLattice[d]*pcoor[d];
+      runs.push_back({offset + gidx*objbytes, bufoffset + r*run*objbytes, run*objbytes});
+    }
+  }
+  static inline int PosixTransfer(int fd,int control,char *ptr,uint64_t left,off_t where)
+  {
+    while ( left ) {
+      ssize_t n = (control & BINARYIO_WRITE) ? pwrite(fd,ptr,left,where) : pread(fd,ptr,left,where);
+      if ( n <= 0 ) return 0;
+      ptr+=n; left-=n; where+=n;
+    }
+    return 1;
+  }
+
+  // Files are opened without O_TRUNC, as the header before offset is already
+  // written; a writer cuts the file at the end of the payload instead, so an
+  // overwritten larger file leaves no stale tail. Every writer sets the same
+  // length, so the order in which ranks get here does not matter.
+  static inline int PosixOpen(int control,const std::string &file,uint64_t offset,
+			      uint64_t objbytes,const Coordinate &gLattice)
+  {
+    if ( !(control & BINARYIO_WRITE) ) return open(file.c_str(),O_RDONLY);
+    int fd = open(file.c_str(),O_WRONLY|O_CREAT,0644);
+    if ( fd < 0 ) return fd;
+    uint64_t gsites=1;
+    for(int d=0;d<gLattice.size();d++) gsites*=gLattice[d];
+    if ( ftruncate(fd,offset+gsites*objbytes) != 0 ) {
+      close(fd);
+      return -1;
+    }
+    return fd;
+  }
+
+  static inline int PosixLexicographicIO(int control,const std::string &file,uint64_t offset,
+					 char *data,uint64_t objbytes,
+					 const Coordinate &gLattice,const Coordinate &lLattice,const Coordinate &pcoor)
+  {
+    int fd = PosixOpen(control,file,offset,objbytes,gLattice);
+    if ( fd < 0 ) return 0;
+
+    std::vector<FileRun> runs;
+    LexicographicRuns(runs,offset,0,objbytes,gLattice,lLattice,pcoor);
+    int ok=1;
+    for(uint64_t r=0;(r<runs.size())&&ok;r++){
+      ok = PosixTransfer(fd,control,data+runs[r].buf,runs[r].bytes,runs[r].file);
+    }
+    close(fd);
+    return ok;
+  }
+
+#ifdef USE_MPI_IO
+  /////////////////////////////////////////////////////////////////////////////
+  // Aggregated I/O: ranks are grouped (one group per node, or runs of
+  // "aggregation" consecutive ranks) and the first rank of each group gathers
+  // the group's slabs, merges runs that are adjacent in the file and issues
+  // one request per merged extent. Only the aggregators touch the filesystem.
+  /////////////////////////////////////////////////////////////////////////////
+  static inline int AggregatedIO(GridBase *grid,int control,const std::string &file,uint64_t offset,
+				 char *data,uint64_t objbytes)
+  {
+    int ndim = grid->_ndimension;
+    Coordinate gLattice = grid->GlobalDimensions();
+    Coordinate lLattice = grid->LocalDimensions();
+    Coordinate pcoor    = grid->ThisProcessorCoor();
+    uint64_t   lsites   = grid->lSites();
+    uint64_t   bytes    = lsites*objbytes;
+
+    int color = (aggregation<0) ? GlobalSharedMemory::WorldNode : grid->ThisRank()/aggregation;
+    MPI_Comm agg;
+    MPI_Comm_split(grid->communicator,color,grid->ThisRank(),&agg);
+    int arank, asize;
+    MPI_Comm_rank(agg,&arank);
+    MPI_Comm_size(agg,&asize);
+
+    MPI_Datatype site;
+    MPI_Type_contiguous(objbytes,MPI_BYTE,&site);
+    MPI_Type_commit(&site);
+
+    std::vector<int>  coors(arank==0 ? asize*ndim : 1);
+    std::vector<char> slab (arank==0 ? asize*bytes : 1);
+    MPI_Gather(&pcoor[0],ndim,MPI_INT,&coors[0],ndim,MPI_INT,0,agg);
+    if ( control & BINARYIO_WRITE ) {
+      MPI_Gather(data,lsites,site,&slab[0],lsites,site,0,agg);
+    }
+
+    int ok=1;
+    uint64_t requests=0;
+    if ( arank==0 ) {
+      std::vector<FileRun> runs;
+      Coordinate mcoor(ndim);
+      for(int m=0;m<asize;m++){
+	for(int d=0;d<ndim;d++) mcoor[d] = coors[m*ndim+d];
+	LexicographicRuns(runs,offset,m*bytes,objbytes,gLattice,lLattice,mcoor);
+      }
+      std::sort(runs.begin(),runs.end(),[](const FileRun &a,const FileRun &b){ return a.file<b.file; });
+
+      int fd = PosixOpen(control,file,offset,objbytes,gLattice);
+      ok = (fd>=0);
+      std::vector<char> stage;
+      for(uint64_t i=0;(i<runs.size())&&ok;){
+	uint64_t j=i, extent=runs[i].bytes;
+	int inplace=1;
+	while ( (j+1<runs.size()) && (runs[j+1].file==runs[j].file+runs[j].bytes) ) {
+	  inplace = inplace && (runs[j+1].buf==runs[j].buf+runs[j].bytes);
+	  j++;
+	  extent+=runs[j].bytes;
+	}
+	char *ptr = &slab[runs[i].buf];
+	if ( !inplace ) {
+	  stage.resize(extent);
+	  ptr = &stage[0];
+	  if ( control & BINARYIO_WRITE ) {
+	    for(uint64_t r=i,o=0;r<=j;o+=runs[r].bytes,r++) memcpy(ptr+o,&slab[runs[r].buf],runs[r].bytes);
+	  }
+	}
+	ok = PosixTransfer(fd,control,ptr,extent,runs[i].file);
+	if ( ok && !inplace && (control & BINARYIO_READ) ) {
+	  for(uint64_t r=i,o=0;r<=j;o+=runs[r].bytes,r++) memcpy(&slab[runs[r].buf],ptr+o,runs[r].bytes);
+	}
+	requests++;
+	i=j+1;
+      }
+      if ( fd>=0 ) close(fd);
+    }
+    MPI_Bcast(&ok,1,MPI_INT,0,agg);
+    if ( ok && (control & BINARYIO_READ) ) {
+      MPI_Scatter(&slab[0],lsites,site,data,lsites,site,0,agg);
+    }
+    MPI_Type_free(&site);
+    MPI_Comm_free(&agg);
+
+    uint64_t aggregators = (arank==0);
+    grid->GlobalSum(aggregators);
+    grid->GlobalSum(requests);
+    lastPerf.aggregators = aggregators;
+    lastPerf.requests    = requests;
+    std::cout<<GridLogMessage<<"IOobject: "<<aggregators<<" aggregator rank(s) issued "<<requests
+	     <<" request(s) for "<<file<<std::endl;
+    return ok;
+  }
+#endif
+
+  /////////////////////////////////////////////////////////////////////////////
+  // Write a Lattice of object in the background. The field is snapshot into a
+  // staging buffer before returning; munge, checksum, byte order and the write
+  // complete on the BinaryIOAsyncEngine thread. With latticeWriteMaxRetry>=0
+  // each rank reads its block back and rewrites on mismatch.
+  //////////////////////////////////////////////////////////////////////////////////////
+  template<class vobj,class fobj,class munger>
+  static inline BinaryIOAsyncHandle writeLatticeObjectAsync(Lattice<vobj> &Umu,
+							    std::string file,
+							    munger munge,
+							    uint64_t offset,
+							    const std::string &format,
+							    BinaryIOAsyncHandle::Finaliser finalise = nullptr)
+  {
+    typedef typename vobj::scalar_object sobj;
+    GridBase *grid = Umu.Grid();
+    uint64_t lsites = grid->lSites();
+
+    int ieee32big = (format == std::string("IEEE32BIG"));
+    int ieee32    = (format == std::string("IEEE32"));
+    int ieee64big = (format == std::string("IEEE64BIG"));
+    int ieee64    = (format == std::string("IEEE64") || format == std::string("IEEE64LITTLE"));
+    assert((ieee64+ieee32+ieee64big+ieee32big)==1);
+
+    GridStopWatch timer; timer.Start();
+    auto scalardata = std::make_shared<std::vector<sobj> >(lsites);
+    unvectorizeToLexOrdArray(*scalardata,Umu);
+    timer.Stop();
+    std::cout<<GridLogMessage<<"writeLatticeObjectAsync: snapshot "<<file<<" in "<<timer.Elapsed()<<std::endl;
+
+    auto state = std::make_shared<BinaryIOAsyncHandle::State>();
+    state->grid     = grid;
+    state->file     = file;
+    state->finalise = finalise;
+    state->bytes    = lsites*sizeof(fobj);
+
+    Coordinate gLattice = grid->GlobalDimensions();
+    Coordinate lLattice = grid->LocalDimensions();
+    Coordinate pcoor    = grid->ThisProcessorCoor();
+    int retries = latticeWriteMaxRetry;
+
+    // Preparation of the file by any rank (e.g. truncation) completes before a background write starts
+    grid->Barrier();
+    BinaryIOAsyncEngine::Instance().Submit([=]() mutable {
+      GridStopWatch bstimer, iotimer;
+      std::shared_ptr<std::vector<sobj> > sdata = scalardata;
+      scalardata = nullptr;
+
+      bstimer.Start();
+      std::vector<fobj> iodata(lsites);
+      uint32_t nersc_csum=0, scidac_csuma=0, scidac_csumb=0, crc32c_csum=0;
+      std::vector<sobj> &sref = *sdata;
+      FusedChecksum(grid,iodata,BINARYIO_WRITE,format,nersc_csum,scidac_csuma,scidac_csumb,crc32c_csum,
+		    [&](uint64_t x){ munge(sref[x],iodata[x]); });
+      sdata = nullptr;
+      bstimer.Stop();
+
+      iotimer.Start();
+      int attempts = std::max(0,retries);
+      int ok;
+      do {
+	ok = PosixLexicographicIO(BINARYIO_WRITE,file,offset,(char *)&iodata[0],sizeof(fobj),gLattice,lLattice,pcoor);
+	if ( ok && (retries>=0) ) {
+	  std::vector<fobj> ckiodata(lsites);
+	  ok = PosixLexicographicIO(BINARYIO_READ,file,offset,(char *)&ckiodata[0],sizeof(fobj),gLattice,lLattice,pcoor);
+	  ok = ok && (memcmp(&ckiodata[0],&iodata[0],lsites*sizeof(fobj))==0);
+	}
+      } while ( (!ok) && (attempts--) > 0 );
+      iotimer.Stop();
+
+      state->nersc_csum   = nersc_csum;
+      state->scidac_csuma = scidac_csuma;
+      state->scidac_csumb = scidac_csumb;
+      state->crc32c_csum  = crc32c_csum;
+      state->ok     = ok;
+      state->iotime = iotimer.useconds();
+      state->bstime = bstimer.useconds();
+      state->done.store(1,std::memory_order_release);
+    });
+    return BinaryIOAsyncHandle(state);
+  }
+
   /////////////////////////////////////////////////////////////////////////////
   // Read a RNG;  use IOobject and lexico map to an array of state 
   //////////////////////////////////////////////////////////////////////////////////////
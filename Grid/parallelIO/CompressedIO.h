@@ -0,0 +1,512 @@
+/*************************************************************************************
+
+    Grid physics library, www.github.com/paboyle/Grid
+
+    Source file: ./lib/parallelIO/CompressedIO.h
+
+    Copyright (C) 2015
+
+    Author: Peter Boyle <paboyle@ph.ed.ac.uk>
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License along
+    with this program; if not, write to the Free Software Foundation, Inc.,
+    51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+
+    See the full license in the file "LICENSE" in the top level distribution directory
+*************************************************************************************/
+/*  END LEGAL */
+#pragma once
+
+NAMESPACE_BEGIN(Grid);
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+// Chunked, compressed storage for sets of lattice fields (eigenvector bases, propagators).
+//
+// The global lattice is tiled by blocks no larger than a rank's local volume; the slowest
+// dimension is cut into chunkSlices-thick slabs so that every rank has several chunks to
+// compress in parallel. Each chunk of each field is coded independently:
+//
+//   Lossless   : real words as stored, byte shuffled, deflated
+//   Half       : words scaled by the chunk's largest modulus, rounded to IEEE fp16
+//                (relative to that scale the error is at most 2^-11)
+//   BFloat16   : words rounded to bfloat16 (relative error at most 2^-8)
+//   Quantised  : words rounded to the nearest multiple of 2*tolerance, so |error| <= tolerance;
+//                chunks whose range does not fit 32 bits fall back to Lossless
+//
+// The file is a header, the chunk payloads and a trailing index giving the offset, size,
+// codec and crc32 of every chunk, so a reader on any decomposition fetches only the chunks
+// that overlap its local volume. All ranks write their own chunks with pwrite, so the file
+// must be on a filesystem every rank sees. Files are little endian.
+///////////////////////////////////////////////////////////////////////////////////////////////////
+struct CompressedIOParams {
+  enum { Lossless=0, Half=1, BFloat16=2, Quantised=3 };
+  int   codec       = Lossless;
+  RealD tolerance   = 0.0;  // Quantised only
+  int   chunkSlices = 1;    // thickness of a chunk in the slowest dimension
+  int   level       = 1;    // deflate level
+};
+
+class CompressedIO {
+public:
+  static const int MaxDims = 8;
+
+  struct FileHeader {
+    char     magic[8];
+    uint32_t endian;
+    uint32_t version;
+    uint32_t nd;
+    uint32_t checkerboard;
+    uint32_t gdims[MaxDims];
+    uint32_t block[MaxDims];
+    uint32_t codec;
+    uint32_t words;      // real words per site
+    uint32_t wordbytes;  // precision of the field that was written
+    uint32_t pad;
+    double   tolerance;
+    uint64_t nfield;
+    uint64_t nchunk;     // per field
+    uint64_t index;      // offset of the chunk index
+  };
+  struct ChunkIndex {
+    uint64_t offset;
+    uint64_t bytes;
+    uint32_t codec;
+    uint32_t crc;
+  };
+
+  static BinaryIO::IoPerf lastPerf;
+  static double lastRatio;   // raw field bytes over file bytes
+
+  /////////////////////////////////////////////////////////////////////////////
+  // Chunk geometry and ownership
+  /////////////////////////////////////////////////////////////////////////////
+  static inline void ChunkGeometry(GridBase *grid,int chunkSlices,Coordinate &block,Coordinate &nblock)
+  {
+    int nd = grid->_ndimension;
+    assert(nd<=MaxDims);
+    block  = grid->LocalDimensions();
+    nblock = Coordinate(nd);
+    int slices = std::max(1,std::min(chunkSlices,block[nd-1]));
+    while ( block[nd-1]%slices ) slices--;
+    block[nd-1] = slices;
+    for(int d=0;d<nd;d++) nblock[d] = grid->GlobalDimensions()[d]/block[d];
+  }
+
+  // Chunks (of one field) overlapping this rank's local volume
+  static inline std::vector<uint64_t> LocalChunks(GridBase *grid,const Coordinate &block,const Coordinate &nblock)
+  {
+    int nd = grid->_ndimension;
+    Coordinate lo(nd), hi(nd), n(nd);
+    for(int d=0;d<nd;d++){
+      lo[d] = grid->LocalStarts()[d]/block[d];
+      hi[d] = (grid->LocalStarts()[d]+grid->LocalDimensions()[d]-1)/block[d];
+      n[d]  = hi[d]-lo[d]+1;
+    }
+    uint64_t nlocal=1;
+    for(int d=0;d<nd;d++) nlocal*=n[d];
+    std::vector<uint64_t> chunks(nlocal);
+    Coordinate c(nd);
+    for(uint64_t i=0;i<nlocal;i++){
+      Lexicographic::CoorFromIndex(c,i,n);
+      uint64_t id=0;
+      for(int d=nd-1;d>=0;d--) id = id*nblock[d] + lo[d]+c[d];
+      chunks[i]=id;
+    }
+    return chunks;
+  }
+
+  /////////////////////////////////////////////////////////////////////////////
+  // Codecs on one chunk of real words
+  /////////////////////////////////////////////////////////////////////////////
+  static inline void Shuffle(unsigned char *out,const unsigned char *in,uint64_t n,int esize)
+  {
+    for(uint64_t i=0;i<n;i++) for(int b=0;b<esize;b++) out[b*n+i] = in[i*esize+b];
+  }
+  static inline void Unshuffle(unsigned char *out,const unsigned char *in,uint64_t n,int esize)
+  {
+    for(uint64_t i=0;i<n;i++) for(int b=0;b<esize;b++) out[i*esize+b] = in[b*n+i];
+  }
+  static inline uint16_t ToBFloat16(float f)
+  {
+    uint32_t u; memcpy(&u,&f,sizeof(u));
+    if ( (u & 0x7fffffff) > 0x7f800000 ) return (u>>16)|0x40; // keep NaN quiet
+    u += 0x7fff + ((u>>16)&1);                                 // round to nearest even
+    return u>>16;
+  }
+  static inline float FromBFloat16(uint16_t h)
+  {
+    uint32_t u = ((uint32_t)h)<<16;
+    float f; memcpy(&f,&u,sizeof(f));
+    return f;
+  }
+  static inline int ElementBytes(int codec,int wordbytes)
+  {
+    switch(codec){
+    case CompressedIOParams::Lossless:  return wordbytes;
+    case CompressedIOParams::Half:      return 2;
+    case CompressedIOParams::BFloat16:  return 2;
+    case CompressedIOParams::Quantised: return 4;
+    default: assert(0);
+    }
+    return 0;
+  }
+
+  // Payload = deflate( double scale | shuffled elements ). Returns the codec actually used.
+  template<class word>
+  static inline int EncodeChunk(const word *in,uint64_t n,const CompressedIOParams &params,
+				std::vector<unsigned char> &payload)
+  {
+    int codec  = params.codec;
+    double scale = 1.0;
+    if ( codec==CompressedIOParams::Half ) {
+      double mx=0.0;
+      for(uint64_t i=0;i<n;i++) mx = std::max(mx,std::fabs((double)in[i]));
+      scale = (mx>0.0) ? mx : 1.0;
+    }
+    if ( codec==CompressedIOParams::Quantised ) {
+      assert(params.tolerance>0.0);
+      scale = 2.0*params.tolerance;
+      for(uint64_t i=0;i<n;i++) {
+	if ( !(std::fabs((double)in[i]/scale) < 2147483647.0) ) { codec = CompressedIOParams::Lossless; break; }
+      }
+    }
+    int esize = ElementBytes(codec,sizeof(word));
+    std::vector<unsigned char> raw(n*esize), coded(sizeof(double)+n*esize);
+    switch(codec){
+    case CompressedIOParams::Lossless:
+      memcpy(&raw[0],in,n*esize);
+      break;
+    case CompressedIOParams::Half:
+      for(uint64_t i=0;i<n;i++) { Grid_half h = sfw_float_to_half((float)(in[i]/scale)); memcpy(&raw[2*i],&h.x,2); }
+      break;
+    case CompressedIOParams::BFloat16:
+      for(uint64_t i=0;i<n;i++) { uint16_t h = ToBFloat16((float)in[i]); memcpy(&raw[2*i],&h,2); }
+      break;
+    case CompressedIOParams::Quantised:
+      for(uint64_t i=0;i<n;i++) { int32_t q = (int32_t)std::llround(in[i]/scale); memcpy(&raw[4*i],&q,4); }
+      break;
+    }
+    memcpy(&coded[0],&scale,sizeof(double));
+    Shuffle(&coded[sizeof(double)],&raw[0],n,esize);
+
+    uLongf bound = compressBound(coded.size());
+    payload.resize(bound);
+    int ierr = compress2(&payload[0],&bound,&coded[0],coded.size(),params.level);
+    assert(ierr==Z_OK);
+    payload.resize(bound);
+    return codec;
+  }
+
+  template<class word>
+  static inline void DecodeChunk(word *out,uint64_t n,int codec,int wordbytes,
+				 const std::vector<unsigned char> &payload)
+  {
+    int esize = ElementBytes(codec,wordbytes);
+    std::vector<unsigned char> coded(sizeof(double)+n*esize), raw(n*esize);
+    uLongf len = coded.size();
+    int ierr = uncompress(&coded[0],&len,&payload[0],payload.size());
+    assert(ierr==Z_OK);
+    assert(len==coded.size());
+    double scale;
+    memcpy(&scale,&coded[0],sizeof(double));
+    Unshuffle(&raw[0],&coded[sizeof(double)],n,esize);
+    switch(codec){
+    case CompressedIOParams::Lossless:
+      if ( wordbytes==sizeof(double) ) { for(uint64_t i=0;i<n;i++) { double v; memcpy(&v,&raw[8*i],8); out[i]=v; } }
+      else                             { for(uint64_t i=0;i<n;i++) { float  v; memcpy(&v,&raw[4*i],4); out[i]=v; } }
+      break;
+    case CompressedIOParams::Half:
+      for(uint64_t i=0;i<n;i++) { Grid_half h; memcpy(&h.x,&raw[2*i],2); out[i] = scale*sfw_half_to_float(h); }
+      break;
+    case CompressedIOParams::BFloat16:
+      for(uint64_t i=0;i<n;i++) { uint16_t h; memcpy(&h,&raw[2*i],2); out[i] = FromBFloat16(h); }
+      break;
+    case CompressedIOParams::Quantised:
+      for(uint64_t i=0;i<n;i++) { int32_t q; memcpy(&q,&raw[4*i],4); out[i] = scale*q; }
+      break;
+    default:
+      assert(0);
+    }
+  }
+
+  // Read bytes at offset, giving up on the whole job if the file is short or unreadable
+  static inline void ReadAt(int fd,void *ptr,uint64_t bytes,uint64_t offset,const std::string &file)
+  {
+    ssize_t n = pread(fd,ptr,bytes,offset);
+    if ( n != (ssize_t)bytes ) {
+      std::cout<<GridLogError<<"CompressedIO: read of "<<bytes<<" bytes at "<<offset<<" in "<<file
+	       <<" returned "<<n<<std::endl;
+      exit(1);
+    }
+  }
+
+  /////////////////////////////////////////////////////////////////////////////
+  // Header and index; every rank reads them for itself
+  /////////////////////////////////////////////////////////////////////////////
+  static inline void readIndex(const std::string &file,FileHeader &header,std::vector<ChunkIndex> &index)
+  {
+    int fd = open(file.c_str(),O_RDONLY);
+    if ( fd<0 ) {
+      std::cout<<GridLogError<<"CompressedIO: cannot open "<<file<<std::endl;
+      assert(0);
+    }
+    ReadAt(fd,&header,sizeof(header),0,file);
+    assert(memcmp(header.magic,"GRIDCMPR",8)==0);
+    assert(header.endian==0x01020304);
+    assert(header.version==1);
+    uint64_t n = header.nfield*header.nchunk;
+    index.resize(n);
+    uint64_t bytes = n*sizeof(ChunkIndex);
+    ReadAt(fd,&index[0],bytes,header.index,file);
+    close(fd);
+  }
+
+  /////////////////////////////////////////////////////////////////////////////
+  // Write a set of fields
+  /////////////////////////////////////////////////////////////////////////////
+  template<class vobj>
+  static inline void writeFields(const std::vector<const Lattice<vobj> *> &fields,const std::string &file,
+				 const CompressedIOParams &params=CompressedIOParams())
+  {
+    typedef typename vobj::scalar_object sobj;
+    typedef typename vobj::Realified::scalar_type word;
+    const uint64_t words = sizeof(sobj)/sizeof(word);
+
+    assert(fields.size()>0);
+    GridBase *grid = fields[0]->Grid();
+    int nd = grid->_ndimension;
+    GridStopWatch timer; timer.Start();
+
+    Coordinate block, nblock;
+    ChunkGeometry(grid,params.chunkSlices,block,nblock);
+    uint64_t nchunk=1, bsites=1;
+    for(int d=0;d<nd;d++) { nchunk*=nblock[d]; bsites*=block[d]; }
+    uint64_t nfield = fields.size();
+    std::vector<uint64_t> mine = LocalChunks(grid,block,nblock);
+
+    Coordinate ldims  = grid->LocalDimensions();
+    Coordinate lstart = grid->LocalStarts();
+
+    if ( grid->IsBoss() ) {
+      int fd = open(file.c_str(),O_WRONLY|O_CREAT|O_TRUNC,0644);
+      assert(fd>=0);
+      close(fd);
+    }
+    grid->Barrier();
+    int fd = open(file.c_str(),O_WRONLY);
+    assert(fd>=0);
+
+    // Compress the local chunks of one field at a time and write them out before
+    // the next, so only one field's payloads are held. Chunk sizes are summed over
+    // ranks per field and every rank lays out the offsets in the same order.
+    std::vector<ChunkIndex> index(nfield*nchunk);
+    uint64_t offset = sizeof(FileHeader);
+    int ok=1;
+    std::vector<std::vector<unsigned char> > payload(mine.size());
+    std::vector<uint64_t> table(3*nchunk); // bytes, codec, crc ; summed over ranks
+    std::vector<sobj> scalardata(grid->lSites());
+    for(uint64_t f=0;f<nfield;f++){
+      assert(fields[f]->Grid()==grid);
+      unvectorizeToLexOrdArray(scalardata,*fields[f]);
+      std::fill(table.begin(),table.end(),0);
+      thread_for(c,mine.size(),{
+	Coordinate bc(nd), sc(nd), lc(nd);
+	Lexicographic::CoorFromIndex(bc,mine[c],nblock);
+	std::vector<word> buf(bsites*words);
+	for(uint64_t s=0;s<bsites;s++){
+	  Lexicographic::CoorFromIndex(sc,s,block);
+	  for(int d=0;d<nd;d++) lc[d] = bc[d]*block[d]+sc[d]-lstart[d];
+	  int l; Lexicographic::IndexFromCoor(lc,l,ldims);
+	  memcpy(&buf[s*words],&scalardata[l],sizeof(sobj));
+	}
+	std::vector<unsigned char> &p = payload[c];
+	int codec = EncodeChunk(&buf[0],bsites*words,params,p);
+	uint64_t id = mine[c];
+	table[3*id+0] = p.size();
+	table[3*id+1] = codec;
+	table[3*id+2] = GridChecksum::crc32(&p[0],p.size());
+      });
+      grid->GlobalSumVector(&table[0],table.size());
+
+      for(uint64_t c=0;c<nchunk;c++){
+	ChunkIndex &ci = index[f*nchunk+c];
+	ci.offset = offset;
+	ci.bytes  = table[3*c+0];
+	ci.codec  = table[3*c+1];
+	ci.crc    = table[3*c+2];
+	offset   += ci.bytes;
+      }
+      for(uint64_t c=0;c<mine.size();c++){
+	std::vector<unsigned char> &p = payload[c];
+	ok = ok && (pwrite(fd,&p[0],p.size(),index[f*nchunk+mine[c]].offset)==(ssize_t)p.size());
+	std::vector<unsigned char>().swap(p);
+      }
+    }
+
+    FileHeader header;
+    memset(&header,0,sizeof(header));
+    memcpy(header.magic,"GRIDCMPR",8);
+    header.endian       = 0x01020304;
+    header.version      = 1;
+    header.nd           = nd;
+    header.checkerboard = fields[0]->Checkerboard();
+    for(int d=0;d<nd;d++){
+      header.gdims[d] = grid->GlobalDimensions()[d];
+      header.block[d] = block[d];
+    }
+    header.codec     = params.codec;
+    header.words     = words;
+    header.wordbytes = sizeof(word);
+    header.tolerance = params.tolerance;
+    header.nfield    = nfield;
+    header.nchunk    = nchunk;
+    header.index     = offset;
+
+    if ( grid->IsBoss() ) {
+      ok = ok && (pwrite(fd,&header,sizeof(header),0)==sizeof(header));
+      uint64_t bytes = index.size()*sizeof(ChunkIndex);
+      ok = ok && (pwrite(fd,&index[0],bytes,header.index)==(ssize_t)bytes);
+    }
+    close(fd);
+    uint32_t okall = ok;
+    grid->GlobalSum(okall);
+    if ( okall != (uint32_t)grid->ProcessorCount() ) {
+      std::cout<<GridLogError<<"CompressedIO: write of "<<file<<" failed"<<std::endl;
+      assert(0);
+    }
+    grid->Barrier();
+    timer.Stop();
+
+    uint64_t rawbytes = nfield*grid->gSites()*sizeof(sobj);
+    lastRatio = (double)rawbytes/(double)(header.index+index.size()*sizeof(ChunkIndex));
+    lastPerf.size            = rawbytes;
+    lastPerf.time            = timer.useconds();
+    lastPerf.mbytesPerSecond = rawbytes/1024./1024./(timer.useconds()/1.0e6);
+    std::cout<<GridLogMessage<<"CompressedIO: wrote "<<nfield<<" field(s) to "<<file<<" in "<<timer.Elapsed()
+	     <<" "<<lastPerf.mbytesPerSecond<<" MB/s, compression ratio "<<lastRatio<<std::endl;
+  }
+
+  /////////////////////////////////////////////////////////////////////////////
+  // Read a set of fields; the decomposition need not match the writer's
+  /////////////////////////////////////////////////////////////////////////////
+  template<class vobj>
+  static inline void readFields(const std::vector<Lattice<vobj> *> &fields,const std::string &file)
+  {
+    typedef typename vobj::scalar_object sobj;
+    typedef typename vobj::Realified::scalar_type word;
+    const uint64_t words = sizeof(sobj)/sizeof(word);
+
+    assert(fields.size()>0);
+    GridBase *grid = fields[0]->Grid();
+    int nd = grid->_ndimension;
+    GridStopWatch timer; timer.Start();
+
+    FileHeader header;
+    std::vector<ChunkIndex> index;
+    readIndex(file,header,index);
+    assert(header.nd==(uint32_t)nd);
+    assert(header.words==words);
+    assert(header.nfield>=fields.size());
+
+    Coordinate block(nd), nblock(nd);
+    uint64_t bsites=1;
+    for(int d=0;d<nd;d++){
+      assert(header.gdims[d]==(uint32_t)grid->GlobalDimensions()[d]);
+      block[d]  = header.block[d];
+      nblock[d] = header.gdims[d]/block[d];
+      bsites   *= block[d];
+    }
+    std::vector<uint64_t> mine = LocalChunks(grid,block,nblock);
+
+    Coordinate ldims  = grid->LocalDimensions();
+    Coordinate lstart = grid->LocalStarts();
+
+    int fd = open(file.c_str(),O_RDONLY);
+    assert(fd>=0);
+    uint64_t filebytes=0;
+    std::vector<sobj> scalardata(grid->lSites());
+    for(uint64_t f=0;f<fields.size();f++){
+      thread_for(c,mine.size(),{
+	const ChunkIndex &ci = index[f*header.nchunk+mine[c]];
+	std::vector<unsigned char> p(ci.bytes);
+	ReadAt(fd,&p[0],ci.bytes,ci.offset,file);
+	if ( GridChecksum::crc32(&p[0],p.size()) != ci.crc ) {
+	  std::cout<<GridLogError<<"CompressedIO: crc mismatch in chunk "<<mine[c]<<" of field "<<f<<" in "<<file<<std::endl;
+	  assert(0);
+	}
+	std::vector<word> buf(bsites*words);
+	DecodeChunk(&buf[0],bsites*words,ci.codec,header.wordbytes,p);
+
+	Coordinate bc(nd), sc(nd), lc(nd);
+	Lexicographic::CoorFromIndex(bc,mine[c],nblock);
+	for(uint64_t s=0;s<bsites;s++){
+	  Lexicographic::CoorFromIndex(sc,s,block);
+	  int inside=1;
+	  for(int d=0;d<nd;d++) {
+	    lc[d] = bc[d]*block[d]+sc[d]-lstart[d];
+	    inside = inside && (lc[d]>=0) && (lc[d]<ldims[d]);
+	  }
+	  if ( inside ) {
+	    int l; Lexicographic::IndexFromCoor(lc,l,ldims);
+	    memcpy((void *)&scalardata[l],&buf[s*words],sizeof(sobj));
+	  }
+	}
+      });
+      for(uint64_t c=0;c<mine.size();c++) filebytes += index[f*header.nchunk+mine[c]].bytes;
+      assert(fields[f]->Grid()==grid);
+      fields[f]->Checkerboard() = header.checkerboard;
+      vectorizeFromLexOrdArray(scalardata,*fields[f]);
+    }
+    close(fd);
+    grid->Barrier();
+    timer.Stop();
+
+    uint64_t rawbytes = fields.size()*grid->gSites()*sizeof(sobj);
+    grid->GlobalSum(filebytes);
+    lastRatio = (double)rawbytes/(double)filebytes;
+    lastPerf.size            = rawbytes;
+    lastPerf.time            = timer.useconds();
+    lastPerf.mbytesPerSecond = rawbytes/1024./1024./(timer.useconds()/1.0e6);
+    std::cout<<GridLogMessage<<"CompressedIO: read "<<fields.size()<<" field(s) from "<<file<<" in "<<timer.Elapsed()
+	     <<" "<<lastPerf.mbytesPerSecond<<" MB/s"<<std::endl;
+  }
+
+  template<class vobj>
+  static inline void writeFields(const std::vector<Lattice<vobj> > &fields,const std::string &file,
+				 const CompressedIOParams &params=CompressedIOParams())
+  {
+    std::vector<const Lattice<vobj> *> ptrs;
+    for(auto &f : fields) ptrs.push_back(&f);
+    writeFields(ptrs,file,params);
+  }
+  template<class vobj>
+  static inline void readFields(std::vector<Lattice<vobj> > &fields,const std::string &file)
+  {
+    std::vector<Lattice<vobj> *> ptrs;
+    for(auto &f : fields) ptrs.push_back(&f);
+    readFields(ptrs,file);
+  }
+  template<class vobj>
+  static inline void writeField(const Lattice<vobj> &field,const std::string &file,
+				const CompressedIOParams &params=CompressedIOParams())
+  {
+    writeFields(std::vector<const Lattice<vobj> *>(1,&field),file,params);
+  }
+  template<class vobj>
+  static inline void readField(Lattice<vobj> &field,const std::string &file)
+  {
+    readFields(std::vector<Lattice<vobj> *>(1,&field),file);
+  }
+};
+
+NAMESPACE_END(Grid);
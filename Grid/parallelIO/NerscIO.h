@@ -278,12 +278,79 @@ public:
     if ( grid->IsBoss() ) { 
       writeHeader(header,file);
     }
+    grid->Barrier();
 
     std::cout<<GridLogMessage <<"Written NERSC Configuration on "<< file << " checksum "
 	     <<std::hex<<header.checksum
 	     <<std::dec<<" plaq "<< header.plaquette <<std::endl;
 
   }
+  ///////////////////////////////////////////////////////////////////////////
+  // As writeConfiguration, but the link data drains in the background. The
+  // header is written with a zero checksum and rewritten by handle.wait(),
+  // which must be called collectively before the file is used.
+  ///////////////////////////////////////////////////////////////////////////
+  template<class GaugeStats=PeriodicGaugeStatistics>
+  static inline BinaryIOAsyncHandle writeConfigurationAsync(Lattice<vLorentzColourMatrixD > &Umu,
+							    std::string file, 
+							    int two_row,
+							    int bits32,
+							    std::string ens_label = std::string("DWF"),
+							    std::string ens_id = std::string("UKQCD"),
+							    unsigned int sequence_number = 1)
+  {
+    typedef vLorentzColourMatrixD vobj;
+    typedef typename vobj::scalar_object sobj;
+
+    FieldMetaData header;
+    header.sequence_number = sequence_number;
+    header.ensemble_id     = ens_id;
+    header.ensemble_label  = ens_label;
+    header.hdr_version     = "1.0" ;
+
+    typedef LorentzColourMatrixD fobj3D;
+    typedef LorentzColour2x3D    fobj2D;
+  
+    GridBase *grid = Umu.Grid();
+
+    GridMetaData(grid,header);
+    assert(header.nd==4);
+    GaugeStats Stats; Stats(Umu,header);
+    MachineCharacteristics(header);
+
+    uint64_t offset;
+
+    header.floating_point  = std::string("IEEE64BIG");
+    const std::string stNC = std::to_string( Nc ) ;
+    if( two_row ) {
+      header.data_type = std::string("4D_SU" + stNC + "_GAUGE" );
+    } else {
+      header.data_type = std::string("4D_SU" + stNC + "_GAUGE_" + stNC + "x" + stNC );
+    }
+    if ( grid->IsBoss() ) { 
+      truncate(file);
+      offset = writeHeader(header,file);
+    }
+    grid->Broadcast(0,(void *)&offset,sizeof(offset));
+
+    auto finalise = [header,file,grid](uint32_t nersc_csum,uint32_t scidac_csuma,uint32_t scidac_csumb) mutable {
+      header.checksum = nersc_csum;
+      if ( grid->IsBoss() ) { 
+	writeHeader(header,file);
+      }
+      std::cout<<GridLogMessage <<"Written NERSC Configuration on "<< file << " checksum "
+	       <<std::hex<<header.checksum
+	       <<std::dec<<" plaq "<< header.plaquette <<std::endl;
+    };
+
+    if( two_row ) {
+      Gauge3x2unmunger<fobj2D,sobj> munge;
+      return BinaryIO::writeLatticeObjectAsync<vobj,fobj2D>(Umu,file,munge,offset,header.floating_point,finalise);
+    } else {
+      GaugeSimpleUnmunger<fobj3D,sobj> munge;
+      return BinaryIO::writeLatticeObjectAsync<vobj,fobj3D>(Umu,file,munge,offset,header.floating_point,finalise);
+    }
+  }
   ///////////////////////////////
   // RNG state
   ///////////////////////////////
@@ -331,6 +398,7 @@ public:
 	if ( grid->IsBoss() ) { 
     offset = writeHeader(header,file);
 	}
+	grid->Barrier();
 
     std::cout<<GridLogMessage 
 	     <<"Written NERSC RNG STATE "<<file<< " checksum "
@@ -79,6 +79,7 @@ public:
   void ZeroCounters(void);
   double DhopCalls;
   double DhopCommTime;
+  double DhopCommWaitTime; // comms time not hidden behind compute
   double DhopComputeTime;
   double DhopComputeTime2;
   double DhopFaceTime;
@@ -128,6 +129,18 @@ public:
   void DhopOE(const FermionField &in, FermionField &out,int dag);
   void DhopEO(const FermionField &in, FermionField &out,int dag);
 
+  ///////////////////////////////////////////////////////////////
+  // Multiple right hand sides sharing the gauge field.
+  // The s-direction is innermost, so N fields with fifth dimension
+  // Ls/N (or N four dimensional fields when Ls==N) are fused into
+  // the s-direction of this operator. Each link is then loaded once
+  // for all N spinors and there is a single halo exchange.
+  // Keep sources fused across a solve to avoid the import/export.
+  ///////////////////////////////////////////////////////////////
+  void ImportMultiRHS(const std::vector<FermionField> &in, FermionField &fused);
+  void ExportMultiRHS(const FermionField &fused, std::vector<FermionField> &out);
+  void DhopMultiRHS  (const std::vector<FermionField> &in, std::vector<FermionField> &out,int dag);
+
   // add a DhopComm
   // -- suboptimal interface will presently trigger multiple comms.
   void DhopDir(const FermionField &in, FermionField &out,int dir,int disp);
@@ -144,6 +144,7 @@ void WilsonFermion5D<Impl>::Report(void)
     std::cout << GridLogMessage << "WilsonFermion5D Number of DhopEO Calls   : " << DhopCalls   << std::endl;
     std::cout << GridLogMessage << "WilsonFermion5D TotalTime   /Calls        : " << DhopTotalTime   / DhopCalls << " us" << std::endl;
     std::cout << GridLogMessage << "WilsonFermion5D CommTime    /Calls        : " << DhopCommTime    / DhopCalls << " us" << std::endl;
+    std::cout << GridLogMessage << "WilsonFermion5D CommWaitTime/Calls        : " << DhopCommWaitTime/ DhopCalls << " us" << std::endl;
     std::cout << GridLogMessage << "WilsonFermion5D FaceTime    /Calls        : " << DhopFaceTime    / DhopCalls << " us" << std::endl;
     std::cout << GridLogMessage << "WilsonFermion5D ComputeTime1/Calls        : " << DhopComputeTime / DhopCalls << " us" << std::endl;
     std::cout << GridLogMessage << "WilsonFermion5D ComputeTime2/Calls        : " << DhopComputeTime2/ DhopCalls << " us" << std::endl;
@@ -194,6 +195,7 @@ template<class Impl>
 void WilsonFermion5D<Impl>::ZeroCounters(void) {
   DhopCalls       = 0;
   DhopCommTime    = 0;
+  DhopCommWaitTime= 0;
   DhopComputeTime = 0;
   DhopComputeTime2= 0;
   DhopFaceTime    = 0;
@@ -386,9 +388,21 @@ void WilsonFermion5D<Impl>::DhopInternalOverlappedComms(StencilImpl & st, Lebesg
   st.HaloExchangeOptGather(in,compressor);
   DhopFaceTime+=usecond();
 
+  // With a progress thread the halo exchange is driven off the compute
+  // threads, and the interior runs on one fewer thread
+  int progress = CartesianCommunicator::UseProgressThread;
+  int nthreads = GridThread::GetThreads();
+
   DhopCommTime -=usecond();
+  DhopCommWaitTime-=usecond();
   std::vector<std::vector<CommsRequest_t> > requests;
-  st.CommunicateBegin(requests);
+  if ( progress ) st.CommunicateProgressBegin(requests);
+  else            st.CommunicateBegin(requests);
+  DhopCommWaitTime+=usecond();
+
+#ifdef GRID_OMP
+  if ( progress && (nthreads>1) ) omp_set_num_threads(nthreads-1);
+#endif
 
   /////////////////////////////
   // Overlap with comms
@@ -409,10 +423,17 @@ void WilsonFermion5D<Impl>::DhopInternalOverlappedComms(StencilImpl & st, Lebesg
   }
   DhopComputeTime+=usecond();
 
+#ifdef GRID_OMP
+  if ( progress && (nthreads>1) ) omp_set_num_threads(nthreads);
+#endif
+
   /////////////////////////////
   // Complete comms
   /////////////////////////////
-  st.CommunicateComplete(requests);
+  DhopCommWaitTime-=usecond();
+  if ( progress ) st.CommunicateProgressComplete(requests);
+  else            st.CommunicateComplete(requests);
+  DhopCommWaitTime+=usecond();
   DhopCommTime   +=usecond();
 
   /////////////////////////////
@@ -442,9 +463,22 @@ void WilsonFermion5D<Impl>::DhopInternalSerialComms(StencilImpl & st, LebesgueOr
 
   int LLs = in.Grid()->_rdimensions[0];
   
+  // HaloExchangeOpt, split so that CommTime counts only the message
+  // exchange as in the overlapped case; none of it is hidden
+  DhopFaceTime-=usecond();
+  st.HaloExchangeOptGather(in,compressor);
+  DhopFaceTime+=usecond();
+
   DhopCommTime-=usecond();
-  st.HaloExchangeOpt(in,compressor);
+  DhopCommWaitTime-=usecond();
+  st.Communicate();
+  DhopCommWaitTime+=usecond();
   DhopCommTime+=usecond();
+
+  DhopFaceTime-=usecond();
+  st.CommsMerge(compressor);
+  st.CommsMergeSHM(compressor);
+  DhopFaceTime+=usecond();
   
   DhopComputeTime-=usecond();
   int Opt = WilsonKernelsStatic::Opt;
@@ -493,6 +527,86 @@ void WilsonFermion5D<Impl>::Dhop(const FermionField &in, FermionField &out,int d
   DhopInternal(Stencil,Lebesgue,Umu,in,out,dag);
 }
 template<class Impl>
+void WilsonFermion5D<Impl>::ImportMultiRHS(const std::vector<FermionField> &in, FermionField &fused)
+{
+  int nrhs = in.size();
+  assert(nrhs>0);
+  GridBase *fgrid = fused.Grid();
+  GridBase *rhs_grid = in[0].Grid();
+  assert( (fgrid==FermionGrid()) || (fgrid==FermionRedBlackGrid()) );
+  assert( fgrid->_isCheckerBoarded == rhs_grid->_isCheckerBoarded );
+
+  // Fifth dimension extent of each rhs; four dimensional fields have Ls=1
+  int LsRHS = (rhs_grid->Nd()==Nd+1) ? rhs_grid->_rdimensions[0] : 1;
+  assert(LsRHS*nrhs == Ls);
+  assert(rhs_grid->oSites()*nrhs == fgrid->oSites());
+
+  fused.Checkerboard() = in[0].Checkerboard();
+
+  uint64_t nsite = rhs_grid->oSites();
+  autoView(fused_v, fused, AcceleratorWrite);
+  for(int n=0;n<nrhs;n++){
+    conformable(in[n].Grid(),rhs_grid);
+    assert(in[n].Checkerboard()==fused.Checkerboard());
+    autoView(in_v, in[n], AcceleratorRead);
+    int LLs = Ls;
+    accelerator_for(ss,nsite,Simd::Nsimd(),{
+      int sU = ss/LsRHS;
+      int s  = ss%LsRHS + n*LsRHS;
+      coalescedWrite(fused_v[s+LLs*sU],in_v(ss));
+    });
+  }
+}
+template<class Impl>
+void WilsonFermion5D<Impl>::ExportMultiRHS(const FermionField &fused, std::vector<FermionField> &out)
+{
+  int nrhs = out.size();
+  assert(nrhs>0);
+  GridBase *fgrid = fused.Grid();
+  GridBase *rhs_grid = out[0].Grid();
+  assert( (fgrid==FermionGrid()) || (fgrid==FermionRedBlackGrid()) );
+  assert( fgrid->_isCheckerBoarded == rhs_grid->_isCheckerBoarded );
+
+  int LsRHS = (rhs_grid->Nd()==Nd+1) ? rhs_grid->_rdimensions[0] : 1;
+  assert(LsRHS*nrhs == Ls);
+  assert(rhs_grid->oSites()*nrhs == fgrid->oSites());
+
+  uint64_t nsite = rhs_grid->oSites();
+  autoView(fused_v, fused, AcceleratorRead);
+  for(int n=0;n<nrhs;n++){
+    conformable(out[n].Grid(),rhs_grid);
+    out[n].Checkerboard() = fused.Checkerboard();
+    autoView(out_v, out[n], AcceleratorWrite);
+    int LLs = Ls;
+    accelerator_for(ss,nsite,Simd::Nsimd(),{
+      int sU = ss/LsRHS;
+      int s  = ss%LsRHS + n*LsRHS;
+      coalescedWrite(out_v[ss],fused_v(s+LLs*sU));
+    });
+  }
+}
+template<class Impl>
+void WilsonFermion5D<Impl>::DhopMultiRHS(const std::vector<FermionField> &in, std::vector<FermionField> &out,int dag)
+{
+  assert(in.size()==out.size());
+  assert(in.size()>0);
+
+  if ( in[0].Grid()->_isCheckerBoarded ) {
+    FermionField fused_in (FermionRedBlackGrid());
+    FermionField fused_out(FermionRedBlackGrid());
+    ImportMultiRHS(in,fused_in);
+    if ( fused_in.Checkerboard() == Even ) DhopOE(fused_in,fused_out,dag);
+    else                                   DhopEO(fused_in,fused_out,dag);
+    ExportMultiRHS(fused_out,out);
+  } else {
+    FermionField fused_in (FermionGrid());
+    FermionField fused_out(FermionGrid());
+    ImportMultiRHS(in,fused_in);
+    Dhop(fused_in,fused_out,dag);
+    ExportMultiRHS(fused_out,out);
+  }
+}
+template<class Impl>
 void WilsonFermion5D<Impl>::DW(const FermionField &in, FermionField &out,int dag)
 {
   out.Checkerboard()=in.Checkerboard();
@@ -49,6 +49,8 @@ private:
 
   FermionField Phi;  // the pseudo fermion field for this trajectory
 
+  ChronoGuesser<FermionField> *DerivativeGuesser; // optional initial guesses for deriv solves
+
 public:
   /////////////////////////////////////////////////
   // Pass in required objects.
@@ -59,7 +61,11 @@ public:
     : FermOp(Op),
       DerivativeSolver(DS),
       ActionSolver(AS),
-      Phi(Op.FermionGrid()){};
+      Phi(Op.FermionGrid()),
+      DerivativeGuesser(nullptr){};
+
+  // Initial guesses for the deriv() solves; see ChronoGuesser
+  void SetDerivativeGuesser(ChronoGuesser<FermionField> *_Guesser) { DerivativeGuesser = _Guesser; };
 
 
   virtual std::string action_name(){return "TwoFlavourPseudoFermionAction";}
@@ -98,6 +104,8 @@ public:
 
     FermOp.ImportGauge(U);
     FermOp.Mdag(eta, Phi);
+
+    if ( DerivativeGuesser ) DerivativeGuesser->Reset();
   };
 
   //////////////////////////////////////////////////////
@@ -138,7 +146,11 @@ public:
     MdagMLinearOperator<FermionOperator<Impl>, FermionField> MdagMOp(FermOp);
 
     X = Zero();
+    if ( DerivativeGuesser && DerivativeGuesser->Admissible(DerivativeSolver) ) {
+      DerivativeGuesser->Guess(MdagMOp,Phi,X);
+    }
     DerivativeSolver(MdagMOp, Phi, X); // X = (MdagM)^-1 phi    
+    if ( DerivativeGuesser ) DerivativeGuesser->Update(X);
     MdagMOp.Op(X, Y);                  // Y = M X = (Mdag)^-1 phi
 
     // Our conventions really make this UdSdU; We do not differentiate wrt Udag here.
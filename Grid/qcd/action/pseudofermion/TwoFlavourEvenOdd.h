@@ -51,6 +51,8 @@ private:
   FermionField PhiOdd;   // the pseudo fermion field for this trajectory
   FermionField PhiEven;  // the pseudo fermion field for this trajectory
 
+  ChronoGuesser<FermionField> *DerivativeGuesser; // optional initial guesses for deriv solves
+
 public:
   /////////////////////////////////////////////////
   // Pass in required objects.
@@ -62,8 +64,12 @@ public:
       DerivativeSolver(DS),
       ActionSolver(AS),
       PhiEven(Op.FermionRedBlackGrid()),
-      PhiOdd(Op.FermionRedBlackGrid())
+      PhiOdd(Op.FermionRedBlackGrid()),
+      DerivativeGuesser(nullptr)
   {};
+
+  // Initial guesses for the deriv() solves; see ChronoGuesser
+  void SetDerivativeGuesser(ChronoGuesser<FermionField> *_Guesser) { DerivativeGuesser = _Guesser; };
   
   virtual std::string action_name(){return "TwoFlavourEvenOddPseudoFermionAction";}
       
@@ -105,7 +111,8 @@ public:
     
     PhiOdd =PhiOdd*scale;
     PhiEven=PhiEven*scale;
-    
+
+    if ( DerivativeGuesser ) DerivativeGuesser->Reset();
   };
   
   //////////////////////////////////////////////////////
@@ -156,7 +163,11 @@ public:
     // So must take dSdU - adj(dSdU) and left multiply by mom to get dS/dt.
 
     X=Zero();
+    if ( DerivativeGuesser && DerivativeGuesser->Admissible(DerivativeSolver) ) {
+      DerivativeGuesser->Guess(Mpc,PhiOdd,X);
+    }
     DerivativeSolver(Mpc,PhiOdd,X);
+    if ( DerivativeGuesser ) DerivativeGuesser->Update(X);
     Mpc.Mpc(X,Y);
     Mpc.MpcDeriv(tmp , Y, X );    dSdU=tmp;
     Mpc.MpcDagDeriv(tmp , X, Y);  dSdU=dSdU+tmp;
@@ -50,6 +50,8 @@ NAMESPACE_BEGIN(Grid);
       FermionField PhiOdd;   // the pseudo fermion field for this trajectory
       FermionField PhiEven;  // the pseudo fermion field for this trajectory
 
+      ChronoGuesser<FermionField> *DerivativeGuesser; // optional initial guesses for deriv solves
+
     public:
       TwoFlavourEvenOddRatioPseudoFermionAction(FermionOperator<Impl>  &_NumOp, 
                                                 FermionOperator<Impl>  &_DenOp, 
@@ -67,7 +69,8 @@ NAMESPACE_BEGIN(Grid);
       ActionSolver(AS),
       HeatbathSolver(HS),
       PhiEven(_NumOp.FermionRedBlackGrid()),
-      PhiOdd(_NumOp.FermionRedBlackGrid()) 
+      PhiOdd(_NumOp.FermionRedBlackGrid()),
+      DerivativeGuesser(nullptr)
         {
           conformable(_NumOp.FermionGrid(), _DenOp.FermionGrid());
           conformable(_NumOp.FermionRedBlackGrid(), _DenOp.FermionRedBlackGrid());
@@ -75,6 +78,9 @@ NAMESPACE_BEGIN(Grid);
           conformable(_NumOp.GaugeRedBlackGrid(), _DenOp.GaugeRedBlackGrid());
         };
 
+      // Initial guesses for the deriv() solves; see ChronoGuesser
+      void SetDerivativeGuesser(ChronoGuesser<FermionField> *_Guesser) { DerivativeGuesser = _Guesser; };
+
       virtual std::string action_name(){return "TwoFlavourEvenOddRatioPseudoFermionAction";}
 
       virtual std::string LogParameters(){
@@ -127,7 +133,8 @@ NAMESPACE_BEGIN(Grid);
 
         PhiOdd =PhiOdd*scale;
         PhiEven=PhiEven*scale;
-        
+
+        if ( DerivativeGuesser ) DerivativeGuesser->Reset();
       };
 
       //////////////////////////////////////////////////////
@@ -188,7 +195,11 @@ NAMESPACE_BEGIN(Grid);
         //Y = (Mdag)^-1 V^dag  phi
         Vpc.MpcDag(PhiOdd,Y);          // Y= Vdag phi
         X=Zero();
+        if ( DerivativeGuesser && DerivativeGuesser->Admissible(DerivativeSolver) ) {
+          DerivativeGuesser->Guess(Mpc,Y,X);
+        }
         DerivativeSolver(Mpc,Y,X);     // X= (MdagM)^-1 Vdag phi
+        if ( DerivativeGuesser ) DerivativeGuesser->Update(X);
         Mpc.Mpc(X,Y);                  // Y=  Mdag^-1 Vdag phi
 
         // phi^dag V (Mdag M)^-1 dV^dag  phi
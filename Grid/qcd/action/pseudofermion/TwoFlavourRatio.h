@@ -49,12 +49,17 @@ private:
 
   FermionField Phi; // the pseudo fermion field for this trajectory
 
+  ChronoGuesser<FermionField> *DerivativeGuesser; // optional initial guesses for deriv solves
+
 public:
   TwoFlavourRatioPseudoFermionAction(FermionOperator<Impl>  &_NumOp, 
 				     FermionOperator<Impl>  &_DenOp, 
 				     OperatorFunction<FermionField> & DS,
 				     OperatorFunction<FermionField> & AS
-				     ) : NumOp(_NumOp), DenOp(_DenOp), DerivativeSolver(DS), ActionSolver(AS), Phi(_NumOp.FermionGrid()) {};
+				     ) : NumOp(_NumOp), DenOp(_DenOp), DerivativeSolver(DS), ActionSolver(AS), Phi(_NumOp.FermionGrid()), DerivativeGuesser(nullptr) {};
+
+  // Initial guesses for the deriv() solves; see ChronoGuesser
+  void SetDerivativeGuesser(ChronoGuesser<FermionField> *_Guesser) { DerivativeGuesser = _Guesser; };
       
   virtual std::string action_name(){return "TwoFlavourRatioPseudoFermionAction";}
 
@@ -99,7 +104,8 @@ public:
     NumOp.M(tmp,Phi);               // Vdag^-1 Mdag eta
 
     Phi=Phi*scale;
-	
+
+    if ( DerivativeGuesser ) DerivativeGuesser->Reset();
   };
 
   //////////////////////////////////////////////////////
@@ -148,7 +154,11 @@ public:
     //Y = (Mdag)^-1 V^dag  phi
     NumOp.Mdag(Phi,Y);              // Y= Vdag phi
     X=Zero();
+    if ( DerivativeGuesser && DerivativeGuesser->Admissible(DerivativeSolver) ) {
+      DerivativeGuesser->Guess(MdagMOp,Y,X);
+    }
     DerivativeSolver(MdagMOp,Y,X);      // X= (MdagM)^-1 Vdag phi
+    if ( DerivativeGuesser ) DerivativeGuesser->Update(X);
     DenOp.M(X,Y);                  // Y=  Mdag^-1 Vdag phi
 
     // phi^dag V (Mdag M)^-1 dV^dag  phi
@@ -177,6 +177,7 @@ private:
 
     // Run it
     HMC.evolve();
+    Resources.GetCheckPointer()->CheckpointFlush();
   }
 };
 
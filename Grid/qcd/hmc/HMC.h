@@ -53,6 +53,9 @@ struct HMCparameters: Serializable {
                                   bool, MetropolisTest,
                                   Integer, NoMetropolisUntil,
                                   std::string, StartingType,
+                                  Integer, TuneTrajectories, /* @brief Warm-up trajectories tuning the integrator; 0 for none */
+                                  RealD, TargetAcceptance,
+                                  std::string, TunedParameterFile, /* @brief Parameters to resume with the tuned integrator */
                                   IntegratorParameters, MD)
 
   HMCparameters() {
@@ -62,18 +65,43 @@ struct HMCparameters: Serializable {
     StartTrajectory   = 0;
     Trajectories      = 10;
     StartingType      = "HotStart";
+    TuneTrajectories  = 0;
+    TargetAcceptance  = 0.8;
+    TunedParameterFile= "hmc_tuned.xml";
     /////////////////////////////////
   }
 
   template <class ReaderClass >
-  HMCparameters(Reader<ReaderClass> & TheReader){
+  HMCparameters(Reader<ReaderClass> & TheReader) : HMCparameters() {
     initialize(TheReader);
   }
 
+  // The integrator tuning members are optional, so parameter files written before them still read
   template < class ReaderClass > 
   void initialize(Reader<ReaderClass> &TheReader){
     std::cout << GridLogMessage << "Reading HMC\n";
-    read(TheReader, "HMC", *this);
+    if (!TheReader.push("HMC")) {
+      std::cout << GridLogWarning << "IO: Cannot open node 'HMC'" << std::endl;
+      return;
+    }
+    Grid::read(TheReader, "StartTrajectory",   StartTrajectory);
+    Grid::read(TheReader, "Trajectories",      Trajectories);
+    Grid::read(TheReader, "MetropolisTest",    MetropolisTest);
+    Grid::read(TheReader, "NoMetropolisUntil", NoMetropolisUntil);
+    Grid::read(TheReader, "StartingType",      StartingType);
+    readOptional(TheReader, "TuneTrajectories",   TuneTrajectories);
+    readOptional(TheReader, "TargetAcceptance",   TargetAcceptance);
+    readOptional(TheReader, "TunedParameterFile", TunedParameterFile);
+    Grid::read(TheReader, "MD", MD);
+    TheReader.pop();
+  }
+
+  template <class ReaderClass, class T>
+  static void readOptional(Reader<ReaderClass> &TheReader, const std::string &s, T &output){
+    if (TheReader.push(s)) {
+      TheReader.pop();
+      Grid::read(TheReader, s, output);
+    }
   }
 
 
@@ -83,6 +111,11 @@ struct HMCparameters: Serializable {
     std::cout << GridLogMessage << "[HMC parameters] Metropolis test (on/off): " << std::boolalpha << MetropolisTest << "\n";
     std::cout << GridLogMessage << "[HMC parameters] Thermalization trajs    : " << NoMetropolisUntil << "\n";
     std::cout << GridLogMessage << "[HMC parameters] Starting type           : " << StartingType << "\n";
+    if (TuneTrajectories > 0) {
+    std::cout << GridLogMessage << "[HMC parameters] Integrator tuning trajs : " << TuneTrajectories << "\n";
+    std::cout << GridLogMessage << "[HMC parameters] Target acceptance       : " << TargetAcceptance << "\n";
+    std::cout << GridLogMessage << "[HMC parameters] Tuned parameter file    : " << TunedParameterFile << "\n";
+    }
     MD.print_parameters();
   }
   
@@ -175,6 +208,25 @@ private:
 
   
 
+  /////////////////////////////////////////////////////////
+  // Parameters resuming from the first trajectory after
+  // tuning with the tuned integrator, without tuning again
+  /////////////////////////////////////////////////////////
+  void write_tuned_parameters(unsigned int start) {
+    HMCparameters Tuned(Params);
+    Tuned.MD                = TheIntegrator.getParameters();
+    Tuned.StartingType      = "CheckpointStart";
+    Tuned.StartTrajectory   = start;
+    Tuned.NoMetropolisUntil = 0;
+    Tuned.TuneTrajectories  = 0;
+    if (Ucur.Grid()->IsBoss()) {
+      XmlWriter WR(Params.TunedParameterFile);
+      write(WR, "HMC", Tuned);
+    }
+    Ucur.Grid()->Barrier();
+    std::cout << GridLogMessage << "Tuned HMC parameters written to " << Params.TunedParameterFile << std::endl;
+  }
+
 public:
   /////////////////////////////////////////
   // Constructor
@@ -193,18 +245,35 @@ public:
     Params.print_parameters();
     TheIntegrator.print_actions();
 
+    // Integrator tuning trajectories follow thermalization and precede the requested trajectories
+    unsigned int TuneStart = Params.StartTrajectory + Params.NoMetropolisUntil;
+    unsigned int TuneEnd   = TuneStart + Params.TuneTrajectories;
+    if (TuneEnd > TuneStart) assert(Params.TargetAcceptance > 0.0 && Params.TargetAcceptance < 1.0);
+
     // Actual updates (evolve a copy Ucopy then copy back eventually)
-    unsigned int FinalTrajectory = Params.Trajectories + Params.NoMetropolisUntil + Params.StartTrajectory;
+    unsigned int FinalTrajectory = Params.Trajectories + Params.NoMetropolisUntil + Params.StartTrajectory + (TuneEnd - TuneStart);
     for (int traj = Params.StartTrajectory; traj < FinalTrajectory; ++traj) {
       std::cout << GridLogMessage << "-- # Trajectory = " << traj << "\n";
       if (traj < Params.StartTrajectory + Params.NoMetropolisUntil) {
       	std::cout << GridLogMessage << "-- Thermalization" << std::endl;
       }
+      bool tune = (traj >= TuneStart) && (traj < TuneEnd);
+      if (tune) {
+      	std::cout << GridLogMessage << "-- Integrator tuning" << std::endl;
+      	if (traj == TuneStart) TheIntegrator.StartTuning();
+      }
       
       double t0=usecond();
       Ucopy = Ucur;
 
       DeltaH = evolve_hmc_step(Ucopy);
+      if (tune) {
+        TheIntegrator.TuningTrajectory(DeltaH);
+        if (traj == TuneEnd - 1) {
+          TheIntegrator.FinishTuning(Params.TargetAcceptance);
+          write_tuned_parameters(TuneEnd);
+        }
+      }
       // Metropolis-Hastings test
       bool accept = true;
       if (traj >= Params.StartTrajectory + Params.NoMetropolisUntil) {
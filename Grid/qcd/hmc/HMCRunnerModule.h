@@ -47,7 +47,7 @@ public:
   HMCModule(HMCparameters Par) : Parametrized<HMCparameters>(Par) {}
 
   template <class ReaderCl>
-  HMCModule(Reader<ReaderCl>& R) : Parametrized<HMCparameters>(R, "HMC"){};
+  HMCModule(Reader<ReaderCl>& R) : Parametrized<HMCparameters>(HMCparameters(R)){};
 
   Product* getPtr() {
     if (!HMCPtr) initialize();
@@ -54,4 +54,5 @@ NAMESPACE_CHECK(HMCresourcemanager);
 #include <Grid/qcd/hmc/GenericHMCrunner.h>
 #include <Grid/qcd/hmc/HMCRunnerModule.h>
 NAMESPACE_CHECK(HMCrunner);
+#include <Grid/qcd/hmc/HasenbuschPlanner.h>
 
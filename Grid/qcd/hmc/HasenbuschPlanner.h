@@ -0,0 +1,419 @@
+/*************************************************************************************
+
+Grid physics library, www.github.com/paboyle/Grid
+
+Source file: ./lib/qcd/hmc/HasenbuschPlanner.h
+
+Copyright (C) 2015
+
+This program is free software; you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation; either version 2 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along
+with this program; if not, write to the Free Software Foundation, Inc.,
+51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+
+See the full license in the file "LICENSE" in the top level distribution
+directory
+*************************************************************************************/
+/*  END LEGAL */
+#pragma once
+
+NAMESPACE_BEGIN(Grid);
+
+struct HasenbuschPlannerParameters: Serializable {
+  GRID_SERIALIZABLE_CLASS_MEMBERS(HasenbuschPlannerParameters,
+                                  RealD, light_mass,
+                                  RealD, pv_mass,
+                                  std::vector<RealD>, hasenbusch,    /* @brief Intermediate masses of the reference (current) setup */
+                                  std::vector<Integer>, levels,      /* @brief Reference level of each quotient; empty for level 0 */
+                                  std::vector<RealD>, scan_masses,   /* @brief Candidate intermediate masses; empty for a geometric grid */
+                                  Integer, scan_points,
+                                  Integer, max_hasenbusch,
+                                  Integer, fermion_levels,           /* @brief Levels open to the quotients; 0 for all but the innermost */
+                                  Integer, max_multiplier,
+                                  Integer, samples)
+
+  HasenbuschPlannerParameters() {
+    light_mass     = 0.01;
+    pv_mass        = 1.0;
+    scan_points    = 6;
+    max_hasenbusch = 3;
+    fermion_levels = 0;
+    max_multiplier = 8;
+    samples        = 1;
+  }
+
+  template <class ReaderClass >
+  HasenbuschPlannerParameters(Reader<ReaderClass> & TheReader) : HasenbuschPlannerParameters() {
+    read(TheReader, "HasenbuschPlanner", *this);
+  }
+};
+
+// Output of the planner; read back by the HMC programs
+struct HasenbuschPlan: Serializable {
+  GRID_SERIALIZABLE_CLASS_MEMBERS(HasenbuschPlan,
+                                  RealD, light_mass,
+                                  RealD, pv_mass,
+                                  std::vector<RealD>, hasenbusch,    /* @brief Intermediate masses, lightest first */
+                                  std::vector<Integer>, levels,      /* @brief Level of each quotient, light quotient first */
+                                  std::vector<Integer>, multipliers, /* @brief Multiplier of each level, gauge level last */
+                                  Integer, MDsteps,
+                                  RealD, cost,                       /* @brief Predicted force time per trajectory (ms) */
+                                  RealD, error)                      /* @brief Predicted energy violation relative to the reference */
+
+  HasenbuschPlan() : light_mass(0.0), pv_mass(0.0), MDsteps(0), cost(0.0), error(0.0) {};
+};
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+// Hasenbusch mass preconditioning planner for a chain of two flavour even-odd ratios
+//
+//   det(D(m_l)^2) = det(D(m_l)^2/D(h_1)^2) det(D(h_1)^2/D(h_2)^2) ... det(D(h_n)^2/D(m_pv)^2)
+//
+// On a thermalised configuration it measures, for every pair of masses on a scan grid, the force
+// of the quotient Num(heavier)/Den(lighter): |F| per site as in the integrator log, the largest
+// site force, the CG iterations of the derivative solve and its time. The remaining monomials
+// (gauge, strange, ...) are measured from an ActionSet and keep their levels.
+//
+// Using the error model of IntegratorTuner, <dH^2> ~ sum_l ( |F_l| h_l^p )^2 with |F_l|^2 the
+// summed |F|^2 of level l, every chain of at most max_hasenbusch intermediate masses, every
+// assignment of its quotients to the fermion levels (lighter quotients on coarser levels) and
+// every set of level multipliers is given the fewest outer steps that do not exceed the energy
+// violation of the reference setup. The cheapest plan wins; the reference acceptance carries over.
+///////////////////////////////////////////////////////////////////////////////////////////////////
+template <class FermionImpl, class Gimpl = PeriodicGimplR>
+class HasenbuschPlanner {
+public:
+  typedef typename Gimpl::Field GaugeField;
+  typedef typename FermionImpl::FermionField FermionField;
+  typedef FermionOperator<FermionImpl> FermionOp;
+  typedef TwoFlavourEvenOddRatioPseudoFermionAction<FermionImpl> Quotient;
+  typedef std::function<FermionOp *(RealD)> OperatorFactory;
+
+  HasenbuschPlannerParameters Par;
+  IntegratorParameters MD;
+
+  HasenbuschPlanner(HasenbuschPlannerParameters _Par, IntegratorParameters _MD,
+                    OperatorFactory _Factory, ConjugateGradient<FermionField> &_CG)
+    : Par(_Par), MD(_MD), Factory(_Factory), CG(_CG), grid(nullptr)
+  {
+    assert(Par.light_mass > 0.0 && Par.light_mass < Par.pv_mass);
+    assert(Par.max_multiplier >= 1 && Par.samples >= 1);
+  };
+
+  ~HasenbuschPlanner()
+  {
+    for (auto &op : Ops) delete op.second;
+  }
+
+  // Light mass, candidate intermediates and the Pauli-Villars mass, ascending
+  std::vector<RealD> Masses(void)
+  {
+    std::vector<RealD> scan(Par.scan_masses);
+    if (scan.empty()) {
+      for (int k = 1; k <= Par.scan_points; k++)
+        scan.push_back(Par.light_mass * std::pow(Par.pv_mass / Par.light_mass, (RealD)k / (Par.scan_points + 1)));
+    }
+    scan.insert(scan.end(), Par.hasenbusch.begin(), Par.hasenbusch.end());
+    std::vector<RealD> m({Par.light_mass, Par.pv_mass});
+    for (auto s : scan) {
+      if (s <= Par.light_mass || s >= Par.pv_mass) continue;
+      bool dup = false;
+      for (auto x : m) dup = dup || (std::abs(x - s) <= 1.0e-12 * s);
+      if (!dup) m.push_back(s);
+    }
+    std::sort(m.begin(), m.end());
+    return m;
+  }
+
+  template <class RepresentationPolicy>
+  void Measure(GaugeField &U, ActionSet<GaugeField, RepresentationPolicy> &Fixed,
+               GridSerialRNG &sRNG, GridParallelRNG &pRNG)
+  {
+    grid   = U.Grid();
+    levels = std::max<int>(Fixed.size(), 1);
+    int fl = Par.fermion_levels ? Par.fermion_levels : std::max(levels - 1, 1);
+    levels = std::max(levels, fl);
+    fermionLevels = fl;
+
+    std::vector<RealD> m = Masses();
+    std::cout << GridLogMessage << "[HasenbuschPlanner] masses " << m << " on " << fermionLevels
+              << " fermion levels of " << levels << std::endl;
+
+    GaugeField force(grid);
+    QuotientForce.clear();
+    for (int i = 0; i < m.size(); i++) {
+      for (int j = i + 1; j < m.size(); j++) {
+        Quotient action(*Op(m[j]), *Op(m[i]), CG, CG);
+        MonomialForce f;
+        for (int s = 0; s < Par.samples; s++) {
+          action.refresh(U, sRNG, pRNG);
+          double t0 = usecond();
+          action.deriv(U, force);
+          double t1 = usecond();
+          force = Gimpl::projectForce(force);
+          f.Add(norm2(force) / grid->gSites(), (t1 - t0) / 1.0e3, maxLocalNorm2(force), CG.IterationsToComplete);
+        }
+        QuotientForce[std::make_pair(i, j)] = f;
+        std::cout << GridLogMessage << "[HasenbuschPlanner] quotient " << m[j] << " / " << m[i] << " : |F| " << f.Force()
+                  << " max |F| " << f.MaxForce() << " CG iterations " << f.Iterations() << " force time " << f.Time() << " ms" << std::endl;
+      }
+    }
+    masses = m;
+
+    FixedForce.assign(levels, MonomialForce());
+    FixedMultiplier.assign(levels, 1);
+    for (int level = 0; level < Fixed.size(); ++level) {
+      FixedMultiplier[level] = Fixed[level].multiplier;
+      for (int a = 0; a < Fixed[level].actions.size(); ++a) {
+        Action<GaugeField> *action = Fixed[level].actions.at(a);
+        MonomialForce f;
+        for (int s = 0; s < Par.samples; s++) {
+          action->refresh(U, sRNG, pRNG);
+          double t0 = usecond();
+          action->deriv(U, force);
+          double t1 = usecond();
+          force = Gimpl::projectForce(force);
+          f.Add(norm2(force) / grid->gSites(), (t1 - t0) / 1.0e3, maxLocalNorm2(force));
+        }
+        std::cout << GridLogMessage << "[HasenbuschPlanner] [" << level << "][" << a << "] " << action->action_name()
+                  << " : |F| " << f.Force() << " max |F| " << f.MaxForce() << " force time " << f.Time() << " ms" << std::endl;
+        // Monomials of one level add up like independent forces
+        FixedForce[level].force2 += f.force2 / f.n;
+        FixedForce[level].ms     += f.Time();
+        FixedForce[level].n       = 1;
+      }
+    }
+  }
+
+  // The reference setup given by Par.hasenbusch, Par.levels, MD and the multipliers of the fixed ActionSet
+  HasenbuschPlan Reference(void)
+  {
+    assert(grid != nullptr);
+    HasenbuschPlan ref;
+    ref.light_mass = Par.light_mass;
+    ref.pv_mass    = Par.pv_mass;
+    ref.hasenbusch = Par.hasenbusch;
+    std::sort(ref.hasenbusch.begin(), ref.hasenbusch.end());
+    ref.levels = Par.levels;
+    ref.levels.resize(ref.hasenbusch.size() + 1, 0);
+    for (auto l : ref.levels) assert(l < fermionLevels);
+    ref.multipliers.assign(FixedMultiplier.begin(), FixedMultiplier.end());
+    ref.MDsteps = MD.MDsteps;
+    std::vector<int> chain = Indices(ref.hasenbusch);
+    ref.error = 1.0;
+    ref.cost  = Cost(chain, ref.levels, ref.MDsteps, ref.multipliers);
+    return ref;
+  }
+
+  ///////////////////////////////////////////////////////////////////////////////////////////////
+  // The cheapest plan not exceeding the reference energy violation; the best plan for each
+  // number of intermediate masses is reported
+  ///////////////////////////////////////////////////////////////////////////////////////////////
+  HasenbuschPlan Plan(void)
+  {
+    HasenbuschPlan ref = Reference();
+    std::vector<int> refChain = Indices(ref.hasenbusch);
+    RealD refError = Error(refChain, ref.levels, ref.MDsteps, ref.multipliers);
+    assert(refError > 0.0);
+
+    int K = masses.size() - 2;
+    int maxOuter = std::max<int>(4 * MD.MDsteps, 64);
+    std::vector<HasenbuschPlan> best(std::min<int>(Par.max_hasenbusch, K) + 1);
+    for (auto &b : best) b.MDsteps = 0;
+
+    for (uint64_t subset = 0; subset < (1ULL << K); subset++) {
+      std::vector<int> chain;
+      for (int k = 0; k < K; k++) if ((subset >> k) & 1) chain.push_back(k + 1);
+      if (chain.size() > Par.max_hasenbusch) continue;
+      int nq = chain.size() + 1;
+      HasenbuschPlan &b = best[chain.size()];
+
+      // Non-decreasing levels from the light quotient on
+      std::vector<Integer> lev(nq, 0);
+      while (true) {
+        std::vector<Integer> mult(levels, 1);
+        mult[0] = FixedMultiplier[0];
+        while (true) {
+          RealD unit = Error(chain, lev, 1, mult);
+          for (int n = 1; n <= maxOuter; n++) {
+            // The error falls as n^(-2p); the first n within budget is the cheapest
+            if (unit * std::pow((RealD)n, -2.0 * Order()) > refError) continue;
+            RealD cost = Cost(chain, lev, n, mult);
+            if ((b.MDsteps == 0) || (cost < b.cost)) {
+              b.hasenbusch.clear();
+              for (auto c : chain) b.hasenbusch.push_back(masses[c]);
+              b.levels      = lev;
+              b.multipliers = mult;
+              b.MDsteps     = n;
+              b.cost        = cost;
+              b.error       = unit * std::pow((RealD)n, -2.0 * Order()) / refError;
+            }
+            break;
+          }
+          int l = 1;
+          while (l < levels && mult[l] == Par.max_multiplier) mult[l++] = 1;
+          if (l == levels) break;
+          mult[l]++;
+        }
+        int q = nq - 1;
+        while (q >= 0 && lev[q] == fermionLevels - 1) q--;
+        if (q < 0) break;
+        lev[q]++;
+        for (int r = q + 1; r < nq; r++) lev[r] = lev[q];
+      }
+    }
+
+    std::cout << GridLogMessage << "[HasenbuschPlanner] reference: " << Describe(ref) << std::endl;
+    HasenbuschPlan plan;
+    for (auto &b : best) {
+      if (b.MDsteps == 0) continue;
+      b.light_mass = Par.light_mass;
+      b.pv_mass    = Par.pv_mass;
+      std::cout << GridLogMessage << "[HasenbuschPlanner] " << b.hasenbusch.size() << " intermediate masses: " << Describe(b)
+                << " speed up " << ref.cost / b.cost << std::endl;
+      if ((plan.MDsteps == 0) || (b.cost < plan.cost)) plan = b;
+    }
+    assert(plan.MDsteps > 0);
+    std::cout << GridLogMessage << "[HasenbuschPlanner] plan: " << Describe(plan) << std::endl;
+    Balance(plan);
+    return plan;
+  }
+
+  // Per monomial share of the predicted energy violation
+  void Balance(const HasenbuschPlan &plan)
+  {
+    std::vector<int> chain = Indices(plan.hasenbusch);
+    std::vector<unsigned int> mult(plan.multipliers.begin(), plan.multipliers.end());
+    ForceBalance balance(MD.trajL, plan.MDsteps, mult, LevelForce2(chain, plan.levels), Order());
+    std::vector<int> c = Chain(chain);
+    for (int q = 0; q + 1 < c.size(); q++) {
+      const MonomialForce &f = QuotientForce[std::make_pair(c[q], c[q + 1])];
+      int l = plan.levels[q];
+      std::cout << GridLogMessage << "[HasenbuschPlanner] balance quotient " << masses[c[q + 1]] << " / " << masses[c[q]]
+                << " level " << l << " |F| " << f.Force() << " h " << balance.Step(l)
+                << " share " << balance.Share(l, f.force2 / f.n) << std::endl;
+    }
+    for (int l = 0; l < levels; l++) {
+      if (FixedForce[l].n == 0) continue;
+      std::cout << GridLogMessage << "[HasenbuschPlanner] balance fixed monomials level " << l << " |F| " << FixedForce[l].Force()
+                << " h " << balance.Step(l) << " share " << balance.Share(l, FixedForce[l].force2) << std::endl;
+    }
+  }
+
+  // Parameter file for the HMC: the HMC parameters with the planned MDsteps and the plan
+  void Write(std::string file, HMCparameters HMCpar, const HasenbuschPlan &plan)
+  {
+    HMCpar.MD.MDsteps     = plan.MDsteps;
+    HMCpar.MD.multipliers.assign(plan.multipliers.begin(), plan.multipliers.end());
+    if (grid->IsBoss()) {
+      XmlWriter WR(file);
+      write(WR, "HMC", HMCpar);
+      write(WR, "Hasenbusch", plan);
+    }
+    std::cout << GridLogMessage << "[HasenbuschPlanner] parameters written to " << file << std::endl;
+  }
+
+private:
+  OperatorFactory Factory;
+  ConjugateGradient<FermionField> &CG;
+  GridBase *grid;
+  int levels, fermionLevels;
+  std::map<RealD, FermionOp *> Ops;
+  std::vector<RealD> masses;
+  std::map<std::pair<int, int>, MonomialForce> QuotientForce;
+  std::vector<MonomialForce> FixedForce;
+  std::vector<Integer> FixedMultiplier;
+
+  FermionOp *Op(RealD mass)
+  {
+    if (Ops.find(mass) == Ops.end()) Ops[mass] = Factory(mass);
+    return Ops[mass];
+  }
+
+  int Order(void) { return (MD.name == "ForceGradient") ? 4 : 2; }
+
+  // Force evaluations per step of a level
+  RealD Evaluations(void)
+  {
+    if (MD.name == "LeapFrog") return 1.0;
+    if (MD.name == "ForceGradient") return 3.0;
+    return 2.0;
+  }
+
+  std::vector<int> Indices(const std::vector<RealD> &hasenbusch)
+  {
+    std::vector<int> chain;
+    for (auto h : hasenbusch) {
+      int k = 1;
+      while (k + 1 < masses.size() && std::abs(masses[k] - h) > 1.0e-12 * h) k++;
+      assert(k + 1 < masses.size());
+      chain.push_back(k);
+    }
+    return chain;
+  }
+
+  // Mass indices from light to Pauli-Villars
+  std::vector<int> Chain(const std::vector<int> &chain)
+  {
+    std::vector<int> c({0});
+    c.insert(c.end(), chain.begin(), chain.end());
+    c.push_back(masses.size() - 1);
+    return c;
+  }
+
+  // Summed |F|^2 per level
+  std::vector<RealD> LevelForce2(const std::vector<int> &chain, const std::vector<Integer> &lev)
+  {
+    std::vector<RealD> B(levels);
+    for (int l = 0; l < levels; l++) B[l] = FixedForce[l].force2;
+    std::vector<int> c = Chain(chain);
+    for (int q = 0; q + 1 < c.size(); q++) {
+      const MonomialForce &f = QuotientForce[std::make_pair(c[q], c[q + 1])];
+      B[lev[q]] += f.force2 / f.n;
+    }
+    return B;
+  }
+
+  // IntegratorTuner model; lambda is common to all plans and drops out of the comparison
+  RealD Error(const std::vector<int> &chain, const std::vector<Integer> &lev, int MDsteps, const std::vector<Integer> &mult)
+  {
+    std::vector<RealD> B = LevelForce2(chain, lev);
+    IntegratorTuner model;
+    model.Start(levels);
+    for (int l = 0; l < levels; l++) model.Force(l, B[l], 0.0, true);
+    std::vector<unsigned int> m(mult.begin(), mult.end());
+    return model.Model(MD.trajL, Order(), MDsteps, m, std::vector<RealD>(levels, 0.5));
+  }
+
+  RealD Cost(const std::vector<int> &chain, const std::vector<Integer> &lev, int MDsteps, const std::vector<Integer> &mult)
+  {
+    std::vector<RealD> c(levels);
+    for (int l = 0; l < levels; l++) c[l] = FixedForce[l].ms;
+    std::vector<int> ch = Chain(chain);
+    for (int q = 0; q + 1 < ch.size(); q++) c[lev[q]] += QuotientForce[std::make_pair(ch[q], ch[q + 1])].Time();
+    RealD cost = 0.0, steps = MDsteps;
+    for (int l = 0; l < levels; l++) {
+      steps *= mult[l];
+      cost += Evaluations() * steps * c[l];
+    }
+    return cost;
+  }
+
+  std::string Describe(const HasenbuschPlan &p)
+  {
+    std::stringstream s;
+    s << "masses " << p.hasenbusch << " levels " << p.levels << " multipliers " << p.multipliers
+      << " MDsteps " << p.MDsteps << " force time " << p.cost << " ms/trajectory relative <dH^2> " << p.error;
+    return s.str();
+  }
+};
+
+NAMESPACE_END(Grid);
@@ -88,6 +88,9 @@ public:
                                  GridSerialRNG &sRNG,
                                  GridParallelRNG &pRNG) = 0;
 
+  // Complete any configuration still being written in the background (collective)
+  virtual void CheckpointFlush(void) {};
+
 };  // class BaseHmcCheckpointer
 ///////////////////////////////////////////////////////////////////////////////
 
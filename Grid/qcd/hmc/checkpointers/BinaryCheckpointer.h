@@ -40,6 +40,7 @@ template <class Impl>
 class BinaryHmcCheckpointer : public BaseHmcCheckpointer<Impl> {
 private:
   CheckpointerParameters Params;
+  BinaryIOAsyncHandle pending;
 
 public:
   INHERIT_FIELD_TYPES(Impl);  // Gets the Field type, a Lattice object
@@ -74,7 +75,23 @@ public:
       BinarySimpleUnmunger<sobj_double, sobj> munge;
       truncate(rng);
       BinaryIO::writeRNG(sRNG, pRNG, rng, 0,nersc_csum,scidac_csuma,scidac_csumb);
-      truncate(config);
+      // One rank truncates; the writers wait on a barrier before their first write
+      if (U.Grid()->IsBoss()) truncate(config);
+
+      if ( BinaryIO::asyncWrite ) {
+	auto report = [config](uint32_t nersc_csum,uint32_t scidac_csuma,uint32_t scidac_csumb) {
+	  std::cout << GridLogMessage << "Written Binary Configuration " << config
+		    << " checksum " << std::hex 
+		    << nersc_csum   <<"/"
+		    << scidac_csuma   <<"/"
+		    << scidac_csumb 
+		    << std::dec << std::endl;
+	};
+	BinaryIOAsyncHandle previous = pending;
+	pending = BinaryIO::writeLatticeObjectAsync<vobj, sobj_double>(U, config, munge, 0, Params.format, report);
+	previous.wait();
+	return;
+      }
 
       BinaryIO::writeLatticeObject<vobj, sobj_double>(U, config, munge, 0, Params.format,
 						      nersc_csum,scidac_csuma,scidac_csumb);
@@ -89,7 +106,10 @@ public:
 
   };
 
+  void CheckpointFlush(void) { pending.wait(); };
+
   void CheckpointRestore(int traj, Field &U, GridSerialRNG &sRNG, GridParallelRNG &pRNG) {
+    CheckpointFlush();
     std::string config, rng;
     this->build_filenames(traj, Params, config, rng);
     this->check_filename(rng);
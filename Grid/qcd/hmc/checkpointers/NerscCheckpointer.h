@@ -40,6 +40,7 @@ template <class Gimpl>
 class NerscHmcCheckpointer : public BaseHmcCheckpointer<Gimpl> {
 private:
   CheckpointerParameters Params;
+  BinaryIOAsyncHandle pending;
 
 public:
   INHERIT_GIMPL_TYPES(Gimpl);  // only for gauge configurations
@@ -61,13 +62,23 @@ public:
       int precision32 = 1;
       int tworow = 0;
       NerscIO::writeRNGState(sRNG, pRNG, rng);
-      NerscIO::writeConfiguration<GaugeStats>(U, config, tworow, precision32);
+      if ( BinaryIO::asyncWrite ) {
+	// Previous configuration had a whole trajectory to drain
+	BinaryIOAsyncHandle previous = pending;
+	pending = NerscIO::writeConfigurationAsync<GaugeStats>(U, config, tworow, precision32);
+	previous.wait();
+      } else {
+	NerscIO::writeConfiguration<GaugeStats>(U, config, tworow, precision32);
+      }
     }
   };
 
+  void CheckpointFlush(void) { pending.wait(); };
+
   void CheckpointRestore(int traj, GaugeField &U, GridSerialRNG &sRNG,
                          GridParallelRNG &pRNG) {
     std::string config, rng;
+    CheckpointFlush();
     this->build_filenames(traj, Params, config, rng);
     this->check_filename(rng);
     this->check_filename(config);
@@ -34,6 +34,7 @@ directory
 
 #include <memory>
 #include "MomentumFilter.h"
+#include "IntegratorTuner.h"
 
 NAMESPACE_BEGIN(Grid);
 
@@ -42,7 +43,9 @@ public:
   GRID_SERIALIZABLE_CLASS_MEMBERS(IntegratorParameters,
 				  std::string, name,      // name of the integrator
 				  unsigned int, MDsteps,  // number of outer steps
-				  RealD, trajL)           // trajectory length
+				  RealD, trajL,           // trajectory length
+				  std::vector<RealD>, lambda, // Omelyan parameter per level; empty for the default
+				  std::vector<unsigned int>, multipliers) // level multipliers; empty for those of the action set
 
   IntegratorParameters(int MDsteps_ = 10, RealD trajL_ = 1.0)
   : MDsteps(MDsteps_),
@@ -60,6 +63,10 @@ public:
     std::cout << GridLogMessage << "[Integrator] Trajectory length  : " << trajL << std::endl;
     std::cout << GridLogMessage << "[Integrator] Number of MD steps : " << MDsteps << std::endl;
     std::cout << GridLogMessage << "[Integrator] Step size          : " << trajL/MDsteps << std::endl;
+    if (lambda.size())
+    std::cout << GridLogMessage << "[Integrator] Lambda per level   : " << lambda << std::endl;
+    if (multipliers.size())
+    std::cout << GridLogMessage << "[Integrator] Level multipliers  : " << multipliers << std::endl;
   }
 };
 
@@ -84,7 +91,16 @@ protected:
   //The default filter does nothing
   MomentumFilterBase<MomentaField> const* MomFilter;
 
-  const ActionSet<Field, RepresentationPolicy> as;
+  ActionSet<Field, RepresentationPolicy> as;  // level multipliers may be retuned
+
+  // Warm-up statistics for step size tuning
+  IntegratorTuner    Tuner;
+  bool               tuning;
+  std::vector<Field> startForce;   // level forces before the first U update
+  std::vector<bool>  startRecorded;
+
+  // Per monomial forces of the current trajectory, for the force balance report
+  std::vector<std::vector<MonomialForce> > forceLog;
 
   //Get a pointer to a shared static instance of the "do-nothing" momentum filter to serve as a default
   static MomentumFilterBase<MomentaField> const* getDefaultMomFilter(){ 
@@ -123,6 +139,14 @@ protected:
     // input U actually not used in the fundamental case
     // Fundamental updates, include smearing
 
+    bool momentum = (&Mom == &P);       // not a force gradient update
+    std::unique_ptr<Field> levelForce;  // only summed while tuning
+    if (tuning) {
+      levelForce.reset(new Field(U.Grid()));
+      *levelForce = Zero();
+    }
+    double level_time = 0.0;
+
     for (int a = 0; a < as[level].actions.size(); ++a) {
       double start_full = usecond();
       Field force(U.Grid());
@@ -139,15 +163,26 @@ protected:
       Real force_abs = std::sqrt(norm2(force)/U.Grid()->gSites());
       std::cout << GridLogIntegrator << "["<<level<<"]["<<a<<"] Force average: " << force_abs << std::endl;
       Mom -= force * ep* HMC_MOMENTUM_DENOMINATOR;; 
+      if (tuning) *levelForce += force;
       double end_full = usecond();
       double time_full  = (end_full - start_full) / 1e3;
       double time_force = (end_force - start_force) / 1e3;
+      level_time += time_force;
+      if (momentum) forceLog[level][a].Add(force_abs*force_abs, time_force);
       std::cout << GridLogMessage << "["<<level<<"]["<<a<<"] P update elapsed time: " << time_full << " ms (force: " << time_force << " ms)"  << std::endl;
     }
 
     // Force from the other representations
     as[level].apply(update_P_hireps, Representations, Mom, U, ep);
 
+    if (tuning) {
+      Tuner.Force(level, norm2(*levelForce)/U.Grid()->gSites(), level_time, momentum);
+      if (momentum && (t_U == 0.0) && !startRecorded[level]) {
+        startForce[level] = *levelForce;
+        startRecorded[level] = true;
+      }
+    }
+
     MomFilter->applyFilter(Mom);
   }
 
@@ -174,6 +209,12 @@ protected:
 
   virtual void step(Field& U, int level, int first, int last) = 0;
 
+  // Order of the energy violation in the step size, and whether lambda is a free parameter
+  virtual int  order(void) { return 2; }
+  virtual bool tunable_lambda(void) { return false; }
+  // Omelyan parameter of a level; leapfrog is lambda=1/2 in the same error expansion
+  virtual RealD lambda(int level) { return 0.5; }
+
 public:
   Integrator(GridBase* grid, IntegratorParameters Par,
              ActionSet<Field, RepresentationPolicy>& Aset,
@@ -183,10 +224,17 @@ public:
       P(grid),
       levels(Aset.size()),
       Smearer(Sm),
-      Representations(grid) 
+      Representations(grid),
+      tuning(false)
   {
     t_P.resize(levels, 0.0);
     t_U = 0.0;
+    forceLog.resize(levels);
+    // Multipliers of a tuned parameter file replace those of the action set
+    if (Params.multipliers.size()) {
+      assert(Params.multipliers.size() == levels);
+      for (int level = 0; level < levels; ++level) as[level].multiplier = Params.multipliers[level];
+    }
     // initialization of smearer delegated outside of Integrator
 
     //Default the momentum filter to "do-nothing"
@@ -204,6 +252,52 @@ public:
 
   //Access the conjugate momentum
   const MomentaField & getMomentum() const{ return P; }
+
+  //Access the (possibly tuned) parameters and level multipliers
+  const IntegratorParameters & getParameters() const{ return Params; }
+  unsigned int getMultiplier(int level) const{ return as[level].multiplier; }
+
+  //////////////////////////////////////////////////////////////////
+  // Step size tuning; see IntegratorTuner. Statistics are gathered
+  // from StartTuning until FinishTuning, which retunes the outer step
+  // count, the inner level multipliers and (MinimumNorm2) lambda.
+  //////////////////////////////////////////////////////////////////
+  void StartTuning(void)
+  {
+    Tuner.Start(levels);
+    startForce.assign(levels, Field(P.Grid()));
+    startRecorded.assign(levels, false);
+    tuning = true;
+  }
+  void TuningTrajectory(RealD dH) { if (tuning) Tuner.Trajectory(dH); }
+  void FinishTuning(RealD TargetAcceptance)
+  {
+    if (!tuning) return;
+    tuning = false;
+    std::vector<unsigned int> mult(levels);
+    std::vector<RealD> lam(levels);
+    for (int level = 0; level < levels; ++level) {
+      mult[level] = as[level].multiplier;
+      lam[level]  = lambda(level);
+    }
+    Tuner.Tune(TargetAcceptance, Params.trajL, order(), tunable_lambda(), Params.MDsteps, mult, lam);
+    for (int level = 0; level < levels; ++level) as[level].multiplier = mult[level];
+    Params.multipliers = mult;
+    if (tunable_lambda()) Params.lambda = lam;
+    startForce.clear();
+    print_parameters();
+  }
+  // Acceptance the tuning model predicts for MDsteps outer steps with the current multipliers and lambda
+  RealD PredictedAcceptance(unsigned int MDsteps)
+  {
+    std::vector<unsigned int> mult(levels);
+    std::vector<RealD> lam(levels);
+    for (int level = 0; level < levels; ++level) {
+      mult[level] = as[level].multiplier;
+      lam[level]  = lambda(level);
+    }
+    return Tuner.Acceptance(Params.trajL, order(), MDsteps, mult, lam);
+  }
   
 
   void print_parameters()
@@ -227,6 +321,32 @@ public:
 
   }
 
+  //////////////////////////////////////////////////////////////////
+  // Force balance of the last trajectory: per monomial the mean |F|,
+  // the step h of its level and its share of the leading energy
+  // violation (see ForceBalance). Balanced monomials have similar
+  // shares; a dominant share asks for a finer level.
+  //////////////////////////////////////////////////////////////////
+  void print_force_balance()
+  {
+    std::vector<unsigned int> mult(levels);
+    std::vector<RealD> force2(levels, 0.0);
+    for (int level = 0; level < levels; ++level) {
+      mult[level] = as[level].multiplier;
+      for (int a = 0; a < forceLog[level].size(); ++a) force2[level] += forceLog[level][a].force2 / std::max(forceLog[level][a].n, 1);
+    }
+    ForceBalance balance(Params.trajL, Params.MDsteps, mult, force2, order());
+    for (int level = 0; level < levels; ++level) {
+      for (int a = 0; a < forceLog[level].size(); ++a) {
+        const MonomialForce &f = forceLog[level][a];
+        if (f.n == 0) continue;
+        std::cout << GridLogIntegrator << "[Integrator] Force balance [" << level << "][" << a << "] "
+                  << as[level].actions.at(a)->action_name() << " : |F| " << f.Force() << " h " << balance.Step(level)
+                  << " share " << balance.Share(level, f.force2 / f.n) << " evaluations " << f.n << " force time " << f.ms << " ms" << std::endl;
+      }
+    }
+  }
+
   void reverse_momenta()
   {
     P *= -1.0;
@@ -327,6 +447,8 @@ public:
     for (int level = 0; level < as.size(); ++level) {
       t_P[level] = 0;
     }
+    if (tuning) startRecorded.assign(levels, false);
+    for (int level = 0; level < levels; ++level) forceLog[level].assign(as[level].actions.size(), MonomialForce());
 
     for (int stp = 0; stp < Params.MDsteps; ++stp) {  // MD step
       int first_step = (stp == 0);
@@ -342,9 +464,20 @@ public:
 
     FieldImplementation::Project(U);
 
+    // Correlation of each level force with the total force at the start
+    if (tuning) {
+      Field total(U.Grid());
+      total = Zero();
+      for (int level = 0; level < levels; ++level) total += startForce[level];
+      for (int level = 0; level < levels; ++level)
+        Tuner.Correlation(level, real(innerProduct(startForce[level], total))/U.Grid()->gSites());
+    }
+
     // and that we indeed got to the end of the trajectory
     assert(fabs(t_U - Params.trajL) < 1.0e-6);
 
+    if (GridLogIntegrator.isActive()) print_force_balance();
+
   }
 
 };
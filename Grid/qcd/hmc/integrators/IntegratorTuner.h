@@ -0,0 +1,250 @@
+/*************************************************************************************
+
+Grid physics library, www.github.com/paboyle/Grid
+
+Source file: ./lib/qcd/hmc/integrators/IntegratorTuner.h
+
+Copyright (C) 2015
+
+This program is free software; you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation; either version 2 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along
+with this program; if not, write to the Free Software Foundation, Inc.,
+51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+
+See the full license in the file "LICENSE" in the top level distribution
+directory
+*************************************************************************************/
+/*  END LEGAL */
+#pragma once
+
+NAMESPACE_BEGIN(Grid);
+
+// Force statistics of one monomial: |F|^2 per site as in the integrator log, the largest
+// site |F|^2 (when measured), solver iterations (when known) and the force time
+struct MonomialForce {
+  RealD force2, max2, ms, iters;
+  int   n;
+  MonomialForce() : force2(0.0), max2(0.0), ms(0.0), iters(0.0), n(0) {};
+
+  void Add(RealD f2,RealD t,RealD m2=0.0,RealD it=0.0)
+  {
+    force2 += f2; ms += t; iters += it; n++;
+    max2 = std::max(max2,m2);
+  }
+  RealD Force(void)      const { return n ? std::sqrt(force2/n) : 0.0; }
+  RealD MaxForce(void)   const { return std::sqrt(max2); }
+  RealD Time(void)       const { return n ? ms/n : 0.0; }
+  RealD Iterations(void) const { return n ? iters/n : 0.0; }
+};
+
+// Share of a force in the leading energy violation sum_l |F_l|^2 h_l^(2p) of a nested integrator,
+// given the summed |F|^2 of each level; used by the force balance reports
+class ForceBalance {
+public:
+  ForceBalance(RealD trajL,int MDsteps,const std::vector<unsigned int> &mult,const std::vector<RealD> &levelForce2,int _order)
+    : order(_order), total(0.0), h(mult.size())
+  {
+    RealD hl = trajL/MDsteps;
+    for(int l=0;l<h.size();l++){
+      h[l]   = (hl /= mult[l]);
+      total += levelForce2[l]*std::pow(h[l],2*order);
+    }
+  }
+  RealD Step(int level) const { return h[level]; }
+  RealD Share(int level,RealD force2) const { return (total>0.0) ? force2*std::pow(h[level],2*order)/total : 0.0; }
+
+private:
+  int order;
+  RealD total;
+  std::vector<RealD> h;
+};
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+// Step size tuning of a nested integrator from warm-up statistics.
+//
+// Per level l the tuner accumulates the force norm B_l = <|F_l|^2>, the correlation with the
+// total force at the start of each trajectory A_l = <F_l.F>, and the force cost per trajectory;
+// per trajectory it records dH.
+//
+// Model: each level contributes independently to the energy violation,
+//     <dH^2> = kappa^2 sum_l ( N(lambda_l) sqrt(B_l) h_l^p )^2 ,
+// with p the order of the integrator and N the norm of the coefficients of the leading
+// Poisson brackets of the Omelyan scheme, N = |( (6l^2-6l+1)/12 , (1-6l)/24 )| (leapfrog is
+// lambda=1/2); kappa is fitted to the measured <dH^2>. The acceptance of a trajectory is
+// erfc( sqrt(<dH^2>/8) ).
+//
+// Lambda is chosen per level to cancel the equilibrium average of the leading error term,
+// alpha <{T,{T,S_l}}> + beta <{S_l,{S_l,T}}>, using <{T,{T,S_l}}> = A_l and <{S_l,{S_l,T}}> = B_l;
+// for a single level this gives 0.191, next to the minimum norm value. The steps are the
+// cheapest outer step count and level multipliers whose predicted acceptance meets the target.
+///////////////////////////////////////////////////////////////////////////////////////////////////
+class IntegratorTuner {
+public:
+  IntegratorTuner() : levels(0), kappa2(-1.0) {};
+
+  void Start(int _levels)
+  {
+    levels = _levels;
+    B.assign(levels,0.0); nB.assign(levels,0);
+    A.assign(levels,0.0); nA.assign(levels,0);
+    cost.assign(levels,0.0);
+    dH.resize(0);
+    kappa2 = -1.0;
+  }
+
+  // One force evaluation on level: |F|^2 per site (only for the HMC momentum) and its cost
+  void Force(int level,RealD force2,RealD ms,bool momentum)
+  {
+    if ( momentum ) { B[level] += force2; nB[level]++; }
+    cost[level] += ms;
+  }
+  void Correlation(int level,RealD fdotf) { A[level] += fdotf; nA[level]++; }
+  void Trajectory(RealD _dH)              { dH.push_back(_dH); }
+  int  Trajectories(void)                 { return dH.size(); }
+
+  static RealD ErrorNorm(RealD lambda)
+  {
+    RealD alpha = (6.0*lambda*lambda-6.0*lambda+1.0)/12.0;
+    RealD beta  = (1.0-6.0*lambda)/24.0;
+    return std::sqrt(alpha*alpha+beta*beta);
+  }
+
+  // Root of alpha r + beta = 0 in [1/6,1/4]
+  static RealD OptimalLambda(RealD r)
+  {
+    RealD lambda = 1.0/6.0;
+    if ( r > 0.0 ) {
+      RealD b = 12.0*r+6.0;
+      lambda = (b-std::sqrt(b*b-48.0*r*(2.0*r+1.0)))/(24.0*r);
+    }
+    return std::min(std::max(lambda,1.0/6.0),0.25);
+  }
+
+  static RealD AcceptanceToVariance(RealD acc)
+  {
+    assert(acc>0.0 && acc<1.0);
+    RealD lo=0.0, hi=10.0;
+    for(int i=0;i<100;i++){
+      RealD x = 0.5*(lo+hi);
+      if ( std::erfc(x) > acc ) lo = x;
+      else                      hi = x;
+    }
+    return 8.0*lo*lo;
+  }
+
+  // Predicted <dH^2> for outer steps and multipliers, in units of kappa^2
+  RealD Model(RealD trajL,int order,int MDsteps,const std::vector<unsigned int> &mult,const std::vector<RealD> &lambda)
+  {
+    RealD h = trajL/MDsteps;
+    RealD m = 0.0;
+    for(int l=0;l<levels;l++){
+      h /= mult[l];
+      RealD e = ErrorNorm(lambda[l])*std::sqrt(B[l]/nB[l])*std::pow(h,order);
+      m += e*e;
+    }
+    return m;
+  }
+
+  // Replace MDsteps, the inner level multipliers and (when tunable) the lambdas by tuned values
+  void Tune(RealD target,RealD trajL,int order,bool tuneLambda,
+	    unsigned int &MDsteps,std::vector<unsigned int> &mult,std::vector<RealD> &lambda)
+  {
+    int ntraj = dH.size();
+    assert(ntraj>0);
+    for(int l=0;l<levels;l++) assert(nB[l]>0);
+
+    RealD var=0.0;
+    for(int t=0;t<ntraj;t++) var += dH[t]*dH[t];
+    var /= ntraj;
+
+    std::vector<RealD> newLambda(lambda);
+    if ( tuneLambda ) {
+      for(int l=0;l<levels;l++) {
+	RealD r = nA[l] ? (A[l]/nA[l])/(B[l]/nB[l]) : 1.0;
+	newLambda[l] = OptimalLambda(r);
+      }
+    }
+
+    if ( var<=0.0 ) {
+      kappa2 = 0.0;
+      std::cout << GridLogMessage << "[IntegratorTuner] no energy violation measured; keeping the current integrator"<<std::endl;
+      return;
+    }
+    kappa2          = var/Model(trajL,order,MDsteps,mult,lambda);
+    RealD varTarget = AcceptanceToVariance(target);
+
+    // Force evaluations on level l scale with the number of steps on it
+    std::vector<RealD> c(levels);
+    for(int l=0;l<levels;l++) c[l] = cost[l]/ntraj;
+
+    int   maxOuter = std::max(4*(int)MDsteps,64);
+    const int maxMult = 16;
+    std::vector<unsigned int> trial(mult), best(mult);
+    int   bestSteps=-1;
+    RealD bestCost=0.0, bestVar=0.0;
+    std::function<void(int)> search = [&](int l) {
+      if ( l<levels ) {
+	for(int m=1;m<=maxMult;m++){ trial[l]=m; search(l+1); }
+	return;
+      }
+      for(int n=1;n<=maxOuter;n++){
+	RealD v = kappa2*Model(trajL,order,n,trial,newLambda);
+	if ( v > varTarget ) continue;
+	RealD cst=0.0, ratio=(RealD)n/MDsteps;
+	for(int k=0;k<levels;k++){
+	  if ( k ) ratio *= (RealD)trial[k]/mult[k];
+	  cst += c[k]*ratio;
+	}
+	if ( (bestSteps<0) || (cst<bestCost) ) {
+	  bestSteps=n; best=trial; bestCost=cst; bestVar=v;
+	}
+	break; // more outer steps only cost more
+      }
+    };
+    search(1);
+
+    std::cout << GridLogMessage << "[IntegratorTuner] "<<ntraj<<" trajectories <dH^2> = "<<var
+	      <<" acceptance estimate "<<std::erfc(std::sqrt(var/8.0))<<std::endl;
+    for(int l=0;l<levels;l++){
+      std::cout << GridLogMessage << "[IntegratorTuner] level "<<l<<" |F| "<<std::sqrt(B[l]/nB[l])
+		<<" <F_l.F>/<F_l.F_l> "<<(nA[l] ? (A[l]/nA[l])/(B[l]/nB[l]) : 0.0)
+		<<" cost/trajectory "<<c[l]<<" ms"<<std::endl;
+    }
+    if ( bestSteps<0 ) {
+      std::cout << GridLogMessage << "[IntegratorTuner] no setting within the search range reaches acceptance "
+		<<target<<"; keeping the current integrator"<<std::endl;
+      return;
+    }
+    MDsteps = bestSteps;
+    mult    = best;
+    lambda  = newLambda;
+    std::cout << GridLogMessage << "[IntegratorTuner] MDsteps "<<MDsteps<<" multipliers "<<mult
+	      <<" lambda "<<lambda<<" predicted acceptance "<<std::erfc(std::sqrt(bestVar/8.0))
+	      <<" cost/trajectory "<<bestCost<<" ms"<<std::endl;
+  }
+
+  // Acceptance the model fitted by the last Tune predicts for a setting
+  RealD Acceptance(RealD trajL,int order,int MDsteps,const std::vector<unsigned int> &mult,const std::vector<RealD> &lambda)
+  {
+    assert(kappa2>=0.0);
+    return std::erfc(std::sqrt(kappa2*Model(trajL,order,MDsteps,mult,lambda)/8.0));
+  }
+
+private:
+  int levels;
+  RealD kappa2;
+  std::vector<RealD> B, A, cost;
+  std::vector<int>   nB, nA;
+  std::vector<RealD> dH;
+};
+
+NAMESPACE_END(Grid);
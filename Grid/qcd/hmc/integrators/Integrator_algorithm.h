@@ -139,11 +139,16 @@ template <class FieldImplementation, class SmearingPolicy, class RepresentationP
 class MinimumNorm2 : public Integrator<FieldImplementation, SmearingPolicy, RepresentationPolicy> 
 {
 private:
-  const RealD lambda = 0.1931833275037836;
+  const RealD default_lambda = 0.1931833275037836;
 
 public:
   INHERIT_FIELD_TYPES(FieldImplementation);
 
+  bool tunable_lambda(void) { return true; }
+  RealD lambda(int level) {
+    return (this->Params.lambda.size() > level) ? this->Params.lambda[level] : default_lambda;
+  }
+
   MinimumNorm2(GridBase* grid, IntegratorParameters Par, ActionSet<Field, RepresentationPolicy>& Aset, SmearingPolicy& Sm)
     : Integrator<FieldImplementation, SmearingPolicy, RepresentationPolicy>(grid, Par, Aset, Sm){};
 
@@ -159,6 +164,8 @@ public:
     RealD eps = this->Params.trajL/this->Params.MDsteps * 2.0;
     for (int l = 0; l <= level; ++l) eps /= 2.0 * this->as[l].multiplier;
 
+    const RealD lambda = this->lambda(level);
+
     // Nesting:  2xupdate_U of size eps/2
     // Next level is eps/2/multiplier
 
@@ -212,6 +219,8 @@ public:
 									    grid, Par, Aset, Sm){};
 
   std::string integrator_name(){return "ForceGradient";}
+
+  int order(void) { return 4; }
   
   void FG_update_P(Field& U, int level, double fg_dt, double ep) {
     Field Ufg(U.Grid());
@@ -119,6 +119,17 @@ class ConjugateGradientModule: public SolverModule<ConjugateGradient, Field, Sol
   }
 };
 
+template <class Field >
+class ConjugateGradientPipelinedModule: public SolverModule<ConjugateGradientPipelined, Field, SolverParameters> {
+  typedef SolverModule<ConjugateGradientPipelined, Field, SolverParameters> SolverBase;
+  using SolverBase::SolverBase; // for constructors
+
+  // acquire resource
+  virtual void initialize(){
+    this->SolverPtr.reset(new ConjugateGradientPipelined<Field>(this->Par_.tolerance, this->Par_.max_iterations, true));
+  }
+};
+
 template <class Field >
 class BiCGSTABModule: public SolverModule<BiCGSTAB, Field, SolverParameters> {
   typedef SolverModule<BiCGSTAB, Field, SolverParameters> SolverBase;
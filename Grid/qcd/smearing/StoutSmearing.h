@@ -131,8 +131,8 @@ public:
     LatticeComplex u(grid), w(grid);
     LatticeComplex f0(grid), f1(grid), f2(grid);
 
-    iQ2 = iQ * iQ;
-    iQ3 = iQ * iQ2;
+    fusedEval(fusedAssign(iQ2, iQ * iQ),
+	      fusedAssign(iQ3, iQ * iQ2));
 
     //We should check sgn(c0) here already and then apply eq (34) from 0311018
     set_uw(u, w, iQ2, iQ3);
@@ -150,17 +150,16 @@ public:
     LatticeComplex c0(grid), c1(grid), tmp(grid), c0max(grid), theta(grid);
 
     // sign in c0 from the conventions on the Ta
-    c0 = -imag(trace(iQ3)) * one_over_three;  
-    c1 = -real(trace(iQ2)) * one_over_two;
-
-    // Cayley Hamilton checks to machine precision, tested
-    tmp = c1 * one_over_three;
+    fusedEval(fusedAssign(c0, -imag(trace(iQ3)) * one_over_three),
+	      fusedAssign(c1, -real(trace(iQ2)) * one_over_two),
+	      // Cayley Hamilton checks to machine precision, tested
+	      fusedAssign(tmp, c1 * one_over_three));
     c0max = 2.0 * pow(tmp, 1.5);
 
-    theta = acos(c0 / c0max) *
-      one_over_three;  // divide by three here, now leave as it is
-    u = sqrt(tmp) * cos(theta);
-    w = sqrt(c1) * sin(theta);
+    fusedEval(fusedAssign(theta, acos(c0 / c0max) *
+			  one_over_three),  // divide by three here, now leave as it is
+	      fusedAssign(u, sqrt(tmp) * cos(theta)),
+	      fusedAssign(w, sqrt(c1) * sin(theta)));
   }
 
   void set_fj(LatticeComplex& f0, LatticeComplex& f1, LatticeComplex& f2,
@@ -174,23 +173,22 @@ public:
     unity = 1.0;
 
     xi0 = func_xi0(w);
-    u2 = u * u;
-    w2 = w * w;
-    cosw = cos(w);
-
-    ixi0 = timesI(xi0);
-    emiu = cos(u) - timesI(sin(u));
-    e2iu = cos(2.0 * u) + timesI(sin(2.0 * u));
-
-    h0 = e2iu * (u2 - w2) +
-      emiu * ((8.0 * u2 * cosw) + (2.0 * u * (3.0 * u2 + w2) * ixi0));
-    h1 = e2iu * (2.0 * u) - emiu * ((2.0 * u * cosw) - (3.0 * u2 - w2) * ixi0);
-    h2 = e2iu - emiu * (cosw + (3.0 * u) * ixi0);
-
-    fden = unity / (9.0 * u2 - w2);  // reals
-    f0 = h0 * fden;
-    f1 = h1 * fden;
-    f2 = h2 * fden;
+
+    // One pass over the site data for all intermediates
+    fusedEval(fusedAssign(u2, u * u),
+	      fusedAssign(w2, w * w),
+	      fusedAssign(cosw, cos(w)),
+	      fusedAssign(ixi0, timesI(xi0)),
+	      fusedAssign(emiu, cos(u) - timesI(sin(u))),
+	      fusedAssign(e2iu, cos(2.0 * u) + timesI(sin(2.0 * u))),
+	      fusedAssign(h0, e2iu * (u2 - w2) +
+			  emiu * ((8.0 * u2 * cosw) + (2.0 * u * (3.0 * u2 + w2) * ixi0))),
+	      fusedAssign(h1, e2iu * (2.0 * u) - emiu * ((2.0 * u * cosw) - (3.0 * u2 - w2) * ixi0)),
+	      fusedAssign(h2, e2iu - emiu * (cosw + (3.0 * u) * ixi0)),
+	      fusedAssign(fden, unity / (9.0 * u2 - w2)),  // reals
+	      fusedAssign(f0, h0 * fden),
+	      fusedAssign(f1, h1 * fden),
+	      fusedAssign(f2, h2 * fden));
   }
 
   LatticeComplex func_xi0(const LatticeComplex& w) const {
@@ -181,7 +181,7 @@ void A2Autils<FImpl>::MesonField(TensorType &mat,
     for(int n=0;n<e1;n++){
       for(int b=0;b<e2;b++){
 
-	int ss= so+n*stride+b;
+	int ss= grid->oIndexFromLex(so+n*stride+b);
 
 	for(int i=0;i<Lblock;i++){
 
@@ -367,7 +367,7 @@ void A2Autils<FImpl>::PionFieldXX(Eigen::Tensor<ComplexD,3> &mat,
     for(int n=0;n<e1;n++){
       for(int b=0;b<e2;b++){
 
-	int ss= so+n*stride+b;
+	int ss= grid->oIndexFromLex(so+n*stride+b);
 
 	for(int i=0;i<Lblock;i++){
 
@@ -514,7 +514,7 @@ void A2Autils<FImpl>::PionFieldWVmom(Eigen::Tensor<ComplexD,4> &mat,
     for(int n=0;n<e1;n++){
       for(int b=0;b<e2;b++){
 
-	int ss= so+n*stride+b;
+	int ss= grid->oIndexFromLex(so+n*stride+b);
 
 	for(int i=0;i<Lblock;i++){
 
@@ -726,7 +726,7 @@ void A2Autils<FImpl>::AslashField(TensorType &mat,
         for(int n=0;n<e1;n++)
         for(int b=0;b<e2;b++)
         {
-            int ss= so+n*stride+b;
+            int ss= grid->oIndexFromLex(so+n*stride+b);
 
             for(int i=0;i<Lblock;i++)
             {
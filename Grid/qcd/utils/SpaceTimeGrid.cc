@@ -59,7 +59,10 @@ GridCartesian         *SpaceTimeGrid::makeFiveDimGrid(int Ls,const GridCartesian
     simd5.push_back(FourDimGrid->_simd_layout[d]);
     mpi5.push_back(FourDimGrid->_processors[d]);
   }
-  return new GridCartesian(latt5,simd5,mpi5,*FourDimGrid); 
+  GridCartesian *ret = new GridCartesian(latt5,simd5,mpi5,*FourDimGrid);
+  // s-innermost: 5d site = 4d site * Ls + s, so the 5d layout follows the 4d one
+  ret->InheritSiteLayout(FourDimGrid);
+  return ret;
 }
 
 
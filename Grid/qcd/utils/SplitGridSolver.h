@@ -0,0 +1,194 @@
+/*************************************************************************************
+
+    Grid physics library, www.github.com/paboyle/Grid
+
+    Source file: ./lib/qcd/utils/SplitGridSolver.h
+
+    Copyright (C) 2015
+
+Author: Peter Boyle <paboyle@ph.ed.ac.uk>
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License along
+    with this program; if not, write to the Free Software Foundation, Inc.,
+    51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+
+    See the full license in the file "LICENSE" in the top level distribution directory
+*************************************************************************************/
+/*  END LEGAL */
+#pragma once
+
+NAMESPACE_BEGIN(Grid);
+
+struct SplitGridSolverParams : Serializable {
+public:
+  GRID_SERIALIZABLE_CLASS_MEMBERS(SplitGridSolverParams,
+				  std::vector<int>, split,   /* ranks per subgrid in each dimension; empty chooses */
+				  int, maxLocalSites);       /* largest 4d local volume an automatic split may create */
+  SplitGridSolverParams(std::vector<int> _split = std::vector<int>(),
+			int _maxLocalSites = 16*16*16*16)
+    : split(_split), maxLocalSites(_maxLocalSites) {};
+};
+
+// The grids a solver factory builds its operator on; the 5d pair is null for 4d problems
+struct SplitGrids {
+  GridCartesian         *UGrid;
+  GridRedBlackCartesian *UrbGrid;
+  GridCartesian         *FGrid;
+  GridRedBlackCartesian *FrbGrid;
+};
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+// Batch of independent solves on subcommunicators.
+//
+// The processor grid is divided into nsplit copies of a smaller one; the gauge field is
+// replicated onto every copy, nsplit sources are solved at a time (one per copy) and the
+// solutions are returned to the parent grid. The factory is called once per subgrid with
+// the replicated gauge field and returns the solve to apply; it owns whatever operator and
+// solver it builds. Solutions on entry are used as initial guesses.
+//
+// Unless params.split is given, nsplit is the largest number of copies, no more than the
+// number of sources, whose local volume stays within params.maxLocalSites; among splits
+// giving the same number of copies the one with least surface wins.
+///////////////////////////////////////////////////////////////////////////////////////////////////
+template<class GaugeField,class Field>
+class SplitGridSolver {
+public:
+  typedef std::function<void(const Field &src,Field &sol)>              SolveFn;
+  typedef std::function<SolveFn(GaugeField &Umu,const SplitGrids &grids)> SolverFactory;
+
+  SplitGridSolver(GaugeField &_Umu,SolverFactory _factory,
+		  const SplitGridSolverParams &_params = SplitGridSolverParams())
+    : Umu(_Umu), factory(_factory), params(_params) {};
+
+  // Ranks per subgrid in each dimension for nsrc sources
+  Coordinate ChooseSplit(int nsrc)
+  {
+    GridBase  *UGrid = Umu.Grid();
+    int        nd    = UGrid->_ndimension;
+    Coordinate mpi   = UGrid->ProcessorGrid();
+    Coordinate latt  = UGrid->FullDimensions();
+
+    if ( params.split.size() ) {
+      assert(params.split.size()==nd);
+      Coordinate split(nd);
+      for(int d=0;d<nd;d++) {
+	split[d] = params.split[d];
+	assert(mpi[d]%split[d]==0);
+      }
+      return split;
+    }
+
+    // Unsplit (copies==1) is always admissible, so best is always set
+    Coordinate simd  = UGrid->_simd_layout;
+    Coordinate best = mpi, split(nd), c(nd);
+    int64_t bestCopies=0, bestSurface=0;
+    int ncand=1;
+    for(int d=0;d<nd;d++) ncand*=mpi[d];
+    for(int i=0;i<ncand;i++){
+      Lexicographic::CoorFromIndex(c,i,mpi);
+      int64_t copies=1, lsites=1, surface=0;
+      bool ok=true;
+      for(int d=0;d<nd;d++){
+	split[d] = c[d]+1;
+	ok = ok && (mpi[d]%split[d]==0) && (latt[d]%(split[d]*simd[d])==0);
+      }
+      if ( !ok ) continue;
+      for(int d=0;d<nd;d++){
+	copies *= mpi[d]/split[d];
+	lsites *= latt[d]/split[d];
+      }
+      for(int d=0;d<nd;d++) if ( split[d]>1 ) surface += lsites/(latt[d]/split[d]);
+      if ( copies>nsrc ) continue;
+      if ( (copies>1) && (lsites>params.maxLocalSites) ) continue;
+      bool better = (copies>bestCopies) || ( (copies==bestCopies) && (surface<bestSurface) );
+      if ( better ) {
+	best = split; bestCopies = copies; bestSurface = surface;
+      }
+    }
+    return best;
+  }
+
+  void operator() (const std::vector<Field> &src,std::vector<Field> &sol)
+  {
+    int nsrc = src.size();
+    assert(nsrc>0);
+    assert(sol.size()==nsrc);
+
+    GridCartesian *UGrid = (GridCartesian *)Umu.Grid();
+    GridBase      *FGrid = src[0].Grid();
+    int nd  = UGrid->_ndimension;
+    int Ls  = (FGrid->_ndimension==nd+1) ? FGrid->_fdimensions[0] : 0;
+    assert(!FGrid->_isCheckerBoarded);
+
+    Coordinate split = ChooseSplit(nsrc);
+    int nsplit = UGrid->_Nprocessors;
+    for(int d=0;d<nd;d++) nsplit/=split[d];
+
+    GridStopWatch setup, solve, transfer;
+    setup.Start();
+    SplitGrids grids;
+    grids.UGrid   = new GridCartesian(UGrid->FullDimensions(),UGrid->_simd_layout,split,*UGrid);
+    grids.UrbGrid = SpaceTimeGrid::makeFourDimRedBlackGrid(grids.UGrid);
+    grids.FGrid   = Ls ? SpaceTimeGrid::makeFiveDimGrid(Ls,grids.UGrid)          : nullptr;
+    grids.FrbGrid = Ls ? SpaceTimeGrid::makeFiveDimRedBlackGrid(Ls,grids.UGrid)  : nullptr;
+    GridBase *SGrid = Ls ? (GridBase *)grids.FGrid : (GridBase *)grids.UGrid;
+
+    std::cout << GridLogMessage << "SplitGridSolver: "<<nsrc<<" sources on "<<nsplit
+	      <<" subgrid(s) of processor grid "<<split<<" local volume "<<grids.UGrid->LocalDimensions()<<std::endl;
+
+    GaugeField s_Umu(grids.UGrid);
+    Grid_split(Umu,s_Umu);
+    SolveFn solver = factory(s_Umu,grids);
+    setup.Stop();
+
+    Field s_src(SGrid), s_sol(SGrid);
+    std::vector<Field> b_src(nsplit,FGrid), b_sol(nsplit,FGrid);
+    int nbatch = (nsrc+nsplit-1)/nsplit;
+    for(int b=0;b<nbatch;b++){
+      transfer.Start();
+      for(int n=0;n<nsplit;n++){
+	int s = std::min(b*nsplit+n,nsrc-1); // pad the last batch by repeating a source
+	b_src[n] = src[s];
+	b_sol[n] = sol[s];
+      }
+      Grid_split(b_src,s_src);
+      Grid_split(b_sol,s_sol);
+      transfer.Stop();
+
+      solve.Start();
+      solver(s_src,s_sol);
+      solve.Stop();
+
+      transfer.Start();
+      Grid_unsplit(b_sol,s_sol);
+      for(int n=0;n<nsplit && b*nsplit+n<nsrc;n++) sol[b*nsplit+n] = b_sol[n];
+      transfer.Stop();
+    }
+
+    std::cout << GridLogMessage << "SplitGridSolver: "<<nbatch<<" batch(es); setup "<<setup.Elapsed()
+	      <<" solve "<<solve.Elapsed()<<" split/unsplit "<<transfer.Elapsed()<<std::endl;
+
+    solver = nullptr;
+    delete grids.FrbGrid;
+    delete grids.FGrid;
+    delete grids.UrbGrid;
+    delete grids.UGrid;
+  }
+
+private:
+  GaugeField           &Umu;
+  SolverFactory         factory;
+  SplitGridSolverParams params;
+};
+
+NAMESPACE_END(Grid);
@@ -101,6 +101,8 @@ JSONReader::JSONReader(const std::string &fileName)
 bool JSONReader::push(const std::string &s)
 {
   if (s.size()){
+    // A missing node fails as in XmlReader::push, staying on the current node
+    if (!jcur_.is_object() || (jcur_.find(s) == jcur_.end())) return false;
     jold_.push_back(jcur_);
     do_pop.push_back(true);
     try
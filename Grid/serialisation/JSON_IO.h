@@ -268,8 +268,10 @@ namespace Grid
     std::string    buf;
     unsigned int   i = 0;
     //std::cout << "JSONReader::readDefault(vec) : " << jcur_ << std::endl;
-    if (s.size())
-      push(s);
+    if (s.size() && !push(s)) {
+      std::cout << GridLogWarning << "JSON: cannot open node '" << s << "'" << std::endl;
+      return;
+    }
 
     json j = jcur_;
     for (json::iterator it = j.begin(); it != j.end(); ++it) {
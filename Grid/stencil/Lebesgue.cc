@@ -143,7 +143,7 @@ void LebesgueOrder::IterateI(int ND,
       //      std::cout << "\n";
       IndexInteger index;
       Lexicographic::IndexFromCoor(x,index,grid->_rdimensions);
-      _LebesgueReorder.push_back(index);
+      _LebesgueReorder.push_back(grid->oIndexFromLex(index));
     }
   }
 }
@@ -221,7 +221,7 @@ void LebesgueOrder::ZGraph(void)
 	+dims[0]*dims[1]*dims[2]*ax[3];
 
       assert(site < vol);
-      _LebesgueReorder.push_back(site);
+      _LebesgueReorder.push_back(grid->oIndexFromLex(site));
     }
   }
   assert( _LebesgueReorder.size() == vol );
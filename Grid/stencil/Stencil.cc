@@ -64,6 +64,13 @@ void Gather_plane_table_compute (GridBase *grid,int dimension,int plane,int cbma
       }
     }
   }
+  // Offsets are relative to the plane base so+; map the site through
+  // the grid layout keeping that convention
+  if ( grid->SiteLayout() != GridBase::SiteLayoutLexicographic ) {
+    for(int i=0;i<table.size();i++){
+      table[i].second = grid->oIndexFromLex(so+table[i].second)-so;
+    }
+  }
 }
 
 NAMESPACE_END(Grid);
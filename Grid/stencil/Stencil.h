@@ -267,6 +267,8 @@ public:
   stencilVector<StencilEntry>  _entries; // Resident in managed memory
   commVector<StencilEntry>     _entries_device; // Resident in managed memory
   std::vector<Packet> Packets;
+  std::vector<Packet> PersistentPackets;
+  std::vector<std::vector<CommsRequest_t> > PersistentReqs;
   std::vector<Merge> Mergers;
   std::vector<Merge> MergersSHM;
   std::vector<Decompress> Decompressions;
@@ -394,6 +396,10 @@ public:
   ////////////////////////////////////////////////////////////////////////
   void CommunicateBegin(std::vector<std::vector<CommsRequest_t> > &reqs)
   {
+    if ( CartesianCommunicator::CommunicatorPolicy == CartesianCommunicator::CommunicatorPolicyPersistent ) {
+      PersistentCommunicateBegin();
+      return;
+    }
     reqs.resize(Packets.size());
     commtime-=usecond();
     for(int i=0;i<Packets.size();i++){
@@ -410,11 +416,105 @@ public:
 
   void CommunicateComplete(std::vector<std::vector<CommsRequest_t> > &reqs)
   {
+    if ( CartesianCommunicator::CommunicatorPolicy == CartesianCommunicator::CommunicatorPolicyPersistent ) {
+      PersistentCommunicateComplete();
+      return;
+    }
     for(int i=0;i<Packets.size();i++){
       _grid->StencilSendToRecvFromComplete(reqs[i],i);
     }
     commtime+=usecond();
   }
+  int CommunicateTest(std::vector<std::vector<CommsRequest_t> > &reqs)
+  {
+    int complete=1;
+    if ( CartesianCommunicator::CommunicatorPolicy == CartesianCommunicator::CommunicatorPolicyPersistent ) {
+      for(int i=0;i<PersistentReqs.size();i++){
+	if ( !_grid->StencilSendToRecvFromTest(PersistentReqs[i]) ) complete=0;
+      }
+    } else {
+      for(int i=0;i<reqs.size();i++){
+	if ( !_grid->StencilSendToRecvFromTest(reqs[i]) ) complete=0;
+      }
+    }
+    return complete;
+  }
+  ////////////////////////////////////////////////////////////////////////
+  // Halo exchange driven by the comms progress thread, which posts the
+  // sends and receives and polls them to completion while the caller
+  // computes. The caller must not enter MPI until the Complete.
+  ////////////////////////////////////////////////////////////////////////
+  void CommunicateProgressBegin(std::vector<std::vector<CommsRequest_t> > &reqs)
+  {
+    CommsProgressThread::Instance().Launch([this,&reqs](){
+	this->CommunicateBegin(reqs);
+	while ( !this->CommunicateTest(reqs) );
+      });
+  }
+  void CommunicateProgressComplete(std::vector<std::vector<CommsRequest_t> > &reqs)
+  {
+    CommsProgressThread::Instance().Wait();
+    CommunicateComplete(reqs);
+  }
+  ////////////////////////////////////////////////////////////////////////
+  // Persistent send and receive. The packet list depends only on the
+  // stencil buffers, so requests are built on first use and restarted
+  // on every subsequent exchange; rebuilt only if the packets change.
+  ////////////////////////////////////////////////////////////////////////
+  int PersistentPacketsMatch(void)
+  {
+    if ( PersistentPackets.size() != Packets.size() ) return 0;
+    for(int i=0;i<Packets.size();i++){
+      if ( PersistentPackets[i].send_buf  != Packets[i].send_buf  ) return 0;
+      if ( PersistentPackets[i].recv_buf  != Packets[i].recv_buf  ) return 0;
+      if ( PersistentPackets[i].to_rank   != Packets[i].to_rank   ) return 0;
+      if ( PersistentPackets[i].from_rank != Packets[i].from_rank ) return 0;
+      if ( PersistentPackets[i].bytes     != Packets[i].bytes     ) return 0;
+    }
+    return 1;
+  }
+  void PersistentFree(void)
+  {
+    for(int i=0;i<PersistentReqs.size();i++){
+      _grid->StencilSendToRecvFromPersistentFree(PersistentReqs[i]);
+    }
+    PersistentReqs.resize(0);
+    PersistentPackets.resize(0);
+  }
+  void PersistentCommunicateBegin(void)
+  {
+    commtime-=usecond();
+    if ( !PersistentPacketsMatch() ) {
+      PersistentFree();
+      PersistentReqs.resize(Packets.size());
+      for(int i=0;i<Packets.size();i++){
+	_grid->StencilSendToRecvFromPersistentInit(PersistentReqs[i],
+						   Packets[i].send_buf,
+						   Packets[i].to_rank,
+						   Packets[i].recv_buf,
+						   Packets[i].from_rank,
+						   Packets[i].bytes,i);
+      }
+      PersistentPackets = Packets;
+    }
+    for(int i=0;i<Packets.size();i++){
+      uint64_t bytes=_grid->StencilSendToRecvFromPersistentBegin(PersistentReqs[i],
+								 Packets[i].send_buf,
+								 Packets[i].to_rank,
+								 Packets[i].recv_buf,
+								 Packets[i].from_rank,
+								 Packets[i].bytes,i);
+      comms_bytes+=bytes;
+      shm_bytes  +=2*Packets[i].bytes-bytes;
+    }
+  }
+  void PersistentCommunicateComplete(void)
+  {
+    for(int i=0;i<PersistentReqs.size();i++){
+      _grid->StencilSendToRecvFromPersistentComplete(PersistentReqs[i],i);
+    }
+    commtime+=usecond();
+  }
   ////////////////////////////////////////////////////////////////////////
   // Blocking send and receive. Either sequential or parallel.
   ////////////////////////////////////////////////////////////////////////
@@ -651,6 +751,15 @@ public:
     }
   }
 
+  ~CartesianStencil()
+  {
+    PersistentFree();
+  }
+
+  // The persistent requests are owned by one stencil and freed by its destructor
+  CartesianStencil(const CartesianStencil &) = delete;
+  CartesianStencil &operator=(const CartesianStencil &) = delete;
+
   CartesianStencil(GridBase *grid,
 		   int npoints,
 		   int checkerboard,
@@ -903,8 +1012,8 @@ public:
       // Simple block stride gather of SIMD objects
       for(int n=0;n<_grid->_slice_nblock[dimension];n++){
 	for(int b=0;b<_grid->_slice_block[dimension];b++){
-	  int idx=point+(lo+o+b)*this->_npoints;
-	  _entries[idx]._offset  =ro+o+b;
+	  int idx=point+_grid->oIndexFromLex(lo+o+b)*this->_npoints;
+	  _entries[idx]._offset  =_grid->oIndexFromLex(ro+o+b);
 	  _entries[idx]._permute=permute;
 	  _entries[idx]._is_local=1;
 	  _entries[idx]._around_the_world=wrap;
@@ -924,8 +1033,8 @@ public:
 	  int ocb=1<<_grid->CheckerBoardFromOindex(o+b);
 
 	  if ( ocb&cbmask ) {
-	    int idx = point+(lo+o+b)*this->_npoints;
-	    _entries[idx]._offset =ro+o+b;
+	    int idx = point+_grid->oIndexFromLex(lo+o+b)*this->_npoints;
+	    _entries[idx]._offset =_grid->oIndexFromLex(ro+o+b);
 	    _entries[idx]._is_local=1;
 	    _entries[idx]._permute=permute;
 	    _entries[idx]._around_the_world=wrap;
@@ -951,7 +1060,7 @@ public:
       // Simple block stride gather of SIMD objects
       for(int n=0;n<_grid->_slice_nblock[dimension];n++){
 	for(int b=0;b<_grid->_slice_block[dimension];b++){
-	  int idx=point+(so+o+b)*this->_npoints;
+	  int idx=point+_grid->oIndexFromLex(so+o+b)*this->_npoints;
 	  _entries[idx]._offset  =offset+(bo++);
 	  _entries[idx]._is_local=0;
 	  _entries[idx]._permute=0;
@@ -971,7 +1080,7 @@ public:
 
 	  int ocb=1<<_grid->CheckerBoardFromOindex(o+b);// Could easily be a table lookup
 	  if ( ocb & cbmask ) {
-	    int idx = point+(so+o+b)*this->_npoints;
+	    int idx = point+_grid->oIndexFromLex(so+o+b)*this->_npoints;
 	    _entries[idx]._offset  =offset+(bo++);
 	    _entries[idx]._is_local=0;
 	    _entries[idx]._permute =0;
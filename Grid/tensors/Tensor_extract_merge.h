@@ -149,6 +149,39 @@ void insertLane(int lane, vobj & __restrict__ vec,const typename vobj::scalar_ob
   }
 }
 
+////////////////////////////////////////////////////////////////////////
+// Copy a single lane between objects of the same tensor type, which may
+// differ in precision and hence in Nsimd. Useful for precision change
+////////////////////////////////////////////////////////////////////////
+template<class vobjOut, class vobjIn> accelerator_inline
+void copyLane(vobjOut & __restrict__ vecOut, int lane_out, const vobjIn & __restrict__ vecIn, int lane_in)
+{
+  static_assert( std::is_same<typename vobjOut::scalar_typeD, typename vobjIn::scalar_typeD>::value == 1,
+		 "copyLane: tensor types must be the same");
+
+  typedef typename vobjOut::vector_type ovector_type;
+  typedef typename vobjIn::vector_type  ivector_type;
+  typedef typename vobjOut::scalar_type oscalar_type;
+  typedef typename vobjIn::scalar_type  iscalar_type;
+
+  constexpr int owords=sizeof(vobjOut)/sizeof(ovector_type);
+  constexpr int iwords=sizeof(vobjIn)/sizeof(ivector_type);
+  static_assert( owords == iwords, "copyLane: input and output must have the same number of words");
+
+  constexpr int oNsimd=ovector_type::Nsimd();
+  constexpr int iNsimd=ivector_type::Nsimd();
+
+  oscalar_type * __restrict__ op = (oscalar_type *)&vecOut;
+  iscalar_type * __restrict__ ip = (iscalar_type *)&vecIn;
+  iscalar_type itmp;
+  oscalar_type otmp;
+  for(int w=0;w<owords;w++){
+    memcpy((char *)&itmp,(char *)&ip[w*iNsimd+lane_in],sizeof(itmp));
+    otmp = itmp; // may do a precision conversion
+    memcpy((char *)&op[w*oNsimd+lane_out],(char *)&otmp,sizeof(otmp));
+  }
+}
+
 ////////////////////////////////////////////////////////////////////////
 // Extract to a bunch of scalar object pointers of different scalar type, with offset. Useful for precision change
 ////////////////////////////////////////////////////////////////////////
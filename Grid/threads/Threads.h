@@ -43,6 +43,7 @@ Author: paboyle <paboyle@ph.ed.ac.uk>
 #ifdef _OPENMP
 #define GRID_OMP
 #include <omp.h>
+#include <atomic>
 #endif
 
 #ifdef GRID_OMP
@@ -57,13 +58,136 @@ Author: paboyle <paboyle@ph.ed.ac.uk>
 #define thread_max(a) (1)
 #endif
 
-#define thread_for( i, num, ... )                           DO_PRAGMA(omp parallel for schedule(static)) for ( uint64_t i=0;i<num;i++) { __VA_ARGS__ } ;
+//////////////////////////////////////////////////////////////////////////////////
+// Loop scheduling. The default is OpenMP static. --threads-scheduler=steal selects
+// a work stealing scheduler: each thread starts on its static slice, takes chunks
+// from the front and, once empty, steals the back half of another thread's slice.
+// This rebalances loops whose iterations differ in cost (interior/surface sites).
+// The loop body is instantiated once; ThreadSlice hands each thread its index ranges.
+//////////////////////////////////////////////////////////////////////////////////
+NAMESPACE_BEGIN(Grid);
+
+enum ThreadScheduler_t { ThreadSchedulerStatic, ThreadSchedulerSteal };
+extern ThreadScheduler_t threadScheduler;
+extern int threadStealChunks; // chunks per thread slice
+
+#ifdef GRID_OMP
+struct alignas(64) ThreadStealRange {
+  std::atomic<uint64_t> range;  // end in high 32 bits, begin in low 32 bits
+  static uint64_t pack(uint64_t b,uint64_t e) { return (e<<32)|b; }
+  static uint64_t begin(uint64_t r) { return r&0xFFFFFFFFULL; }
+  static uint64_t end  (uint64_t r) { return r>>32; }
+};
+
+// Shared state of one loop, set up before the parallel region
+struct ThreadLoop {
+  uint64_t num, chunk;
+  bool steal;
+  ThreadStealRange *ranges;
+  ThreadLoop(uint64_t _num) : num(_num), chunk(1), steal(false), ranges(nullptr)
+  {
+    int nthr = omp_get_max_threads();
+    // Nested regions run on one thread; the packed range limits the length
+    if ( (threadScheduler!=ThreadSchedulerSteal) || (nthr==1) || omp_in_parallel() || (num >= (1ULL<<32)) ) return;
+    static thread_local std::vector<ThreadStealRange> pool;
+    if ( pool.size() < (size_t)nthr ) std::vector<ThreadStealRange>(nthr).swap(pool);
+    ranges = &pool[0];
+    chunk  = MAX(num/(nthr*threadStealChunks),1);
+    steal  = true;
+  }
+};
+
+// Per thread view of a ThreadLoop; must be constructed by every thread of the region
+struct ThreadSlice {
+  ThreadLoop &loop;
+  int nt, me;
+  bool done;
+  ThreadSlice(ThreadLoop &_loop) : loop(_loop), nt(omp_get_num_threads()), me(omp_get_thread_num()), done(false)
+  {
+    if ( loop.steal ) {
+      loop.ranges[me].range.store(ThreadStealRange::pack((loop.num*me)/nt,(loop.num*(me+1))/nt));
+#pragma omp barrier
+    }
+  }
+  bool next(uint64_t &b,uint64_t &e)
+  {
+    if ( !loop.steal ) {
+      // Static: the thread's own slice, once
+      if ( done ) return false;
+      done = true;
+      b = (loop.num*me)/nt;
+      e = (loop.num*(me+1))/nt;
+      return true;
+    }
+    ThreadStealRange &mine = loop.ranges[me];
+    for(;;) {
+      // Take a chunk from the front of the own slice
+      uint64_t r = mine.range.load();
+      while ( ThreadStealRange::begin(r) < ThreadStealRange::end(r) ) {
+	uint64_t rb = ThreadStealRange::begin(r);
+	uint64_t re = ThreadStealRange::end(r);
+	uint64_t nb = MIN(rb+loop.chunk,re);
+	if ( mine.range.compare_exchange_weak(r,ThreadStealRange::pack(nb,re)) ) {
+	  b = rb; e = nb;
+	  return true;
+	}
+      }
+      // Steal the back half of the first non-empty slice
+      bool stole=false;
+      for(int v=1;(v<nt)&&(!stole);v++){
+	ThreadStealRange &victim = loop.ranges[(me+v)%nt];
+	uint64_t vr = victim.range.load();
+	for(;;) {
+	  uint64_t vb = ThreadStealRange::begin(vr);
+	  uint64_t ve = ThreadStealRange::end(vr);
+	  if ( vb>=ve ) break;
+	  uint64_t ne = ve - (ve-vb+1)/2;
+	  if ( victim.range.compare_exchange_weak(vr,ThreadStealRange::pack(vb,ne)) ) {
+	    mine.range.store(ThreadStealRange::pack(ne,ve));
+	    stole=true;
+	    break;
+	  }
+	}
+      }
+      if ( !stole ) return false;
+    }
+  }
+};
+
+// The body runs inside a chunk loop, so "break" would only end the current chunk
+// (the omp for this replaces did not allow it either); bodies must not use it.
+#define thread_for( i, num, ... )					\
+  {									\
+    Grid::ThreadLoop _grid_loop(num);					\
+    DO_PRAGMA(omp parallel)						\
+    {									\
+      Grid::ThreadSlice _grid_slice(_grid_loop);			\
+      uint64_t _grid_b, _grid_e;					\
+      while ( _grid_slice.next(_grid_b,_grid_e) ) {			\
+	for ( uint64_t i=_grid_b;i<_grid_e;i++) { __VA_ARGS__ } ;	\
+      }									\
+    }									\
+  }
+#define thread_for2d( i1, n1,i2,n2, ... )				\
+  {									\
+    uint64_t _grid_n2 = n2;						\
+    thread_for(_grid_i12,(n1)*_grid_n2,{				\
+      uint64_t i1 = _grid_i12/_grid_n2;					\
+      uint64_t i2 = _grid_i12%_grid_n2;					\
+      { __VA_ARGS__ } ;							\
+    });									\
+  }
+#else
+#define thread_for( i, num, ... )  for ( uint64_t i=0;i<num;i++) { __VA_ARGS__ } ;
 #define thread_for2d( i1, n1,i2,n2, ... )  \
-  DO_PRAGMA(omp parallel for collapse(2))  \
   for ( uint64_t i1=0;i1<n1;i1++) {	   \
   for ( uint64_t i2=0;i2<n2;i2++) {	   \
   { __VA_ARGS__ } ;			   \
   }}
+#endif
+
+NAMESPACE_END(Grid);
+
 #define thread_foreach( i, container, ... )                 DO_PRAGMA(omp parallel for schedule(static)) for ( uint64_t i=container.begin();i<container.end();i++) { __VA_ARGS__ } ;
 #define thread_for_in_region( i, num, ... )                 DO_PRAGMA(omp for schedule(static))          for ( uint64_t i=0;i<num;i++) { __VA_ARGS__ } ;
 #define thread_for_collapse2( i, num, ... )                 DO_PRAGMA(omp parallel for collapse(2))      for ( uint64_t i=0;i<num;i++) { __VA_ARGS__ } ;
@@ -89,6 +89,8 @@ static Coordinate Grid_default_mpi;
 int GridThread::_threads =1;
 int GridThread::_hyperthreads=1;
 int GridThread::_cores=1;
+ThreadScheduler_t threadScheduler = ThreadSchedulerStatic;
+int threadStealChunks = 8;
 
 
 const Coordinate &GridDefaultLatt(void)     {return Grid_default_latt;};
@@ -204,6 +206,15 @@ void GridParseLayout(char **argv,int argc,
     assert(ompthreads.size()==1);
     GridThread::SetThreads(ompthreads[0]);
   }
+  if( GridCmdOptionExists(argv,argv+argc,"--threads-scheduler") ){
+    arg= GridCmdOptionPayload(argv,argv+argc,"--threads-scheduler");
+    if      ( arg == "static" ) threadScheduler = ThreadSchedulerStatic;
+    else if ( arg == "steal"  ) threadScheduler = ThreadSchedulerSteal;
+    else {
+      std::cout << GridLogError << "--threads-scheduler must be static or steal" << std::endl;
+      assert(0);
+    }
+  }
   if( GridCmdOptionExists(argv,argv+argc,"--accelerator-threads") ){
     std::vector<int> gputhreads(0);
     arg= GridCmdOptionPayload(argv,argv+argc,"--accelerator-threads");
@@ -334,6 +345,21 @@ void Grid_init(int *argc,char ***argv)
     GlobalSharedMemory::Hugepages = 1;
   }
 
+  if( GridCmdOptionExists(*argv,*argv+*argc,"--io-async") ){
+    BinaryIO::asyncWrite = 1;
+  }
+  if( GridCmdOptionExists(*argv,*argv+*argc,"--io-crc32c") ){
+    BinaryIO::useCrc32c = 1;
+  }
+  if( GridCmdOptionExists(*argv,*argv+*argc,"--io-mmap") ){
+    BinaryIO::mmapRead = 1;
+  }
+  if( GridCmdOptionExists(*argv,*argv+*argc,"--io-aggregate") ){
+    arg= GridCmdOptionPayload(*argv,*argv+*argc,"--io-aggregate");
+    if ( arg == std::string("node") ) BinaryIO::aggregation = -1;
+    else                              GridCmdOptionInt(arg,BinaryIO::aggregation);
+  }
+
 
   if( GridCmdOptionExists(*argv,*argv+*argc,"--debug-signals") ){
     Grid_debug_handler_init();
@@ -431,11 +457,16 @@ void Grid_init(int *argc,char ***argv)
     std::cout<<GridLogMessage<<std::endl;
     std::cout<<GridLogMessage<<"  --mpi n.n.n.n   : default MPI decomposition"<<std::endl;    
     std::cout<<GridLogMessage<<"  --threads n     : default number of OMP threads"<<std::endl;
+    std::cout<<GridLogMessage<<"  --threads-scheduler static|steal : host loop scheduling "<<std::endl;
     std::cout<<GridLogMessage<<"  --grid n.n.n.n  : default Grid size"<<std::endl;
     std::cout<<GridLogMessage<<"  --shm  M        : allocate M megabytes of shared memory for comms"<<std::endl;
     std::cout<<GridLogMessage<<"  --shm-mpi 0|1   : Force MPI usage under multi-rank per node "<<std::endl;
     std::cout<<GridLogMessage<<"  --shm-hugepages : use explicit huge pages in mmap call "<<std::endl;
     std::cout<<GridLogMessage<<"  --device-mem M  : Size of device software cache for lattice fields (MB) "<<std::endl;
+    std::cout<<GridLogMessage<<"  --io-async      : checkpointers write configurations in the background"<<std::endl;
+    std::cout<<GridLogMessage<<"  --io-crc32c     : also compute a crc32c checksum in lattice I/O"<<std::endl;
+    std::cout<<GridLogMessage<<"  --io-mmap       : read lattices through a memory mapping of the file"<<std::endl;
+    std::cout<<GridLogMessage<<"  --io-aggregate n|node : lexicographic I/O through one rank in n, or one per node"<<std::endl;
     std::cout<<GridLogMessage<<std::endl;
     std::cout<<GridLogMessage<<"Verbose and debug:"<<std::endl;
     std::cout<<GridLogMessage<<std::endl;
@@ -443,14 +474,16 @@ void Grid_init(int *argc,char ***argv)
     std::cout<<GridLogMessage<<"  --decomposition : report on default omp,mpi and simd decomposition"<<std::endl;    
     std::cout<<GridLogMessage<<"  --debug-signals : catch sigsegv and print a blame report"<<std::endl;
     std::cout<<GridLogMessage<<"  --debug-stdout  : print stdout from EVERY node"<<std::endl;
-    std::cout<<GridLogMessage<<"  --debug-mem     : print Grid allocator activity"<<std::endl;
+    std::cout<<GridLogMessage<<"  --debug-mem     : print Grid allocator activity and pool statistics"<<std::endl;
     std::cout<<GridLogMessage<<"  --notimestamp   : suppress millisecond resolution stamps"<<std::endl;
     std::cout<<GridLogMessage<<std::endl;
     std::cout<<GridLogMessage<<"Performance:"<<std::endl;
     std::cout<<GridLogMessage<<std::endl;
     std::cout<<GridLogMessage<<"  --comms-concurrent : Asynchronous MPI calls; several dirs at a time "<<std::endl;    
     std::cout<<GridLogMessage<<"  --comms-sequential : Synchronous MPI calls; one dirs at a time "<<std::endl;    
+    std::cout<<GridLogMessage<<"  --comms-persistent : Persistent MPI requests; built once per stencil and restarted "<<std::endl;    
     std::cout<<GridLogMessage<<"  --comms-overlap    : Overlap comms with compute "<<std::endl;    
+    std::cout<<GridLogMessage<<"  --comms-progress-thread : Overlap comms with compute; a pinned thread per rank drives MPI "<<std::endl;    
     std::cout<<GridLogMessage<<std::endl;
     std::cout<<GridLogMessage<<"  --dslash-generic: Wilson kernel for generic Nc"<<std::endl;    
     std::cout<<GridLogMessage<<"  --dslash-unroll : Wilson kernel for Nc=3"<<std::endl;    
@@ -485,12 +518,26 @@ void Grid_init(int *argc,char ***argv)
     WilsonKernelsStatic::Comms = WilsonKernelsStatic::CommsThenCompute;
     StaggeredKernelsStatic::Comms = StaggeredKernelsStatic::CommsThenCompute;
   }
+  if( GridCmdOptionExists(*argv,*argv+*argc,"--comms-progress-thread") ){
+    // The progress thread enters MPI while the main thread waits, so MPI must
+    // accept calls from another thread; otherwise fall back to the default
+    if ( CartesianCommunicator::ThreadSerialized() ) {
+      WilsonKernelsStatic::Comms = WilsonKernelsStatic::CommsAndCompute;
+      StaggeredKernelsStatic::Comms = StaggeredKernelsStatic::CommsAndCompute;
+      CartesianCommunicator::UseProgressThread = 1;
+    } else {
+      std::cout << GridLogMessage << "--comms-progress-thread needs MPI_THREAD_SERIALIZED or better; disabled" << std::endl;
+    }
+  }
   if( GridCmdOptionExists(*argv,*argv+*argc,"--comms-concurrent") ){
     CartesianCommunicator::SetCommunicatorPolicy(CartesianCommunicator::CommunicatorPolicyConcurrent);
   }
   if( GridCmdOptionExists(*argv,*argv+*argc,"--comms-sequential") ){
     CartesianCommunicator::SetCommunicatorPolicy(CartesianCommunicator::CommunicatorPolicySequential);
   }
+  if( GridCmdOptionExists(*argv,*argv+*argc,"--comms-persistent") ){
+    CartesianCommunicator::SetCommunicatorPolicy(CartesianCommunicator::CommunicatorPolicyPersistent);
+  }
 
   if( GridCmdOptionExists(*argv,*argv+*argc,"--lebesgue") ){
     LebesgueOrder::UseLebesgueOrder=1;
@@ -521,6 +568,7 @@ void Grid_init(int *argc,char ***argv)
   if( GridCmdOptionExists(*argv,*argv+*argc,"--decomposition") ){
     std::cout<<GridLogMessage<<"Grid Default Decomposition patterns\n";
     std::cout<<GridLogMessage<<"\tOpenMP threads : "<<GridThread::GetThreads()<<std::endl;
+    std::cout<<GridLogMessage<<"\tLoop scheduler : "<<(threadScheduler==ThreadSchedulerSteal ? "steal" : "static")<<std::endl;
     std::cout<<GridLogMessage<<"\tMPI tasks      : "<<GridCmdVectorIntToString(GridDefaultMpi())<<std::endl;
     std::cout<<GridLogMessage<<"\tvRealF         : "<<sizeof(vRealF)*8    <<"bits ; " <<GridCmdVectorIntToString(GridDefaultSimd(4,vRealF::Nsimd()))<<std::endl;
     std::cout<<GridLogMessage<<"\tvRealD         : "<<sizeof(vRealD)*8    <<"bits ; " <<GridCmdVectorIntToString(GridDefaultSimd(4,vRealD::Nsimd()))<<std::endl;
@@ -533,6 +581,7 @@ void Grid_init(int *argc,char ***argv)
 
 void Grid_finalize(void)
 {
+  if ( MemoryProfiler::debug ) MemoryManager::PrintPoolStatistics();
 #if defined (GRID_COMMS_MPI) || defined (GRID_COMMS_MPI3) || defined (GRID_COMMS_MPIT)
   MPI_Barrier(MPI_COMM_WORLD);
   MPI_Finalize();
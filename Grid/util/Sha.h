@@ -32,15 +32,95 @@ extern "C" {
 #ifdef USE_IPP
 #include "ipp.h"
 #endif
+#include <cstring>
+#if defined(__SSE4_2__)
+#include <nmmintrin.h>
+#endif
+#if defined(__ARM_FEATURE_CRC32)
+#include <arm_acle.h>
+#endif
 
 #pragma once
 
 class GridChecksum
 {
 public:
+  ////////////////////////////////////////////////////////////////////////////
+  // CRC32 (zlib polynomial, used by SciDAC) and CRC32C (Castagnoli).
+  // Hardware CRC instructions where the target has them; otherwise zlib
+  // for CRC32 and slicing-by-8 tables for CRC32C. The _update forms chain:
+  // crc = crc32_update(crc,...) starting from crc=0 equals zlib's crc32.
+  ////////////////////////////////////////////////////////////////////////////
+  struct CrcTables {
+    uint32_t t[8][256];
+    CrcTables(uint32_t poly) {
+      for(uint32_t i=0;i<256;i++){
+	uint32_t c = i;
+	for(int k=0;k<8;k++) c = (c&1) ? (poly^(c>>1)) : (c>>1);
+	t[0][i] = c;
+      }
+      for(int k=1;k<8;k++){
+	for(int i=0;i<256;i++) t[k][i] = (t[k-1][i]>>8) ^ t[0][t[k-1][i]&0xFF];
+      }
+    }
+  };
+  static inline const CrcTables &crc32c_tables(void) { static const CrcTables tab(0x82F63B78); return tab; }
+
+  static inline uint32_t crc_slice8(const CrcTables &T,uint32_t crc,const void *data,size_t bytes)
+  {
+    const unsigned char *p = (const unsigned char *)data;
+    crc = ~crc;
+#if BYTE_ORDER == LITTLE_ENDIAN
+    while ( bytes && ((uintptr_t)p & 0x7) ) { crc = T.t[0][(crc^*p++)&0xFF] ^ (crc>>8); bytes--; }
+    while ( bytes >= 8 ) {
+      uint64_t w; memcpy(&w,p,8);
+      uint32_t lo = ((uint32_t)w) ^ crc;
+      uint32_t hi = (uint32_t)(w>>32);
+      crc = T.t[7][lo&0xFF] ^ T.t[6][(lo>>8)&0xFF] ^ T.t[5][(lo>>16)&0xFF] ^ T.t[4][lo>>24]
+	  ^ T.t[3][hi&0xFF] ^ T.t[2][(hi>>8)&0xFF] ^ T.t[1][(hi>>16)&0xFF] ^ T.t[0][hi>>24];
+      p+=8; bytes-=8;
+    }
+#endif
+    while ( bytes-- ) crc = T.t[0][(crc^*p++)&0xFF] ^ (crc>>8);
+    return ~crc;
+  }
+
+  static inline uint32_t crc32_update(uint32_t crc,const void *data,size_t bytes)
+  {
+#if defined(__ARM_FEATURE_CRC32)
+    const unsigned char *p = (const unsigned char *)data;
+    crc = ~crc;
+    while ( bytes >= 8 ) { uint64_t w; memcpy(&w,p,8); crc = __crc32d(crc,w); p+=8; bytes-=8; }
+    while ( bytes-- ) crc = __crc32b(crc,*p++);
+    return ~crc;
+#else
+    // zlib's braided implementation outruns slicing-by-8 here
+    return ::crc32(crc,(const unsigned char *)data,bytes);
+#endif
+  }
+
+  static inline uint32_t crc32c_update(uint32_t crc,const void *data,size_t bytes)
+  {
+#if defined(__SSE4_2__) && defined(__x86_64__)
+    const unsigned char *p = (const unsigned char *)data;
+    uint64_t c = (uint32_t)~crc;
+    while ( bytes >= 8 ) { uint64_t w; memcpy(&w,p,8); c = _mm_crc32_u64(c,w); p+=8; bytes-=8; }
+    while ( bytes-- ) c = _mm_crc32_u8((uint32_t)c,*p++);
+    return ~(uint32_t)c;
+#elif defined(__ARM_FEATURE_CRC32)
+    const unsigned char *p = (const unsigned char *)data;
+    crc = ~crc;
+    while ( bytes >= 8 ) { uint64_t w; memcpy(&w,p,8); crc = __crc32cd(crc,w); p+=8; bytes-=8; }
+    while ( bytes-- ) crc = __crc32cb(crc,*p++);
+    return ~crc;
+#else
+    return crc_slice8(crc32c_tables(),crc,data,bytes);
+#endif
+  }
+
   static inline uint32_t crc32(const void *data, size_t bytes)
   {
-    return ::crc32(0L,(unsigned char *)data,bytes);
+    return crc32_update(0,data,bytes);
   }
 
 #ifdef USE_IPP
@@ -52,6 +132,11 @@ public:
   
       return ~crc32c;
   }
+#else
+  static inline uint32_t crc32c(const void* data, size_t bytes)
+  {
+    return crc32c_update(0,data,bytes);
+  }
 #endif
 
   template <typename T>
@@ -64,6 +64,24 @@ int main(int argc, char **argv) {
   HMCparams.MD = MD;
   HMCWrapper TheHMC(HMCparams);
 
+  // Hasenbusch masses and levels; a plan from Mobius2p1fHasenbusch replaces the defaults
+  HasenbuschPlan Plan;
+  Plan.light_mass  = 0.01;
+  Plan.pv_mass     = 1.0;
+  Plan.hasenbusch  = std::vector<RealD>({ 0.1 });
+  Plan.levels      = std::vector<Integer>({ 0, 0 });
+  Plan.multipliers = std::vector<Integer>({ 1, 4 });
+
+  TheHMC.ReadCommandLine(argc, argv);
+  if (!TheHMC.ParameterFile.empty()) {
+    XmlReader PlanReader(TheHMC.ParameterFile);
+    TheHMC.Parameters.initialize(PlanReader);
+    HasenbuschPlan Planned; // an empty list leaves a vector untouched, so read into a fresh plan
+    read(PlanReader, "Hasenbusch", Planned);
+    Plan = Planned;
+    TheHMC.ReadCommandLine(argc, argv); // command line options take precedence
+  }
+
   // Grid from the command line arguments --grid and --mpi
   TheHMC.Resources.AddFourDimGrid("gauge"); // use default simd lanes decomposition
 
@@ -87,9 +105,9 @@ int main(int argc, char **argv) {
 
   const int Ls      = 16;
   Real beta         = 2.13;
-  Real light_mass   = 0.01;
+  Real light_mass   = Plan.light_mass;
   Real strange_mass = 0.04;
-  Real pv_mass      = 1.0;
+  Real pv_mass      = Plan.pv_mass;
   RealD M5  = 1.8;
   RealD b   = 1.0; // Scale factor two
   RealD c   = 0.0;
@@ -102,7 +120,7 @@ int main(int argc, char **argv) {
   OFRp.degree   = 14;
   OFRp.precision= 40;
 
-  std::vector<Real> hasenbusch({ 0.1 });
+  std::vector<Real> hasenbusch(Plan.hasenbusch.begin(),Plan.hasenbusch.end());
 
   auto GridPtr   = TheHMC.Resources.GetCartesian();
   auto GridRBPtr = TheHMC.Resources.GetRBCartesian();
@@ -125,8 +143,10 @@ int main(int argc, char **argv) {
   ////////////////////////////////////
   // Collect actions
   ////////////////////////////////////
-  ActionLevel<HMCWrapper::Field> Level1(1);
-  ActionLevel<HMCWrapper::Field> Level2(4);
+  // Fermion levels first, gauge action on the innermost level
+  // (built in place: a copied ActionLevel still refers to the actions of the original)
+  std::vector<ActionLevel<HMCWrapper::Field> > Levels(Plan.multipliers.size());
+  for(int l=0;l<Levels.size();l++) Levels[l].multiplier = Plan.multipliers[l];
 
   ////////////////////////////////////
   // Strange action
@@ -172,16 +192,17 @@ int main(int argc, char **argv) {
     Quotients.push_back   (new TwoFlavourEvenOddRatioPseudoFermionAction<FermionImplPolicy>(*Numerators[h],*Denominators[h],CG,CG));
   }
 
+  assert(Plan.levels.size() == n_hasenbusch+1);
   for(int h=0;h<n_hasenbusch+1;h++){
-    Level1.push_back(Quotients[h]);
+    assert(Plan.levels[h] >= 0 && Plan.levels[h] < Levels.size());
+    Levels[Plan.levels[h]].push_back(Quotients[h]);
   }
 
   /////////////////////////////////////////////////////////////
   // Gauge action
   /////////////////////////////////////////////////////////////
-  Level2.push_back(&GaugeAction);
-  TheHMC.TheAction.push_back(Level1);
-  TheHMC.TheAction.push_back(Level2);
+  Levels.back().push_back(&GaugeAction);
+  for(auto &Level : Levels) TheHMC.TheAction.push_back(Level);
   std::cout << GridLogMessage << " Action complete "<< std::endl;
 
   /////////////////////////////////////////////////////////////
@@ -0,0 +1,132 @@
+/*************************************************************************************
+
+Grid physics library, www.github.com/paboyle/Grid
+
+Source file: ./HMC/Mobius2p1fHasenbusch.cc
+
+Copyright (C) 2015-2016
+
+This program is free software; you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation; either version 2 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along
+with this program; if not, write to the Free Software Foundation, Inc.,
+51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+
+See the full license in the file "LICENSE" in the top level distribution
+directory
+*************************************************************************************/
+/*  END LEGAL */
+#include <Grid/Grid.h>
+
+// Plans the Hasenbusch masses of Mobius2p1f on a thermalised configuration:
+//
+//   Mobius2p1fHasenbusch --StartingType CheckpointStart --StartingTrajectory 200 [--ParameterFile planner.xml]
+//   Mobius2p1f --ParameterFile Mobius2p1f_hasenbusch.xml
+//
+// The optional parameter file holds a HasenbuschPlanner node (HasenbuschPlannerParameters).
+int main(int argc, char **argv) {
+  using namespace Grid;
+
+  Grid_init(&argc, &argv);
+
+  typedef WilsonImplR FermionImplPolicy;
+  typedef MobiusFermionR FermionAction;
+  typedef typename FermionAction::FermionField FermionField;
+
+  // The reference integrator and checkpoints of Mobius2p1f
+  IntegratorParameters MD;
+  typedef GenericHMCRunner<MinimumNorm2> HMCWrapper;
+  MD.name    = std::string("MinimumNorm2");
+  MD.MDsteps = 20;
+  MD.trajL   = 1.0;
+
+  HMCparameters HMCparams;
+  HMCparams.StartTrajectory  = 0;
+  HMCparams.Trajectories     = 200;
+  HMCparams.NoMetropolisUntil=  20;
+  HMCparams.StartingType     =std::string("CheckpointStart");
+  HMCparams.MD = MD;
+  HMCWrapper TheHMC(HMCparams);
+  TheHMC.ReadCommandLine(argc, argv);
+
+  HasenbuschPlannerParameters PlannerParams;
+  PlannerParams.light_mass     = 0.01;
+  PlannerParams.pv_mass        = 1.0;
+  PlannerParams.hasenbusch     = std::vector<RealD>({ 0.1 });
+  PlannerParams.fermion_levels = 1;
+  if (!TheHMC.ParameterFile.empty()) {
+    XmlReader Reader(TheHMC.ParameterFile);
+    PlannerParams = HasenbuschPlannerParameters(Reader);
+  }
+
+  TheHMC.Resources.AddFourDimGrid("gauge");
+
+  CheckpointerParameters CPparams;
+  CPparams.config_prefix = "ckpoint_EODWF_lat";
+  CPparams.rng_prefix    = "ckpoint_EODWF_rng";
+  CPparams.saveInterval  = 10;
+  CPparams.format        = "IEEE64BIG";
+  TheHMC.Resources.LoadNerscCheckpointer(CPparams);
+
+  RNGModuleParameters RNGpar;
+  RNGpar.serial_seeds = "1 2 3 4 5";
+  RNGpar.parallel_seeds = "6 7 8 9 10";
+  TheHMC.Resources.SetRNGSeeds(RNGpar);
+  TheHMC.Resources.AddRNGs();
+
+  const int Ls      = 16;
+  Real beta         = 2.13;
+  RealD M5  = 1.8;
+  RealD b   = 1.0;
+  RealD c   = 0.0;
+
+  auto GridPtr   = TheHMC.Resources.GetCartesian();
+  auto GridRBPtr = TheHMC.Resources.GetRBCartesian();
+  auto FGrid     = SpaceTimeGrid::makeFiveDimGrid(Ls,GridPtr);
+  auto FrbGrid   = SpaceTimeGrid::makeFiveDimRedBlackGrid(Ls,GridPtr);
+
+  GridSerialRNG   &sRNG = TheHMC.Resources.GetSerialRNG();
+  GridParallelRNG &pRNG = TheHMC.Resources.GetParallelRNG();
+
+  LatticeGaugeField U(GridPtr);
+  if (TheHMC.Parameters.StartingType == "CheckpointStart") {
+    TheHMC.Resources.GetCheckPointer()->CheckpointRestore(TheHMC.Parameters.StartTrajectory, U, sRNG, pRNG);
+  } else {
+    std::cout << GridLogMessage << " No checkpoint given: planning on a hot start, which is not representative" << std::endl;
+    TheHMC.Resources.SeedFixedIntegers();
+    SU<Nc>::HotConfiguration(pRNG, U);
+  }
+
+  std::vector<Complex> boundary = {1,1,1,-1};
+  FermionAction::ImplParams Params(boundary);
+
+  double StoppingCondition = 1e-10;
+  double MaxCGIterations = 30000;
+  ConjugateGradient<FermionField>  CG(StoppingCondition,MaxCGIterations);
+
+  // Gauge action on the inner of two levels, as in Mobius2p1f
+  IwasakiGaugeActionR GaugeAction(beta);
+  ActionSet<HMCWrapper::Field, NoHirep> Fixed(2);
+  Fixed[1].multiplier = 4;
+  Fixed[1].push_back(&GaugeAction);
+
+  HasenbuschPlanner<FermionImplPolicy> Planner(PlannerParams, TheHMC.Parameters.MD,
+    [&](RealD mass) { return new FermionAction(U,*FGrid,*FrbGrid,*GridPtr,*GridRBPtr,mass,M5,b,c, Params); }, CG);
+
+  Planner.Measure(U, Fixed, sRNG, pRNG);
+  HasenbuschPlan Plan = Planner.Plan();
+
+  HMCparameters RunParams(TheHMC.Parameters);
+  RunParams.StartingType = "CheckpointStart";
+  Planner.Write("Mobius2p1f_hasenbusch.xml", RunParams, Plan);
+
+  Grid_finalize();
+} // main
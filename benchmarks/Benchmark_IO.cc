@@ -12,7 +12,6 @@
 #define BENCH_IO_NPASS 10
 #endif
 
-#ifdef HAVE_LIME
 using namespace Grid;
 
 std::string filestem(const int l)
@@ -20,6 +19,100 @@ std::string filestem(const int l)
   return "iobench_l" + std::to_string(l);
 }
 
+#define grid_printf(...) \
+{\
+  char _buf[1024];\
+  sprintf(_buf, __VA_ARGS__);\
+  MSG << _buf;\
+}
+
+void checksumSweep(void)
+{
+  auto                 mpi = GridDefaultMpi();
+  std::vector<int>     latt;
+  double               separate, fused;
+
+  MSG << BIGSEP << std::endl;
+  MSG << "Checksum and endian conversion (all results in MB/s)" << std::endl;
+  MSG << BIGSEP << std::endl;
+  for (int l = BENCH_IO_LMIN; l <= BENCH_IO_LMAX; l += 8)
+  {
+    latt = {l*mpi[0], l*mpi[1], l*mpi[2], l*mpi[3]};
+    MSG << "-- Local volume " << l << "^4" << std::endl;
+    checksumBenchmark<LatticeFermionD>(latt, separate, fused);
+    MSG << std::setw(4) << l << " separate " << std::setw(10) << separate
+        << " fused " << std::setw(10) << fused << " speedup " << fused/separate << std::endl;
+  }
+}
+
+void compressionSweep(void)
+{
+  auto                 mpi = GridDefaultMpi();
+  std::vector<int>     latt;
+  const char          *name[] = {"lossless", "fp16", "bfloat16", "quantised"};
+  double               ratio, wr, rd, err;
+
+  MSG << BIGSEP << std::endl;
+  MSG << "Compressed field format, gaussian LatticeFermionD (throughput in MB/s of field data)" << std::endl;
+  MSG << BIGSEP << std::endl;
+  for (int l = BENCH_IO_LMIN; l <= BENCH_IO_LMAX; l += 8)
+  {
+    latt = {l*mpi[0], l*mpi[1], l*mpi[2], l*mpi[3]};
+    MSG << "-- Local volume " << l << "^4" << std::endl;
+    for (int codec = CompressedIOParams::Lossless; codec <= CompressedIOParams::Quantised; ++codec)
+    {
+      CompressedIOParams params;
+
+      params.codec       = codec;
+      params.tolerance   = 1.0e-4;
+      params.chunkSlices = 2;
+      compressionBenchmark<LatticeFermionD>(latt, filestem(l) + ".cmp", params, ratio, wr, rd, err);
+      grid_printf("%4d %10s ratio %6.2f write %10.1f read %10.1f max error %9.2e\n",
+                  l, name[codec], ratio, wr, rd, err);
+    }
+  }
+}
+
+// Lexicographic Grid binary I/O as a function of the aggregation factor:
+// 0 is every rank (MPI-IO), n one rank in n, -1 one rank per node.
+void aggregationSweep(void)
+{
+  auto                 mpi   = GridDefaultMpi();
+  int                  nrank = 1;
+  int                  l     = BENCH_IO_LMAX;
+  std::vector<int>     latt  = {l*mpi[0], l*mpi[1], l*mpi[2], l*mpi[3]};
+  std::vector<int>     factors;
+  int                  saved = BinaryIO::aggregation;
+
+  for (auto p: mpi) nrank *= p;
+  factors.push_back(0);
+  for (int f = 1; f <= nrank; f *= 2) factors.push_back(f);
+  factors.push_back(-1);
+
+  MSG << BIGSEP << std::endl;
+  MSG << "Aggregated lexicographic I/O, local volume " << l << "^4 (all results in MB/s)" << std::endl;
+  MSG << BIGSEP << std::endl;
+  for (auto f: factors)
+  {
+    double   wr, rd;
+    uint64_t aggregators, requests;
+
+    BinaryIO::aggregation = f;
+    writeBenchmark<LatticeFermion>(latt, filestem(l), binWrite<LatticeFermion>);
+    wr          = BinaryIO::lastPerf.mbytesPerSecond;
+    aggregators = BinaryIO::lastPerf.aggregators;
+    requests    = BinaryIO::lastPerf.requests;
+    readBenchmark<LatticeFermion>(latt, filestem(l), binRead<LatticeFermion>);
+    rd          = BinaryIO::lastPerf.mbytesPerSecond;
+    grid_printf("aggregation %5s aggregators %6lu requests %8lu write %10.1f read %10.1f\n",
+                (f < 0) ? "node" : std::to_string(f).c_str(),
+                (unsigned long)aggregators, (unsigned long)requests, wr, rd);
+  }
+  BinaryIO::aggregation = saved;
+}
+
+#ifdef HAVE_LIME
+
 int vol(const int i)
 {
   return BENCH_IO_LMIN + 2*i;
@@ -49,13 +142,6 @@ void stats(Mat &mean, Mat &stdDev, const std::vector<Mat> &data)
   mean  /= n;
 }
 
-#define grid_printf(...) \
-{\
-  char _buf[1024];\
-  sprintf(_buf, __VA_ARGS__);\
-  MSG << _buf;\
-}
-
 enum {sRead = 0, sWrite = 1, gRead = 2, gWrite = 3};
 
 int main (int argc, char ** argv)
@@ -192,10 +278,22 @@ int main (int argc, char ** argv)
   grid_printf("%12.1f %12.1f %12.1f %12.1f\n",
               avRob(sRead), avRob(sWrite), avRob(gRead), avRob(gWrite));
 
+  checksumSweep();
+  compressionSweep();
+  aggregationSweep();
+
   Grid_finalize();
 
   return EXIT_SUCCESS;
 }
 #else
-int main(int argc,char ** argv){}
+int main(int argc,char ** argv)
+{
+  Grid_init(&argc,&argv);
+  checksumSweep();
+  compressionSweep();
+  aggregationSweep();
+  Grid_finalize();
+  return EXIT_SUCCESS;
+}
 #endif
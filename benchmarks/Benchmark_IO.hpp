@@ -7,7 +7,6 @@
 "-----------------------------------------------------------------------------"
 #define BIGSEP \
 "============================================================================="
-#ifdef HAVE_LIME
 
 namespace Grid {
 
@@ -155,6 +154,7 @@ void stdRead(Field &vec, const std::string filestem)
   MSG << "Std I/O read: checksum overhead " << crcWatch.Elapsed() << std::endl;
 }
 
+#ifdef HAVE_LIME
 template <typename Field>
 void limeWrite(const std::string filestem, Field &vec)
 {
@@ -177,6 +177,8 @@ void limeRead(Field &vec, const std::string filestem)
   binReader.close();
 }
 
+#endif
+
 inline void makeGrid(std::shared_ptr<GridBase> &gPt, 
                      const std::shared_ptr<GridCartesian> &gBasePt,
                      const unsigned int Ls = 1, const bool rb = false)
@@ -249,7 +251,119 @@ void readBenchmark(const Coordinate &latt, const std::string filename,
   read(vec, filename);
 }
 
+
+// Checksum and byte order cost of a lattice write, in MB/s of file data:
+// the separate NERSC / endian / SciDAC passes against the fused single pass.
+template <typename Field>
+void checksumBenchmark(const Coordinate &latt, double &separateMBs, double &fusedMBs,
+                       const int npass = 4)
+{
+  typedef typename Field::scalar_object sobj;
+
+  auto           mpi  = GridDefaultMpi();
+  auto           simd = GridDefaultSimd(latt.size(), Field::vector_type::Nsimd());
+  GridCartesian  grid(latt, simd, mpi);
+  GridParallelRNG rng(&grid);
+  Field          vec(&grid);
+  std::string    format("IEEE64BIG");
+
+  rng.SeedFixedIntegers({1, 2, 3, 4});
+  random(rng, vec);
+
+  std::vector<sobj> ref(grid.lSites()), buf(grid.lSites());
+  unvectorizeToLexOrdArray(ref, vec);
+
+  uint32_t      nersc[2], scidaca[2], scidacb[2], crcc = 0;
+  GridStopWatch separate, fused;
+  double        bytes = npass*ref.size()*sizeof(sobj)*grid.ProcessorCount();
+
+  for (int pass = 0; pass < npass; ++pass)
+  {
+    buf = ref;
+    nersc[0] = scidaca[0] = scidacb[0] = 0;
+    separate.Start();
+    BinaryIO::NerscChecksum(&grid, buf, nersc[0]);
+    BinaryIO::htobe64_v((void *)&buf[0], sizeof(sobj)*buf.size());
+    BinaryIO::ScidacChecksum(&grid, buf, scidaca[0], scidacb[0]);
+    separate.Stop();
+
+    buf = ref;
+    nersc[1] = scidaca[1] = scidacb[1] = 0;
+    fused.Start();
+    BinaryIO::FusedChecksum(&grid, buf, BinaryIO::BINARYIO_WRITE, format, nersc[1], scidaca[1], scidacb[1], crcc);
+    fused.Stop();
+
+    assert(nersc[0] == nersc[1]);
+    assert(scidaca[0] == scidaca[1]);
+    assert(scidacb[0] == scidacb[1]);
+  }
+  separateMBs = bytes/1024./1024./(separate.useconds()/1.e6);
+  fusedMBs    = bytes/1024./1024./(fused.useconds()/1.e6);
+  MSG << "Checksums: NERSC " << std::hex << nersc[1] << " SciDAC " << scidaca[1]
+      << " " << scidacb[1] << std::dec << std::endl;
+  MSG << "Checksums: separate passes " << separateMBs << " MB/s, fused "
+      << fusedMBs << " MB/s" << std::endl;
+}
+
+// Single lexicographic Grid binary file through BinaryIO::IOobject, so that
+// the MPI-IO and aggregated paths are exercised.
+template <typename Field>
+void binWrite(const std::string filestem, Field &vec)
+{
+  typedef typename Field::scalar_object sobj;
+  uint32_t n, a, b;
+
+  BinaryIO::writeLatticeObject<typename Field::vector_object, sobj>(vec, filestem + ".bin", BinarySimpleMunger<sobj, sobj>(), 0, "IEEE64BIG", n, a, b);
+}
+
+template <typename Field>
+void binRead(Field &vec, const std::string filestem)
+{
+  typedef typename Field::scalar_object sobj;
+  uint32_t n, a, b;
+
+  BinaryIO::readLatticeObject<typename Field::vector_object, sobj>(vec, filestem + ".bin", BinarySimpleMunger<sobj, sobj>(), 0, "IEEE64BIG", n, a, b);
+}
+
+// Compressed field format: ratio, write and read throughput (MB/s of field
+// data) and the largest pointwise error of a gaussian field for one codec.
+template <typename Field>
+void compressionBenchmark(const Coordinate &latt, const std::string filename,
+                          const CompressedIOParams &params,
+                          double &ratio, double &writeMBs, double &readMBs, double &maxErr)
+{
+  typedef typename Field::scalar_object sobj;
+  typedef typename Field::vector_type::scalar_type::value_type word;
+
+  auto            mpi  = GridDefaultMpi();
+  auto            simd = GridDefaultSimd(latt.size(), Field::vector_type::Nsimd());
+  GridCartesian   grid(latt, simd, mpi);
+  GridParallelRNG rng(&grid);
+  Field           vec(&grid), res(&grid);
+
+  rng.SeedFixedIntegers({5, 6, 7, 8});
+  gaussian(rng, vec);
+
+  CompressedIO::writeField(vec, filename, params);
+  ratio    = CompressedIO::lastRatio;
+  writeMBs = CompressedIO::lastPerf.mbytesPerSecond;
+  CompressedIO::readField(res, filename);
+  readMBs  = CompressedIO::lastPerf.mbytesPerSecond;
+
+  std::vector<sobj> a(grid.lSites()), b(grid.lSites());
+  unvectorizeToLexOrdArray(a, vec);
+  unvectorizeToLexOrdArray(b, res);
+  const word *pa = (const word *)&a[0], *pb = (const word *)&b[0];
+  maxErr = 0.;
+  for (uint64_t i = 0; i < a.size()*sizeof(sobj)/sizeof(word); ++i)
+  {
+    maxErr = std::max(maxErr, (double)std::abs(pa[i] - pb[i]));
+  }
+  grid.GlobalMax(maxErr);
+  MSG << "Compressed I/O: codec " << params.codec << " ratio " << ratio
+      << " write " << writeMBs << " MB/s read " << readMBs << " MB/s max error " << maxErr << std::endl;
+}
+
 }
 
-#endif //LIME
 #endif // Benchmark_IO_hpp_
@@ -236,6 +236,72 @@ int main (int argc, char ** argv)
     Dw.Report();
   }
 
+  if (1) {
+    std::cout << GridLogMessage<< "*********************************************************" <<std::endl;
+    std::cout << GridLogMessage<< "* Comparing host loop schedulers for Dhop                 "<<std::endl;
+    std::cout << GridLogMessage<< "*********************************************************" <<std::endl;
+    ThreadScheduler_t saved = threadScheduler;
+    double volume=Ls;  for(int mu=0;mu<Nd;mu++) volume=volume*latt4[mu];
+    std::vector<ThreadScheduler_t> schedulers({ThreadSchedulerStatic,ThreadSchedulerSteal});
+    std::vector<std::string>       names({"static","steal "});
+    for(int s=0;s<schedulers.size();s++){
+      threadScheduler = schedulers[s];
+      Dw.Dhop(src,result,0);
+      FGrid->Barrier();
+      double t0=usecond();
+      for(int i=0;i<ncall;i++){
+	Dw.Dhop(src,result,0);
+      }
+      FGrid->Barrier();
+      double t1=usecond();
+      double flops=single_site_flops*volume*ncall;
+      err = ref-result;
+      std::cout<<GridLogMessage << "scheduler "<<names[s]<<" : "<<(t1-t0)/ncall<<" us per call, mflop/s per node = "
+	       << flops/(t1-t0)/NN<<" norm diff "<<norm2(err)<<std::endl;
+      assert (norm2(err)< 1.0e-4 );
+    }
+    threadScheduler = saved;
+  }
+
+  if (1) {
+    std::cout << GridLogMessage<< "*********************************************************" <<std::endl;
+    std::cout << GridLogMessage<< "* Comms/compute overlap for Dhop                          "<<std::endl;
+    std::cout << GridLogMessage<< "* overlap = fraction of the serial comms time hidden      "<<std::endl;
+    std::cout << GridLogMessage<< "*********************************************************" <<std::endl;
+    int saved_comms    = WilsonKernelsStatic::Comms;
+    int saved_progress = CartesianCommunicator::UseProgressThread;
+    std::vector<int>         comms   ({WilsonKernelsStatic::CommsThenCompute,
+	                               WilsonKernelsStatic::CommsAndCompute,
+	                               WilsonKernelsStatic::CommsAndCompute});
+    std::vector<int>         progress({0,0,1});
+    std::vector<std::string> names   ({"serial         ","overlap        ","progress thread"});
+    double serial_comm=0;
+    for(int m=0;m<comms.size();m++){
+      WilsonKernelsStatic::Comms = comms[m];
+      CartesianCommunicator::UseProgressThread = progress[m];
+      Dw.Dhop(src,result,0);
+      Dw.ZeroCounters();
+      FGrid->Barrier();
+      double t0=usecond();
+      for(int i=0;i<ncall;i++){
+	Dw.Dhop(src,result,0);
+      }
+      FGrid->Barrier();
+      double t1=usecond();
+      double comm = Dw.DhopCommTime/ncall;
+      double wait = Dw.DhopCommWaitTime/ncall;
+      if ( m==0 ) serial_comm = comm;
+      double overlap = 0.0;
+      if ( serial_comm > 0.0 ) overlap = 100.0*(1.0-wait/serial_comm);
+      err = ref-result;
+      std::cout<<GridLogMessage << names[m]<<" : "<<(t1-t0)/ncall<<" us per call, comms "<<comm
+	       <<" us, exposed comms "<<wait<<" us, overlap "<<overlap<<" %"<<std::endl;
+      assert (norm2(err)< 1.0e-4 );
+    }
+    WilsonKernelsStatic::Comms = saved_comms;
+    CartesianCommunicator::UseProgressThread = saved_progress;
+  }
+
   if (1)
   { // Naive wilson dag implementation
     ref = Zero();
@@ -0,0 +1,102 @@
+    /*************************************************************************************
+
+    Grid physics library, www.github.com/paboyle/Grid
+
+    Source file: ./tests/IO/Test_compressed_io.cc
+
+    Copyright (C) 2015
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License along
+    with this program; if not, write to the Free Software Foundation, Inc.,
+    51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+
+    See the full license in the file "LICENSE" in the top level distribution directory
+    *************************************************************************************/
+    /*  END LEGAL */
+#include <Grid/Grid.h>
+
+using namespace std;
+using namespace Grid;
+
+template<class Field> RealD maxAbsDiff(Field &a,Field &b)
+{
+  typedef typename Field::scalar_object sobj;
+  typedef typename Field::vector_type::scalar_type::value_type word;
+  std::vector<sobj> sa(a.Grid()->lSites()), sb(b.Grid()->lSites());
+  unvectorizeToLexOrdArray(sa,a);
+  unvectorizeToLexOrdArray(sb,b);
+  const word *pa = (const word *)&sa[0];
+  const word *pb = (const word *)&sb[0];
+  RealD mx=0.0;
+  for(uint64_t i=0;i<sa.size()*sizeof(sobj)/sizeof(word);i++) mx = std::max(mx,(RealD)std::abs(pa[i]-pb[i]));
+  a.Grid()->GlobalMax(mx);
+  return mx;
+}
+
+int main (int argc, char ** argv)
+{
+  Grid_init(&argc,&argv);
+
+  GridCartesian         * Grid   = SpaceTimeGrid::makeFourDimGrid(GridDefaultLatt(), GridDefaultSimd(Nd,vComplex::Nsimd()),GridDefaultMpi());
+  GridRedBlackCartesian * RBGrid = SpaceTimeGrid::makeFourDimRedBlackGrid(Grid);
+  GridCartesian         * GridF  = SpaceTimeGrid::makeFourDimGrid(GridDefaultLatt(), GridDefaultSimd(Nd,vComplexF::Nsimd()),GridDefaultMpi());
+
+  GridParallelRNG pRNG(Grid); pRNG.SeedFixedIntegers(std::vector<int>({11,12,13,14}));
+
+  const char *name[] = {"lossless","fp16","bfloat16","quantised"};
+  RealD tol = 1.0e-5;
+
+  std::vector<LatticeFermionD> src(3,Grid), res(3,Grid);
+  for(auto &f : src) gaussian(pRNG,f);
+  LatticeFermionD zero(Grid); zero=Zero();
+  RealD mx = 0.0;
+  for(auto &f : src) mx = std::max(mx,maxAbsDiff(f,zero));
+
+  for(int codec=CompressedIOParams::Lossless;codec<=CompressedIOParams::Quantised;codec++){
+    CompressedIOParams params;
+    params.codec       = codec;
+    params.tolerance   = tol;
+    params.chunkSlices = 2;
+    std::string file = std::string("./compressed.")+name[codec];
+
+    CompressedIO::writeFields(src,file,params);
+    CompressedIO::readFields(res,file);
+
+    RealD err=0.0;
+    for(int k=0;k<src.size();k++) err = std::max(err,maxAbsDiff(res[k],src[k]));
+    std::cout<<GridLogMessage<<name[codec]<<" ratio "<<CompressedIO::lastRatio<<" max error "<<err<<std::endl;
+    if ( codec==CompressedIOParams::Lossless  ) assert(err==0.0);
+    if ( codec==CompressedIOParams::Half      ) assert(err<=mx*std::pow(2.0,-11)*1.001);
+    if ( codec==CompressedIOParams::BFloat16  ) assert(err<=mx*std::pow(2.0,-8)*1.001);
+    if ( codec==CompressedIOParams::Quantised ) assert(err<=tol*(1.0+1.0e-12));
+  }
+
+  std::cout<<GridLogMessage<<"Checkerboarded field, single precision reader"<<std::endl;
+  {
+    LatticeFermionD full(Grid), odd(RBGrid), back(RBGrid);
+    gaussian(pRNG,full);
+    pickCheckerboard(Odd,odd,full);
+    CompressedIO::writeField(odd,"./compressed.odd");
+    CompressedIO::readField(back,"./compressed.odd");
+    assert(back.Checkerboard()==Odd);
+    assert(maxAbsDiff(back,odd)==0.0);
+
+    LatticeFermionF single(GridF), ref(GridF);
+    precisionChange(ref,src[0]);
+    CompressedIO::readField(single,"./compressed.lossless");
+    assert(maxAbsDiff(single,ref)==0.0);
+  }
+
+  std::cout<<GridLogMessage<<"Compressed I/O test passed"<<std::endl;
+  Grid_finalize();
+}
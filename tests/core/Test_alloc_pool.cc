@@ -0,0 +1,125 @@
+    /*************************************************************************************
+
+    Grid physics library, www.github.com/paboyle/Grid
+
+    Source file: ./tests/core/Test_alloc_pool.cc
+
+    Copyright (C) 2015
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License along
+    with this program; if not, write to the Free Software Foundation, Inc.,
+    51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+
+    See the full license in the file "LICENSE" in the top level distribution directory
+    *************************************************************************************/
+    /*  END LEGAL */
+#include <Grid/Grid.h>
+
+using namespace std;
+using namespace Grid;
+
+void report(const std::string &what,const MemoryPoolStats &s)
+{
+  std::cout<<GridLogMessage<<what<<" requests "<<s.requests<<" hit rate "<<100.0*s.hitRate()<<" %"
+	   <<" live "<<memString(s.requestedBytes)<<" held "<<memString(s.systemBytes)
+	   <<" high water "<<memString(s.highWater)<<" fragmentation "<<100.0*s.fragmentation()<<" %"<<std::endl;
+}
+
+int main (int argc, char ** argv)
+{
+  Grid_init(&argc,&argv);
+
+  GridCartesian * Grid = SpaceTimeGrid::makeFourDimGrid(GridDefaultLatt(), GridDefaultSimd(Nd,vComplex::Nsimd()),GridDefaultMpi());
+  GridParallelRNG pRNG(Grid); pRNG.SeedFixedIntegers(std::vector<int>({1,2,3,4}));
+
+  LatticeColourMatrix a(Grid); gaussian(pRNG,a);
+  LatticeColourMatrix b(Grid); gaussian(pRNG,b);
+  LatticeColourMatrix ref(Grid);
+  ref = a*b+a;
+
+  ///////////////////////////////////////////////////////////
+  // Churn of lattice temporaries: after warm up every request
+  // must be served from the pool
+  ///////////////////////////////////////////////////////////
+  MemoryPoolStats s0 = MemoryManager::PoolStatistics(MemoryManager::PoolCpu);
+  for(int i=0;i<100;i++){
+    LatticeColourMatrix c(Grid);
+    c = a*b+a;
+    LatticeColourMatrix d = c - ref;
+    LatticeComplex n = trace(d);
+  }
+  MemoryPoolStats s1 = MemoryManager::PoolStatistics(MemoryManager::PoolCpu);
+  report("Lattice churn",s1);
+  uint64_t requests = s1.requests - s0.requests;
+  uint64_t misses   = requests - (s1.hits - s0.hits);
+  std::cout<<GridLogMessage<<" "<<requests<<" requests "<<misses<<" misses"<<std::endl;
+  assert(requests >= 300);
+  assert(misses <= 4);
+  assert(s1.highWater >= s1.systemBytes);
+  assert(s1.systemBytes >= s1.reservedBytes);
+  assert(s1.reservedBytes >= s1.requestedBytes);
+
+  ///////////////////////////////////////////////////////////
+  // Small objects from helper threads outside OpenMP
+  ///////////////////////////////////////////////////////////
+  MemoryPoolStats t0 = MemoryManager::PoolStatistics(MemoryManager::PoolCpu);
+  {
+    std::vector<std::thread> workers;
+    for(int t=0;t<4;t++){
+      workers.push_back(std::thread([t](){
+	std::vector<stencilVector<RealD> > v;
+	for(int i=0;i<1000;i++){
+	  stencilVector<RealD> x(1+(i+t)%300);
+	  for(auto &y : x) y=RealD(t);
+	  v.push_back(std::move(x));
+	  if ( v.size() > 16 ) v.erase(v.begin());
+	}
+	for(auto &x : v) for(auto y : x) assert(y==RealD(t));
+      }));
+    }
+    for(auto &w : workers) w.join();
+  }
+  MemoryPoolStats t1 = MemoryManager::PoolStatistics(MemoryManager::PoolCpu);
+  report("Threaded small objects",t1);
+  assert(t1.requests-t0.requests >= 4000);
+  assert(t1.requestedBytes == t0.requestedBytes);
+
+  ///////////////////////////////////////////////////////////
+  // Frees spread over many size classes: the cache keeps at most
+  // Ncache (4 unless GRID_ALLOC_NCACHE_LARGE says otherwise) large blocks
+  // in total, not per class
+  ///////////////////////////////////////////////////////////
+  // Vector is allocated in the shared pool
+  MemoryPoolStats u0 = MemoryManager::PoolStatistics(MemoryManager::PoolShared);
+  uint64_t maxBytes = 0;
+  {
+    std::vector<Vector<RealD> > blocks;
+    for(int i=0;i<256;i++){
+      size_t n = 8192+128*i;
+      blocks.push_back(Vector<RealD>(n));
+      maxBytes = n*sizeof(RealD);
+    }
+  }
+  MemoryPoolStats u1 = MemoryManager::PoolStatistics(MemoryManager::PoolShared);
+  report("Many size classes",u1);
+  uint64_t cached0 = u0.systemBytes-u0.reservedBytes;
+  uint64_t cached1 = u1.systemBytes-u1.reservedBytes;
+  std::cout<<GridLogMessage<<" cached "<<cached0<<" -> "<<cached1<<" bytes"<<std::endl;
+  assert(u1.requests-u0.requests >= 256);
+  int ncache = getenv("GRID_ALLOC_NCACHE_LARGE") ? atoi(getenv("GRID_ALLOC_NCACHE_LARGE")) : 4;
+  assert(cached1 <= cached0 + ncache*maxBytes);
+
+  MemoryManager::PrintPoolStatistics();
+  std::cout<<GridLogMessage<<"Allocator pool test passed"<<std::endl;
+  Grid_finalize();
+}
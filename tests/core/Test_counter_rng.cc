@@ -0,0 +1,159 @@
+    /*************************************************************************************
+
+    Grid physics library, www.github.com/paboyle/Grid
+
+    Source file: ./tests/core/Test_counter_rng.cc
+
+    Copyright (C) 2015
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License along
+    with this program; if not, write to the Free Software Foundation, Inc.,
+    51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+
+    See the full license in the file "LICENSE" in the top level distribution directory
+    *************************************************************************************/
+    /*  END LEGAL */
+#include <Grid/Grid.h>
+
+using namespace std;
+using namespace Grid;
+
+// Every sampled site of l must hold exactly what the scalar reference gives for it
+template<class Field> void checkSites(GridCounterRNG &rng,Field &l,uint32_t draw,int dist)
+{
+  typedef typename Field::scalar_object sobj;
+  typedef typename RealPart<typename Field::scalar_type>::type real_type;
+  GridBase *grid = l.Grid();
+  int nreal = sizeof(sobj)/sizeof(real_type);
+  for(int64_t g=0;g<grid->gSites();g+=grid->gSites()/61+1){
+    Coordinate gcoor;
+    grid->GlobalIndexToGlobalCoor(g,gcoor);
+    sobj s;
+    peekSite(s,l,gcoor);
+    real_type *w = (real_type *)&s;
+    for(int r=0;r<nreal;r++) assert(w[r]==(real_type)rng.Value(g,r,draw,dist));
+  }
+}
+
+int main (int argc, char ** argv)
+{
+  Grid_init(&argc,&argv);
+
+  std::cout<<GridLogMessage<<"Philox4x32-10 known answers"<<std::endl;
+  {
+    uint32_t c0[4] = {0,0,0,0};
+    Philox4x32_10(c0,0,0);
+    assert(c0[0]==0x6627e8d5 && c0[1]==0xe169c58d && c0[2]==0xbc57ac4c && c0[3]==0x9b00dbd8);
+    uint32_t c1[4] = {0x243f6a88,0x85a308d3,0x13198a2e,0x03707344};
+    Philox4x32_10(c1,0xa4093822,0x299f31d0);
+    assert(c1[0]==0xd16cfe09 && c1[1]==0x94fdcceb && c1[2]==0x5001e420 && c1[3]==0x24126ea1);
+  }
+
+  const int Ls=8;
+  GridCartesian         * UGrid   = SpaceTimeGrid::makeFourDimGrid(GridDefaultLatt(), GridDefaultSimd(Nd,vComplex::Nsimd()),GridDefaultMpi());
+  GridCartesian         * UGridF  = SpaceTimeGrid::makeFourDimGrid(GridDefaultLatt(), GridDefaultSimd(Nd,vComplexF::Nsimd()),GridDefaultMpi());
+  GridCartesian         * UGridR  = SpaceTimeGrid::makeFourDimGrid(GridDefaultLatt(), GridDefaultSimd(Nd,vRealD::Nsimd()),GridDefaultMpi());
+  GridRedBlackCartesian * UrbGrid = SpaceTimeGrid::makeFourDimRedBlackGrid(UGrid);
+  GridCartesian         * FGrid   = SpaceTimeGrid::makeFiveDimGrid(Ls,UGrid);
+
+  std::vector<int> seeds({1,2,3,4});
+
+  std::cout<<GridLogMessage<<"Sites against the scalar reference"<<std::endl;
+  GridCounterRNG rng;  rng.SeedFixedIntegers(seeds);
+  {
+    LatticeFermionD     psi(UGrid);
+    LatticeComplexD     c(UGrid);
+    LatticeRealD        r(UGridR);
+    uint32_t draw;
+    draw=rng.Draws(); gaussian(rng,psi);  checkSites(rng,psi,draw,GridCounterRNG::Gaussian);
+    draw=rng.Draws(); random(rng,c);      checkSites(rng,c,draw,GridCounterRNG::Uniform);
+    draw=rng.Draws(); bernoulli(rng,r);   checkSites(rng,r,draw,GridCounterRNG::Bernoulli);
+  }
+
+  std::cout<<GridLogMessage<<"Checkerboard fill matches half of a full fill"<<std::endl;
+  {
+    GridCounterRNG rngA; rngA.SeedFixedIntegers(seeds);
+    GridCounterRNG rngB; rngB.SeedFixedIntegers(seeds);
+    LatticeFermionD full(UGrid);
+    LatticeFermionD odd(UrbGrid), ref(UrbGrid), diff(UrbGrid);
+    odd.Checkerboard()=Odd;
+    gaussian(rngA,full);
+    gaussian(rngB,odd);
+    pickCheckerboard(Odd,ref,full);
+    diff = ref - odd;
+    assert(norm2(diff)==0.0);
+  }
+
+  std::cout<<GridLogMessage<<"Single precision SIMD layout and state restore"<<std::endl;
+  {
+    GridCounterRNG rngD; rngD.SeedFixedIntegers(seeds);
+    GridCounterRNG rngF; rngF.SeedFixedIntegers(seeds);
+    LatticeFermionD psiD(UGrid);
+    LatticeFermionF psiF(UGridF), ref(UGridF), diff(UGridF);
+    gaussian(rngD,psiD);
+    gaussian(rngF,psiF);
+    precisionChange(ref,psiD);
+    diff = ref - psiF;
+    assert(norm2(diff)==0.0);
+
+    std::vector<uint32_t> state;
+    rngD.GetState(state);
+    gaussian(rngD,psiD);
+    LatticeFermionD again(UGrid), diffD(UGrid);
+    rngD.SetState(state);
+    gaussian(rngD,again);
+    diffD = again - psiD;
+    assert(norm2(diffD)==0.0);
+  }
+
+  std::cout<<GridLogMessage<<"Moments on a 5d field"<<std::endl;
+  {
+    LatticeComplexD c(FGrid);
+    RealD N = 2.0*FGrid->gSites();
+
+    gaussian(rng,c);
+    ComplexD s1 = sum(c);
+    RealD    s2 = norm2(c);
+    RealD mean = (real(s1)+imag(s1))/N;
+    RealD var  = s2/N - mean*mean;
+    std::cout<<GridLogMessage<<" gaussian mean "<<mean<<" variance "<<var<<std::endl;
+    assert(std::abs(mean)     < 5.0/std::sqrt(N));
+    assert(std::abs(var-1.0)  < 5.0*std::sqrt(2.0/N));
+
+    random(rng,c);
+    s1 = sum(c);
+    s2 = norm2(c);
+    mean = (real(s1)+imag(s1))/N;
+    var  = s2/N - mean*mean;
+    std::cout<<GridLogMessage<<" uniform  mean "<<mean<<" variance "<<var<<std::endl;
+    assert(std::abs(mean-0.5)      < 5.0*std::sqrt(1.0/12.0/N));
+    assert(std::abs(var-1.0/12.0)  < 5.0*std::sqrt(1.0/180.0/N));
+  }
+
+  std::cout<<GridLogMessage<<"Timing against GridParallelRNG"<<std::endl;
+  {
+    GridParallelRNG pRNG(FGrid); pRNG.SeedFixedIntegers(seeds);
+    LatticeFermionD psi(FGrid);
+    const int nloop=10;
+    double t0=usecond();
+    for(int i=0;i<nloop;i++) gaussian(pRNG,psi);
+    double t1=usecond();
+    for(int i=0;i<nloop;i++) gaussian(rng,psi);
+    double t2=usecond();
+    std::cout<<GridLogMessage<<" gaussian 5d fermion: GridParallelRNG "<<(t1-t0)/nloop/1000.<<" ms  GridCounterRNG "
+	     <<(t2-t1)/nloop/1000.<<" ms"<<std::endl;
+  }
+
+  std::cout<<GridLogMessage<<"Counter RNG test passed"<<std::endl;
+  Grid_finalize();
+}
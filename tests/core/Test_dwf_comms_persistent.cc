@@ -0,0 +1,97 @@
+    /*************************************************************************************
+
+    Grid physics library, www.github.com/paboyle/Grid
+
+    Source file: ./tests/core/Test_dwf_comms_persistent.cc
+
+    Copyright (C) 2015
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License along
+    with this program; if not, write to the Free Software Foundation, Inc.,
+    51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+
+    See the full license in the file "LICENSE" in the top level distribution directory
+    *************************************************************************************/
+    /*  END LEGAL */
+#include <Grid/Grid.h>
+
+using namespace std;
+using namespace Grid;
+
+int main (int argc, char ** argv)
+{
+  Grid_init(&argc,&argv);
+
+  const int Ls=8;
+  GridCartesian         * UGrid   = SpaceTimeGrid::makeFourDimGrid(GridDefaultLatt(), GridDefaultSimd(Nd,vComplex::Nsimd()),GridDefaultMpi());
+  GridCartesian         * FGrid   = SpaceTimeGrid::makeFiveDimGrid(Ls,UGrid);
+  GridRedBlackCartesian * UrbGrid = SpaceTimeGrid::makeFourDimRedBlackGrid(UGrid);
+  GridRedBlackCartesian * FrbGrid = SpaceTimeGrid::makeFiveDimRedBlackGrid(Ls,UGrid);
+
+  std::vector<int> seeds4({1,2,3,4});
+  std::vector<int> seeds5({5,6,7,8});
+
+  GridParallelRNG          RNG4(UGrid);  RNG4.SeedFixedIntegers(seeds4);
+  GridParallelRNG          RNG5(FGrid);  RNG5.SeedFixedIntegers(seeds5);
+
+  LatticeFermion src   (FGrid); random(RNG5,src);
+  LatticeGaugeField Umu(UGrid); SU<Nc>::HotConfiguration(RNG4,Umu);
+
+  RealD mass=0.1;
+  RealD M5  =1.8;
+  DomainWallFermionR Ddwf(Umu,*FGrid,*FrbGrid,*UGrid,*UrbGrid,mass,M5);
+
+  LatticeFermion src_o (FrbGrid);
+  LatticeFermion ref_e (FrbGrid);
+  LatticeFermion r_e   (FrbGrid);
+  LatticeFermion ref   (FGrid);
+  LatticeFermion result(FGrid);
+  LatticeFermion err   (FGrid);
+
+  pickCheckerboard(Odd,src_o,src);
+
+  std::cout<<GridLogMessage<<"=========================================================="<<std::endl;
+  std::cout<<GridLogMessage<<"= Testing persistent halo exchange against concurrent comms"<<std::endl;
+  std::cout<<GridLogMessage<<"=========================================================="<<std::endl;
+
+  int comms_save = WilsonKernelsStatic::Comms;
+  int comms[] = { WilsonKernelsStatic::CommsThenCompute, WilsonKernelsStatic::CommsAndCompute };
+
+  for(int c=0;c<2;c++){
+    WilsonKernelsStatic::Comms = comms[c];
+
+    CartesianCommunicator::SetCommunicatorPolicy(CartesianCommunicator::CommunicatorPolicyConcurrent);
+    Ddwf.Dhop(src,ref,DaggerNo);
+    Ddwf.DhopEO(src_o,ref_e,DaggerNo);
+
+    CartesianCommunicator::SetCommunicatorPolicy(CartesianCommunicator::CommunicatorPolicyPersistent);
+    // Repeat so that the second pass restarts the requests built by the first
+    for(int rep=0;rep<2;rep++){
+      Ddwf.Dhop(src,result,DaggerNo);
+      err = ref-result;
+      RealD nerr = norm2(err);
+      std::cout<<GridLogMessage<<"Dhop comms "<<c<<" pass "<<rep<<" error "<< nerr <<std::endl;
+      assert(nerr == 0.0);
+
+      Ddwf.DhopEO(src_o,r_e,DaggerNo);
+      LatticeFermion err_e = ref_e-r_e;
+      nerr = norm2(err_e);
+      std::cout<<GridLogMessage<<"DhopEO comms "<<c<<" pass "<<rep<<" error "<< nerr <<std::endl;
+      assert(nerr == 0.0);
+    }
+  }
+  WilsonKernelsStatic::Comms = comms_save;
+  CartesianCommunicator::SetCommunicatorPolicy(CartesianCommunicator::CommunicatorPolicyConcurrent);
+
+  Grid_finalize();
+}
@@ -0,0 +1,128 @@
+    /*************************************************************************************
+
+    Grid physics library, www.github.com/paboyle/Grid 
+
+    Source file: ./tests/core/Test_dwf_multirhs_dhop.cc
+
+    Copyright (C) 2015
+
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License along
+    with this program; if not, write to the Free Software Foundation, Inc.,
+    51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+
+    See the full license in the file "LICENSE" in the top level distribution directory
+    *************************************************************************************/
+    /*  END LEGAL */
+#include <Grid/Grid.h>
+
+using namespace std;
+using namespace Grid;
+
+int main (int argc, char ** argv)
+{
+  Grid_init(&argc,&argv);
+
+  const int Ls=8;
+  const int nrhs=4;
+
+  GridCartesian         * UGrid   = SpaceTimeGrid::makeFourDimGrid(GridDefaultLatt(), GridDefaultSimd(Nd,vComplex::Nsimd()),GridDefaultMpi());
+  GridRedBlackCartesian * UrbGrid = SpaceTimeGrid::makeFourDimRedBlackGrid(UGrid);
+  GridCartesian         * FGrid   = SpaceTimeGrid::makeFiveDimGrid(Ls,UGrid);
+  GridRedBlackCartesian * FrbGrid = SpaceTimeGrid::makeFiveDimRedBlackGrid(Ls,UGrid);
+
+  // Fused grids carry all right hand sides in the fifth dimension
+  GridCartesian         * FGridN   = SpaceTimeGrid::makeFiveDimGrid(Ls*nrhs,UGrid);
+  GridRedBlackCartesian * FrbGridN = SpaceTimeGrid::makeFiveDimRedBlackGrid(Ls*nrhs,UGrid);
+  GridCartesian         * WGridN   = SpaceTimeGrid::makeFiveDimGrid(nrhs,UGrid);
+  GridRedBlackCartesian * WrbGridN = SpaceTimeGrid::makeFiveDimRedBlackGrid(nrhs,UGrid);
+
+  std::vector<int> seeds4({1,2,3,4});
+  std::vector<int> seeds5({5,6,7,8});
+  GridParallelRNG          RNG4(UGrid);  RNG4.SeedFixedIntegers(seeds4);
+  GridParallelRNG          RNG5(FGrid);  RNG5.SeedFixedIntegers(seeds5);
+
+  LatticeGaugeField Umu(UGrid); SU<Nc>::HotConfiguration(RNG4,Umu);
+
+  RealD mass=0.1;
+  RealD M5  =1.8;
+  DomainWallFermionR Ddwf (Umu,*FGrid ,*FrbGrid ,*UGrid,*UrbGrid,mass,M5);
+  DomainWallFermionR DdwfN(Umu,*FGridN,*FrbGridN,*UGrid,*UrbGrid,mass,M5);
+
+  std::cout<<GridLogMessage<<"=========================================================="<<std::endl;
+  std::cout<<GridLogMessage<<"= Testing fused multi-RHS DWF Dhop against single RHS "<<std::endl;
+  std::cout<<GridLogMessage<<"=========================================================="<<std::endl;
+  {
+    std::vector<LatticeFermion> src(nrhs,FGrid);
+    std::vector<LatticeFermion> res(nrhs,FGrid);
+    std::vector<LatticeFermion> src_o(nrhs,FrbGrid);
+    std::vector<LatticeFermion> res_e(nrhs,FrbGrid);
+    for(int n=0;n<nrhs;n++){
+      random(RNG5,src[n]);
+      pickCheckerboard(Odd,src_o[n],src[n]);
+    }
+    for(int dag=DaggerNo;dag<=DaggerYes;dag++){
+      DdwfN.DhopMultiRHS(src,res,dag);
+      DdwfN.DhopMultiRHS(src_o,res_e,dag);
+      for(int n=0;n<nrhs;n++){
+	LatticeFermion ref(FGrid);
+	LatticeFermion ref_e(FrbGrid);
+	Ddwf.Dhop(src[n],ref,dag);
+	Ddwf.DhopEO(src_o[n],ref_e,dag);
+	ref   = ref - res[n];
+	ref_e = ref_e - res_e[n];
+	RealD err  = norm2(ref);
+	RealD errEO= norm2(ref_e);
+	std::cout<<GridLogMessage<<"dag "<<dag<<" rhs "<<n<<" Dhop error "<<err<<" DhopEO error "<<errEO<<std::endl;
+	assert(err   < 1.0e-20);
+	assert(errEO < 1.0e-20);
+	assert(res_e[n].Checkerboard()==Even);
+      }
+    }
+  }
+
+  std::cout<<GridLogMessage<<"=========================================================="<<std::endl;
+  std::cout<<GridLogMessage<<"= Testing fused multi-RHS Wilson Dhop against single RHS "<<std::endl;
+  std::cout<<GridLogMessage<<"=========================================================="<<std::endl;
+  {
+    RealD wmass=0.1;
+    WilsonFermionR Dw(Umu,*UGrid,*UrbGrid,wmass);
+    WilsonFermion5D<WilsonImplR> DwN(Umu,*WGridN,*WrbGridN,*UGrid,*UrbGrid,M5);
+
+    std::vector<LatticeFermion> src(nrhs,UGrid);
+    std::vector<LatticeFermion> res(nrhs,UGrid);
+    for(int n=0;n<nrhs;n++) gaussian(RNG4,src[n]);
+
+    DwN.DhopMultiRHS(src,res,DaggerNo);
+    for(int n=0;n<nrhs;n++){
+      LatticeFermion ref(UGrid);
+      Dw.Dhop(src[n],ref,DaggerNo);
+      ref = ref - res[n];
+      RealD err = norm2(ref);
+      std::cout<<GridLogMessage<<"rhs "<<n<<" Dhop error "<<err<<std::endl;
+      assert(err < 1.0e-20);
+    }
+
+    // Round trip through the fused layout is exact
+    LatticeFermion fused(WGridN);
+    DwN.ImportMultiRHS(src,fused);
+    DwN.ExportMultiRHS(fused,res);
+    for(int n=0;n<nrhs;n++){
+      LatticeFermion diff = src[n]-res[n];
+      assert(norm2(diff)==0.0);
+    }
+  }
+
+  std::cout<<GridLogMessage<<"Multi-RHS Dhop test passed"<<std::endl;
+  Grid_finalize();
+}
@@ -0,0 +1,101 @@
+    /*************************************************************************************
+
+    Grid physics library, www.github.com/paboyle/Grid
+
+    Source file: ./tests/core/Test_fused_blas.cc
+
+    Copyright (C) 2015
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License along
+    with this program; if not, write to the Free Software Foundation, Inc.,
+    51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+
+    See the full license in the file "LICENSE" in the top level distribution directory
+    *************************************************************************************/
+    /*  END LEGAL */
+#include <Grid/Grid.h>
+
+using namespace std;
+using namespace Grid;
+
+RealD relerr(const LatticeFermion &a,const LatticeFermion &b)
+{
+  LatticeFermion d = a-b;
+  return std::sqrt(norm2(d)/norm2(b));
+}
+
+int main (int argc, char ** argv)
+{
+  Grid_init(&argc,&argv);
+
+  GridCartesian * Grid = SpaceTimeGrid::makeFourDimGrid(GridDefaultLatt(), GridDefaultSimd(Nd,vComplex::Nsimd()),GridDefaultMpi());
+
+  GridParallelRNG pRNG(Grid); pRNG.SeedFixedIntegers(std::vector<int>({1,2,3,4}));
+
+  LatticeFermion psi(Grid); gaussian(pRNG,psi);
+  LatticeFermion p(Grid);   gaussian(pRNG,p);
+  LatticeFermion r(Grid);   gaussian(pRNG,r);
+  LatticeFermion q(Grid);   gaussian(pRNG,q);
+  LatticeFermion w(Grid);   gaussian(pRNG,w);
+
+  RealD a = 0.37;
+  RealD b =-1.21;
+  RealD tol = 1.0e-12;
+
+  std::cout<<GridLogMessage<<"axpy_axpy with aliased CG update psi = a p + psi ; p = b p + r"<<std::endl;
+  {
+    LatticeFermion psi_ref = a*p + psi;
+    LatticeFermion p_ref   = b*p + r;
+    LatticeFermion psi_f = psi;
+    LatticeFermion p_f   = p;
+    axpy_axpy(psi_f,a,p_f,psi_f,p_f,b,p_f,r);
+    std::cout<<GridLogMessage<<" psi "<<relerr(psi_f,psi_ref)<<" p "<<relerr(p_f,p_ref)<<std::endl;
+    assert(relerr(psi_f,psi_ref)<tol);
+    assert(relerr(p_f,p_ref)<tol);
+  }
+
+  std::cout<<GridLogMessage<<"axpy_axpy_norm psi = a p + psi ; r = b q + r"<<std::endl;
+  {
+    LatticeFermion psi_ref = a*p + psi;
+    LatticeFermion r_ref   = b*q + r;
+    RealD nrm_ref = norm2(r_ref);
+    LatticeFermion psi_f = psi;
+    LatticeFermion r_f   = r;
+    RealD nrm = axpy_axpy_norm(psi_f,a,p,psi_f,r_f,b,q,r_f);
+    std::cout<<GridLogMessage<<" psi "<<relerr(psi_f,psi_ref)<<" r "<<relerr(r_f,r_ref)
+	     <<" norm "<<nrm<<" "<<nrm_ref<<std::endl;
+    assert(relerr(psi_f,psi_ref)<tol);
+    assert(relerr(r_f,r_ref)<tol);
+    assert(std::abs(nrm-nrm_ref)<tol*nrm_ref);
+  }
+
+  std::cout<<GridLogMessage<<"axpy_axpy_norm_inner psi = a p + psi ; r = b q + r ; <w,r>"<<std::endl;
+  {
+    LatticeFermion psi_ref = a*p + psi;
+    LatticeFermion r_ref   = b*q + r;
+    RealD    nrm_ref = norm2(r_ref);
+    ComplexD ip_ref  = innerProduct(w,r_ref);
+    LatticeFermion psi_f = psi;
+    LatticeFermion r_f   = r;
+    ComplexD ip;
+    RealD nrm = axpy_axpy_norm_inner(ip,psi_f,a,p,psi_f,r_f,b,q,r_f,w);
+    std::cout<<GridLogMessage<<" norm "<<nrm<<" "<<nrm_ref<<" inner "<<ip<<" "<<ip_ref<<std::endl;
+    assert(relerr(psi_f,psi_ref)<tol);
+    assert(relerr(r_f,r_ref)<tol);
+    assert(std::abs(nrm-nrm_ref)<tol*nrm_ref);
+    assert(std::abs(ip-ip_ref)<tol*std::abs(ip_ref));
+  }
+
+  std::cout<<GridLogMessage<<"Fused BLAS test passed"<<std::endl;
+  Grid_finalize();
+}
@@ -0,0 +1,102 @@
+    /*************************************************************************************
+
+    Grid physics library, www.github.com/paboyle/Grid
+
+    Source file: ./tests/core/Test_fused_expression.cc
+
+    Copyright (C) 2015
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License along
+    with this program; if not, write to the Free Software Foundation, Inc.,
+    51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+
+    See the full license in the file "LICENSE" in the top level distribution directory
+    *************************************************************************************/
+    /*  END LEGAL */
+#include <Grid/Grid.h>
+
+using namespace std;
+using namespace Grid;
+
+template<class Field> RealD relerr(const Field &a,const Field &b)
+{
+  Field d = a-b;
+  return std::sqrt(norm2(d)/norm2(b));
+}
+
+int main (int argc, char ** argv)
+{
+  Grid_init(&argc,&argv);
+
+  GridCartesian * Grid = SpaceTimeGrid::makeFourDimGrid(GridDefaultLatt(), GridDefaultSimd(Nd,vComplex::Nsimd()),GridDefaultMpi());
+  GridRedBlackCartesian * RBGrid = SpaceTimeGrid::makeFourDimRedBlackGrid(Grid);
+
+  GridParallelRNG pRNG(Grid); pRNG.SeedFixedIntegers(std::vector<int>({1,2,3,4}));
+
+  RealD tol = 1.0e-13;
+
+  std::cout<<GridLogMessage<<"a = b*c ; d = a + e ; n = norm2(d) ; ip = <b,d>"<<std::endl;
+  {
+    LatticeColourMatrix b(Grid); gaussian(pRNG,b);
+    LatticeColourMatrix c(Grid); gaussian(pRNG,c);
+    LatticeColourMatrix e(Grid); gaussian(pRNG,e);
+
+    LatticeColourMatrix a_ref(Grid), d_ref(Grid);
+    a_ref = b*c;
+    d_ref = a_ref + e;
+    RealD    n_ref  = norm2(d_ref);
+    ComplexD ip_ref = innerProduct(b,d_ref);
+
+    LatticeColourMatrix a(Grid), d(Grid);
+    RealD    n;
+    ComplexD ip;
+    fusedEval(fusedAssign(a, b*c),
+	      fusedAssign(d, a+e),
+	      fusedNorm2(n, d),
+	      fusedInnerProduct(ip, b, d));
+
+    std::cout<<GridLogMessage<<" a "<<relerr(a,a_ref)<<" d "<<relerr(d,d_ref)
+	     <<" norm "<<n<<" "<<n_ref<<" ip "<<ip<<" "<<ip_ref<<std::endl;
+    assert(relerr(a,a_ref)<tol);
+    assert(relerr(d,d_ref)<tol);
+    assert(std::abs(n-n_ref)<tol*n_ref);
+    assert(std::abs(ip-ip_ref)<tol*std::abs(ip_ref));
+  }
+
+  std::cout<<GridLogMessage<<"Reductions of expressions and checkerboarded outputs"<<std::endl;
+  {
+    LatticeFermion x(Grid); gaussian(pRNG,x);
+    LatticeFermion y(Grid); gaussian(pRNG,y);
+    LatticeFermion xo(RBGrid), yo(RBGrid), zo(RBGrid), zo_ref(RBGrid);
+    pickCheckerboard(Odd,xo,x);
+    pickCheckerboard(Odd,yo,y);
+
+    zo_ref = 2.0*xo - timesI(yo);
+    RealD n_ref = norm2(zo_ref);
+    RealD nx_ref = norm2(xo);
+
+    RealD n, nx;
+    fusedEval(fusedAssign(zo, 2.0*xo - timesI(yo)),
+	      fusedNorm2(nx, xo),
+	      fusedNorm2(n, 2.0*xo - timesI(yo)));
+
+    std::cout<<GridLogMessage<<" z "<<relerr(zo,zo_ref)<<" norm "<<n<<" "<<n_ref<<std::endl;
+    assert(zo.Checkerboard()==Odd);
+    assert(relerr(zo,zo_ref)<tol);
+    assert(std::abs(n-n_ref)<tol*n_ref);
+    assert(std::abs(nx-nx_ref)<tol*nx_ref);
+  }
+
+  std::cout<<GridLogMessage<<"Fused expression test passed"<<std::endl;
+  Grid_finalize();
+}
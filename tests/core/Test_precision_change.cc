@@ -0,0 +1,108 @@
+    /*************************************************************************************
+
+    Grid physics library, www.github.com/paboyle/Grid
+
+    Source file: ./tests/core/Test_precision_change.cc
+
+    Copyright (C) 2015
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License along
+    with this program; if not, write to the Free Software Foundation, Inc.,
+    51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+
+    See the full license in the file "LICENSE" in the top level distribution directory
+    *************************************************************************************/
+    /*  END LEGAL */
+#include <Grid/Grid.h>
+
+using namespace Grid;
+
+// Reference conversion through the lexicographic scalar array
+template<class VobjOut, class VobjIn>
+void precisionChangeReference(Lattice<VobjOut> &out, const Lattice<VobjIn> &in)
+{
+  typedef typename VobjOut::scalar_object SobjOut;
+  std::vector<SobjOut> in_slex(in.Grid()->lSites());
+  unvectorizeToLexOrdArray(in_slex, in);
+  vectorizeFromLexOrdArray(in_slex, out);
+  out.Checkerboard() = in.Checkerboard();
+}
+
+template<class FieldD,class FieldF>
+bool checkPrecisionChange(GridBase *fullD, GridBase *gridD, GridBase *gridF, GridParallelRNG &RNG, int cb)
+{
+  FieldD src(gridD);
+  FieldD full(fullD);
+  gaussian(RNG,full);
+  if ( gridD->_isCheckerBoarded ) pickCheckerboard(cb,src,full);
+  else                            src = full;
+
+  FieldF  resF(gridF), refF(gridF);
+  FieldD  resD(gridD);
+
+  precisionChange(resF,src);
+  precisionChangeReference(refF,src);
+  FieldF  diffF = resF - refF;
+  RealD errF = norm2(diffF);
+
+  // Second call hits the cached workspace
+  precisionChange(resF,src);
+  diffF = resF - refF;
+  errF += norm2(diffF);
+
+  precisionChange(resD,resF);
+  FieldD diffD = resD - src;
+  RealD errD = norm2(diffD)/norm2(src);
+
+  std::cout << GridLogMessage << " D->F error vs reference " << errF
+	    << " F->D roundtrip relative error " << errD
+	    << " cb " << resD.Checkerboard() << std::endl;
+
+  return (errF == 0.0) && (errD < 1.0e-12) && (resD.Checkerboard() == src.Checkerboard());
+}
+
+int main (int argc, char ** argv)
+{
+  Grid_init(&argc,&argv);
+
+  Coordinate latt_size   = GridDefaultLatt();
+  Coordinate mpi_layout  = GridDefaultMpi();
+  Coordinate simd_layoutD = GridDefaultSimd(Nd,vComplexD::Nsimd());
+  Coordinate simd_layoutF = GridDefaultSimd(Nd,vComplexF::Nsimd());
+
+  GridCartesian         GridD(latt_size,simd_layoutD,mpi_layout);
+  GridCartesian         GridF(latt_size,simd_layoutF,mpi_layout);
+  GridRedBlackCartesian RBGridD(&GridD);
+  GridRedBlackCartesian RBGridF(&GridF);
+
+  GridParallelRNG RNG(&GridD);  RNG.SeedFixedIntegers(std::vector<int>({45,12,81,9}));
+
+  bool ok = true;
+
+  std::cout << GridLogMessage << "Full grid LatticeFermion" << std::endl;
+  ok = ok && checkPrecisionChange<LatticeFermionD,LatticeFermionF>(&GridD,&GridD,&GridF,RNG,Even);
+
+  std::cout << GridLogMessage << "Full grid LatticeGaugeField" << std::endl;
+  ok = ok && checkPrecisionChange<LatticeGaugeFieldD,LatticeGaugeFieldF>(&GridD,&GridD,&GridF,RNG,Even);
+
+  std::cout << GridLogMessage << "Red-black grid LatticeFermion even" << std::endl;
+  ok = ok && checkPrecisionChange<LatticeFermionD,LatticeFermionF>(&GridD,&RBGridD,&RBGridF,RNG,Even);
+
+  std::cout << GridLogMessage << "Red-black grid LatticeFermion odd" << std::endl;
+  ok = ok && checkPrecisionChange<LatticeFermionD,LatticeFermionF>(&GridD,&RBGridD,&RBGridF,RNG,Odd);
+
+  assert(ok);
+  std::cout << GridLogMessage << "precisionChange test passed" << std::endl;
+
+  Grid_finalize();
+}
@@ -0,0 +1,85 @@
+    /*************************************************************************************
+
+    Grid physics library, www.github.com/paboyle/Grid
+
+    Source file: ./tests/core/Test_reduction_nonblocking.cc
+
+    Copyright (C) 2015
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License along
+    with this program; if not, write to the Free Software Foundation, Inc.,
+    51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+
+    See the full license in the file "LICENSE" in the top level distribution directory
+    *************************************************************************************/
+    /*  END LEGAL */
+#include <Grid/Grid.h>
+
+using namespace std;
+using namespace Grid;
+
+int main (int argc, char ** argv)
+{
+  Grid_init(&argc,&argv);
+
+  GridCartesian * Grid = SpaceTimeGrid::makeFourDimGrid(GridDefaultLatt(), GridDefaultSimd(Nd,vComplex::Nsimd()),GridDefaultMpi());
+
+  GridParallelRNG pRNG(Grid); pRNG.SeedFixedIntegers(std::vector<int>({1,2,3,4}));
+
+  LatticeFermion x(Grid); gaussian(pRNG,x);
+  LatticeFermion y(Grid); gaussian(pRNG,y);
+  LatticeFermion z(Grid);
+
+  ComplexD ip_ref = innerProduct(x,y);
+  RealD    nx_ref = norm2(x);
+  RealD    ny_ref = norm2(y);
+
+  std::cout<<GridLogMessage<<"Non-blocking reductions against blocking"<<std::endl;
+
+  // Several reductions in flight at once, with local work in between
+  auto ip = innerProductBegin(x,y);
+  auto nx = norm2Begin(x);
+  z = x+y;
+  auto ny = norm2Begin(y);
+
+  // Moving an in-flight future is safe
+  std::vector<GlobalSumFuture<RealD> > pending;
+  pending.push_back(std::move(ny));
+
+  while ( !ip.test() ) ;
+
+  ComplexD ip_nb = ip.wait();
+  RealD    nx_nb = nx.wait();
+  RealD    ny_nb = pending[0].wait();
+
+  std::cout<<GridLogMessage<<"innerProduct "<<ip_ref<<" "<<ip_nb<<std::endl;
+  std::cout<<GridLogMessage<<"norm2 x      "<<nx_ref<<" "<<nx_nb<<std::endl;
+  std::cout<<GridLogMessage<<"norm2 y      "<<ny_ref<<" "<<ny_nb<<std::endl;
+
+  // Same local sums; MPI may order the blocking and non-blocking reductions differently
+  const RealD tol = 1.0e-14;
+  assert(abs(ip_nb-ip_ref) <= tol*abs(ip_ref));
+  assert(std::abs(nx_nb-nx_ref) <= tol*nx_ref);
+  assert(std::abs(ny_nb-ny_ref) <= tol*ny_ref);
+
+  // wait() may be called repeatedly and returns the same result
+  assert(ip.wait() == ip_nb);
+
+  // Futures dropped without wait() complete in the destructor
+  {
+    auto dropped = norm2Begin(z);
+  }
+
+  std::cout<<GridLogMessage<<"Non-blocking reduction test passed"<<std::endl;
+  Grid_finalize();
+}
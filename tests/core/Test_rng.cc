@@ -31,6 +31,27 @@ using namespace std;
 using namespace Grid;
  ;
 
+#ifdef RNG_FAST_DISCARD
+// Reference reproducible seeding: every rank walks the global volume and keeps its own sites
+void SeedGlobalLoop(GridParallelRNG &pRNG,const std::vector<int> &seeds)
+{
+  GridBase *grid = pRNG.Grid();
+  std::seed_seq source(seeds.begin(),seeds.end());
+  GridRNGbase::RngEngine master_engine(source);
+  thread_for( gidx, grid->_gsites, {
+    int rank, o_idx, i_idx;
+    Coordinate gcoor;
+    grid->GlobalIndexToGlobalCoor(gidx,gcoor);
+    grid->GlobalCoorToRankIndex(rank,o_idx,i_idx,gcoor);
+    if( rank == grid->ThisRank() ){
+      int l_idx=pRNG.generator_idx(o_idx,i_idx);
+      pRNG._generators[l_idx] = master_engine;
+      GridRNGbase::Skip(pRNG._generators[l_idx],gidx);
+    }
+  });
+}
+#endif
+
 int main (int argc, char ** argv)
 {
   Grid_init(&argc,&argv);
@@ -73,5 +94,41 @@ int main (int argc, char ** argv)
   random(fpRNG,lcv);
   std::cout<<GridLogMessage<<"Random Lattice Colour Vector (fixed seed)\n"<< lcv<<std::endl;
 
+#ifdef RNG_FAST_DISCARD
+  std::cout<<GridLogMessage<<"Reproducible seeding: local sites vs global volume loop"<<std::endl;
+  for(int L=4;L<=GridDefaultLatt()[0];L*=2){
+    Coordinate latt(4,L);
+    int ok=1;
+    for(int d=0;d<4;d++) ok = ok && (L%(mpi_layout[d]*simd_layout[d])==0);
+    if ( !ok ) continue;
+    GridCartesian SGrid(latt,simd_layout,mpi_layout);
+    GridParallelRNG lRNG(&SGrid);
+    GridParallelRNG gRNG(&SGrid);
+
+    lRNG.SeedFixedIntegers(seeds); // touch the generator storage before timing
+    SeedGlobalLoop(gRNG,seeds);
+
+    double t0=usecond();
+    lRNG.SeedFixedIntegers(seeds);
+    double t1=usecond();
+    SeedGlobalLoop(gRNG,seeds);
+    double t2=usecond();
+
+    uint32_t same=1;
+    for(int l=0;l<SGrid.lSites();l++) same = same && (lRNG._generators[l]==gRNG._generators[l]);
+    SGrid.GlobalSum(same);
+    assert(same==SGrid._Nprocessors);
+
+    LatticeColourVector a(&SGrid), b(&SGrid), diff(&SGrid);
+    gaussian(lRNG,a);
+    gaussian(gRNG,b);
+    diff = a - b;
+    assert(norm2(diff)==0.0);
+
+    std::cout<<GridLogMessage<<" "<<latt<<" local volume "<<SGrid.lSites()
+	     <<" seeding "<<(t1-t0)/1000.<<" ms; global loop "<<(t2-t1)/1000.<<" ms"<<std::endl;
+  }
+#endif
+
   Grid_finalize();
 }
@@ -0,0 +1,150 @@
+    /*************************************************************************************
+
+    Grid physics library, www.github.com/paboyle/Grid
+
+    Source file: ./tests/core/Test_site_layout.cc
+
+    Copyright (C) 2015
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License along
+    with this program; if not, write to the Free Software Foundation, Inc.,
+    51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+
+    See the full license in the file "LICENSE" in the top level distribution directory
+    *************************************************************************************/
+    /*  END LEGAL */
+#include <Grid/Grid.h>
+
+using namespace std;
+using namespace Grid;
+
+// Compare two fields site by site in global lexicographic order, so that
+// fields living on grids with different outer site layouts can be compared.
+template<class vobj> RealD lexdiff(const Lattice<vobj> &a,const Lattice<vobj> &b)
+{
+  typedef typename vobj::scalar_object sobj;
+  std::vector<sobj> ba, bb;
+  unvectorizeToLexOrdArray(ba,a);
+  unvectorizeToLexOrdArray(bb,b);
+  RealD d=0.0;
+  for(int i=0;i<ba.size();i++) d+= norm2(ba[i]-bb[i]);
+  return d;
+}
+
+int main (int argc, char ** argv)
+{
+  Grid_init(&argc,&argv);
+
+  Coordinate latt_size   = GridDefaultLatt();
+  Coordinate simd_layout = GridDefaultSimd(Nd,vComplex::Nsimd());
+  Coordinate mpi_layout  = GridDefaultMpi();
+  const int Ls = 4;
+  RealD mass = 0.1;
+  RealD M5   = 1.8;
+
+  GridCartesian         * ULex  = SpaceTimeGrid::makeFourDimGrid(latt_size,simd_layout,mpi_layout);
+  GridRedBlackCartesian * UrbLex= SpaceTimeGrid::makeFourDimRedBlackGrid(ULex);
+  GridCartesian         * FLex  = SpaceTimeGrid::makeFiveDimGrid(Ls,ULex);
+  GridRedBlackCartesian * FrbLex= SpaceTimeGrid::makeFiveDimRedBlackGrid(Ls,ULex);
+
+  GridParallelRNG RNG4Lex(ULex); RNG4Lex.SeedFixedIntegers(std::vector<int>({1,2,3,4}));
+  GridParallelRNG RNG5Lex(FLex); RNG5Lex.SeedFixedIntegers(std::vector<int>({5,6,7,8}));
+
+  LatticeGaugeField UmuLex(ULex); SU<Nc>::HotConfiguration(RNG4Lex,UmuLex);
+  LatticeFermion    srcLex(FLex); gaussian(RNG5Lex,srcLex);
+
+  DomainWallFermionR DdwfLex(UmuLex,*FLex,*FrbLex,*ULex,*UrbLex,mass,M5);
+  LatticeFermion DsrcLex(FLex);  DdwfLex.M(srcLex,DsrcLex);
+  LatticeGaugeField ShiftLex(ULex);
+
+  std::vector<int> layouts({GridBase::SiteLayoutMorton,GridBase::SiteLayoutHilbert});
+  std::vector<std::string> names({"Morton","Hilbert"});
+  for(int l=0;l<layouts.size();l++){
+
+    std::cout<<GridLogMessage<<"Comparing "<<names[l]<<" site layout against lexicographic"<<std::endl;
+
+    GridCartesian * UGrid = SpaceTimeGrid::makeFourDimGrid(latt_size,simd_layout,mpi_layout);
+    UGrid->SetSiteLayout(layouts[l],2);
+    GridRedBlackCartesian * UrbGrid = SpaceTimeGrid::makeFourDimRedBlackGrid(UGrid);
+    GridCartesian         * FGrid   = SpaceTimeGrid::makeFiveDimGrid(Ls,UGrid);
+    GridRedBlackCartesian * FrbGrid = SpaceTimeGrid::makeFiveDimRedBlackGrid(Ls,UGrid);
+    assert(FGrid->SiteLayout()==layouts[l]);
+
+    // Seeding goes through global coordinates so the fields are identical
+    GridParallelRNG RNG4(UGrid); RNG4.SeedFixedIntegers(std::vector<int>({1,2,3,4}));
+    GridParallelRNG RNG5(FGrid); RNG5.SeedFixedIntegers(std::vector<int>({5,6,7,8}));
+    LatticeGaugeField Umu(UGrid); SU<Nc>::HotConfiguration(RNG4,Umu);
+    LatticeFermion    src(FGrid); gaussian(RNG5,src);
+    RealD d = lexdiff(Umu,UmuLex);
+    std::cout<<GridLogMessage<<" random gauge field diff "<<d<<std::endl;
+    assert(d==0.0);
+    d = lexdiff(src,srcLex);
+    std::cout<<GridLogMessage<<" random fermion field diff "<<d<<std::endl;
+    assert(d==0.0);
+
+    // Cshift
+    LatticeGaugeField Shift(UGrid);
+    for(int mu=0;mu<Nd;mu++){
+      Shift    = Cshift(Umu,mu,1)    - Cshift(Umu,mu,-2);
+      ShiftLex = Cshift(UmuLex,mu,1) - Cshift(UmuLex,mu,-2);
+      d = lexdiff(Shift,ShiftLex);
+      std::cout<<GridLogMessage<<" Cshift mu="<<mu<<" diff "<<d<<std::endl;
+      assert(d<1.0e-20);
+    }
+
+    // Slice sums
+    for(int mu=0;mu<Nd;mu++){
+      std::vector<LatticeGaugeField::scalar_object> s, sLex;
+      sliceSum(Umu,s,mu);
+      sliceSum(UmuLex,sLex,mu);
+      d = 0.0;
+      for(int t=0;t<s.size();t++) d+= norm2(s[t]-sLex[t]);
+      std::cout<<GridLogMessage<<" sliceSum mu="<<mu<<" diff "<<d<<std::endl;
+      assert(d<1.0e-20);
+    }
+
+    // Stencil based operator, including even/odd projections
+    DomainWallFermionR Ddwf(Umu,*FGrid,*FrbGrid,*UGrid,*UrbGrid,mass,M5);
+    LatticeFermion Dsrc(FGrid);
+    Ddwf.M(src,Dsrc);
+    d = lexdiff(Dsrc,DsrcLex);
+    std::cout<<GridLogMessage<<" DWF M diff "<<d<<std::endl;
+    assert(d<1.0e-20*norm2(DsrcLex));
+
+    LatticeFermion src_o(FrbGrid), src_oLex(FrbLex), r_o(FrbGrid), r_oLex(FrbLex);
+    pickCheckerboard(Odd,src_o,src);
+    pickCheckerboard(Odd,src_oLex,srcLex);
+    d = lexdiff(src_o,src_oLex);
+    std::cout<<GridLogMessage<<" pickCheckerboard diff "<<d<<std::endl;
+    assert(d==0.0);
+    Ddwf.Meooe(src_o,r_o);
+    DdwfLex.Meooe(src_oLex,r_oLex);
+    d = lexdiff(r_o,r_oLex);
+    std::cout<<GridLogMessage<<" DWF Meooe diff "<<d<<std::endl;
+    assert(d<1.0e-20*norm2(r_oLex));
+
+    LatticeFermion back(FGrid); back=Zero();
+    setCheckerboard(back,r_o);
+    RealD n = norm2(back);
+    RealD nLex = norm2(r_oLex);
+    assert(std::fabs(n-nLex)<1.0e-12*nLex);
+
+    delete FrbGrid;
+    delete FGrid;
+    delete UrbGrid;
+    delete UGrid;
+  }
+
+  std::cout<<GridLogMessage<<"Site layout test passed"<<std::endl;
+  Grid_finalize();
+}
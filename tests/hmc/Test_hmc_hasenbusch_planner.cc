@@ -0,0 +1,130 @@
+/*************************************************************************************
+
+Grid physics library, www.github.com/paboyle/Grid
+
+Source file: ./tests/hmc/Test_hmc_hasenbusch_planner.cc
+
+Copyright (C) 2015
+
+This program is free software; you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation; either version 2 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along
+with this program; if not, write to the Free Software Foundation, Inc.,
+51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+
+See the full license in the file "LICENSE" in the top level distribution
+directory
+*************************************************************************************/
+/*  END LEGAL */
+#include <Grid/Grid.h>
+
+using namespace Grid;
+
+int main(int argc, char **argv) {
+  Grid_init(&argc, &argv);
+
+  typedef PeriodicGimplR Gimpl;
+  typedef NoSmearing<Gimpl> Smearing;
+  typedef MinimumNorm2<Gimpl, Smearing> Omelyan;
+  typedef Gimpl::Field Field;
+  typedef WilsonImplR FermionImplPolicy;
+  typedef WilsonFermionR FermionAction;
+  typedef typename FermionAction::FermionField FermionField;
+
+  GridCartesian         *UGrid   = SpaceTimeGrid::makeFourDimGrid(GridDefaultLatt(), GridDefaultSimd(Nd, vComplex::Nsimd()), GridDefaultMpi());
+  GridRedBlackCartesian *UrbGrid = SpaceTimeGrid::makeFourDimRedBlackGrid(UGrid);
+
+  GridSerialRNG   sRNG; sRNG.SeedFixedIntegers(std::vector<int>({1, 2, 3, 4}));
+  GridParallelRNG pRNG(UGrid); pRNG.SeedFixedIntegers(std::vector<int>({5, 6, 7, 8}));
+
+  Field U(UGrid);
+  SU<Nc>::TepidConfiguration(pRNG, U);
+
+  WilsonGaugeActionR Waction(5.6);
+  ConjugateGradient<FermionField> CG(1.0e-10, 5000);
+
+  // Reference: one Hasenbusch mass, fermions on level 0, gauge on level 1
+  ActionSet<Field, NoHirep> Fixed(2);
+  Fixed[1].multiplier = 4;
+  Fixed[1].push_back(&Waction);
+
+  HMCparameters HMCpar;
+  HMCpar.MD = IntegratorParameters(8, 1.0);
+  HMCpar.MD.name = "MinimumNorm2";
+
+  HasenbuschPlannerParameters Par;
+  Par.light_mass     = 0.05;
+  Par.pv_mass        = 1.0;
+  Par.hasenbusch     = std::vector<RealD>({0.3});
+  Par.scan_points    = 3;
+  Par.max_hasenbusch = 2;
+  Par.max_multiplier = 6;
+
+  HasenbuschPlanner<FermionImplPolicy> Planner(Par, HMCpar.MD,
+    [&](RealD mass) { return new FermionAction(U, *UGrid, *UrbGrid, mass); }, CG);
+
+  std::cout << GridLogMessage << "Force measurement" << std::endl;
+  Planner.Measure(U, Fixed, sRNG, pRNG);
+  HasenbuschPlan ref  = Planner.Reference();
+  HasenbuschPlan plan = Planner.Plan();
+
+  // The reference is one of the candidates
+  assert(plan.cost <= ref.cost * (1.0 + 1.0e-12));
+  assert(plan.error <= 1.0 + 1.0e-12);
+  assert(plan.levels.size() == plan.hasenbusch.size() + 1);
+  assert(plan.multipliers.size() == 2);
+
+  std::cout << GridLogMessage << "Parameter file round trip" << std::endl;
+  Planner.Write("hasenbusch_plan.xml", HMCpar, plan);
+  UGrid->Barrier();
+  XmlReader RD("hasenbusch_plan.xml");
+  HMCparameters inHMC(RD);
+  HasenbuschPlan in;
+  read(RD, "Hasenbusch", in);
+  assert(inHMC.MD.MDsteps == plan.MDsteps);
+  assert(in.hasenbusch == plan.hasenbusch);
+  assert(in.levels == plan.levels);
+  assert(in.multipliers == plan.multipliers);
+
+  std::cout << GridLogMessage << "One trajectory with the plan and its force balance" << std::endl;
+  {
+    std::vector<RealD> num, den({in.light_mass});
+    for (auto h : in.hasenbusch) { num.push_back(h); den.push_back(h); }
+    num.push_back(in.pv_mass);
+
+    std::vector<FermionAction *> Ops;
+    std::vector<TwoFlavourEvenOddRatioPseudoFermionAction<FermionImplPolicy> *> Quotients;
+    ActionSet<Field, NoHirep> TheAction(in.multipliers.size());
+    for (int l = 0; l < TheAction.size(); l++) TheAction[l].multiplier = in.multipliers[l];
+    for (int q = 0; q < num.size(); q++) {
+      Ops.push_back(new FermionAction(U, *UGrid, *UrbGrid, num[q]));
+      Ops.push_back(new FermionAction(U, *UGrid, *UrbGrid, den[q]));
+      Quotients.push_back(new TwoFlavourEvenOddRatioPseudoFermionAction<FermionImplPolicy>(*Ops[2*q], *Ops[2*q+1], CG, CG));
+      TheAction[in.levels[q]].push_back(Quotients[q]);
+    }
+    TheAction.back().push_back(&Waction);
+
+    Smearing smear;
+    Omelyan MD(UGrid, inHMC.MD, TheAction, smear);
+    MD.refresh(U, sRNG, pRNG);
+    RealD H0 = MD.S(U);
+    MD.integrate(U);
+    RealD H1 = MD.S(U);
+    std::cout << GridLogMessage << "dH = " << H1 - H0 << std::endl;
+    assert(std::abs(H1 - H0) < 1.0);
+
+    for (auto q : Quotients) delete q;
+    for (auto o : Ops) delete o;
+  }
+
+  std::cout << GridLogMessage << "Hasenbusch planner test passed" << std::endl;
+  Grid_finalize();
+}
@@ -0,0 +1,193 @@
+/*************************************************************************************
+
+Grid physics library, www.github.com/paboyle/Grid
+
+Source file: ./tests/hmc/Test_hmc_tune_integrator.cc
+
+Copyright (C) 2015
+
+This program is free software; you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation; either version 2 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along
+with this program; if not, write to the Free Software Foundation, Inc.,
+51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+
+See the full license in the file "LICENSE" in the top level distribution
+directory
+*************************************************************************************/
+/*  END LEGAL */
+#include <Grid/Grid.h>
+
+using namespace Grid;
+
+int main(int argc, char **argv) {
+  Grid_init(&argc, &argv);
+
+  std::cout << GridLogMessage << "Tuner model" << std::endl;
+  {
+    // erfc(sqrt(<dH^2>/8)) inverts AcceptanceToVariance
+    for (RealD acc : {0.5, 0.8, 0.95}) {
+      RealD var = IntegratorTuner::AcceptanceToVariance(acc);
+      assert(std::abs(std::erfc(std::sqrt(var / 8.0)) - acc) < 1.0e-10);
+    }
+    // Single level: close to the minimum norm value; uncorrelated level: 1/6
+    assert(std::abs(IntegratorTuner::OptimalLambda(1.0) - 0.1910) < 1.0e-3);
+    assert(std::abs(IntegratorTuner::OptimalLambda(0.0) - 1.0 / 6.0) < 1.0e-12);
+    assert(IntegratorTuner::ErrorNorm(0.1931833275037836) < IntegratorTuner::ErrorNorm(0.5));
+  }
+
+  std::cout << GridLogMessage << "HMCparameters XML round trip" << std::endl;
+  {
+    HMCparameters par;
+    par.TuneTrajectories = 7;
+    par.TargetAcceptance = 0.85;
+    par.MD.lambda = std::vector<RealD>({0.19, 0.2});
+    std::string file = "hmc_tune." + std::to_string(CartesianCommunicator::RankWorld()) + ".xml";
+    {
+      XmlWriter WR(file);
+      write(WR, "HMC", par);
+    }
+    XmlReader RD(file);
+    HMCparameters in(RD);
+    assert(in.TuneTrajectories == 7);
+    assert(in.TargetAcceptance == 0.85);
+    assert(in.MD.lambda == par.MD.lambda);
+  }
+
+  std::cout << GridLogMessage << "HMCparameters from a file without the tuning members" << std::endl;
+  {
+    std::string old =
+      "<?xml version=\"1.0\"?>\n"
+      "<grid>\n"
+      "  <HMC>\n"
+      "    <StartTrajectory>3</StartTrajectory>\n"
+      "    <Trajectories>20</Trajectories>\n"
+      "    <MetropolisTest>true</MetropolisTest>\n"
+      "    <NoMetropolisUntil>5</NoMetropolisUntil>\n"
+      "    <StartingType>CheckpointStart</StartingType>\n"
+      "    <MD>\n"
+      "      <name>MinimumNorm2</name>\n"
+      "      <MDsteps>12</MDsteps>\n"
+      "      <trajL>1</trajL>\n"
+      "    </MD>\n"
+      "  </HMC>\n"
+      "</grid>\n";
+    XmlReader RD(old, true);
+    HMCparameters in(RD);
+    HMCparameters def;
+    assert(in.StartTrajectory == 3);
+    assert(in.Trajectories == 20);
+    assert(in.StartingType == "CheckpointStart");
+    assert(in.MD.MDsteps == 12);
+    assert(in.MD.lambda.empty());
+    assert(in.MD.multipliers.empty());
+    assert(in.TuneTrajectories == def.TuneTrajectories);
+    assert(in.TargetAcceptance == def.TargetAcceptance);
+    assert(in.TunedParameterFile == def.TunedParameterFile);
+  }
+  {
+    std::string file = "hmc_old." + std::to_string(CartesianCommunicator::RankWorld()) + ".json";
+    {
+      std::ofstream f(file);
+      f << "{ \"HMC\": { \"StartTrajectory\": 3, \"Trajectories\": 20, \"MetropolisTest\": true,"
+        << " \"NoMetropolisUntil\": 5, \"StartingType\": \"HotStart\","
+        << " \"MD\": { \"name\": \"MinimumNorm2\", \"MDsteps\": 12, \"trajL\": 1.0 } } }" << std::endl;
+    }
+    JSONReader RD(file);
+    HMCparameters in(RD);
+    HMCparameters def;
+    assert(in.Trajectories == 20);
+    assert(in.MD.MDsteps == 12);
+    assert(in.MD.multipliers.empty());
+    assert(in.TuneTrajectories == def.TuneTrajectories);
+    assert(in.TargetAcceptance == def.TargetAcceptance);
+  }
+
+  typedef PeriodicGimplR Gimpl;
+  typedef NoSmearing<Gimpl> Smearing;
+  typedef MinimumNorm2<Gimpl, Smearing> Omelyan;
+  typedef Gimpl::Field Field;
+  typedef WilsonImplR FermionImplPolicy;
+  typedef WilsonFermionR FermionAction;
+  typedef typename FermionAction::FermionField FermionField;
+
+  GridCartesian         *UGrid   = SpaceTimeGrid::makeFourDimGrid(GridDefaultLatt(), GridDefaultSimd(Nd, vComplex::Nsimd()), GridDefaultMpi());
+  GridRedBlackCartesian *UrbGrid = SpaceTimeGrid::makeFourDimRedBlackGrid(UGrid);
+
+  GridSerialRNG   sRNG; sRNG.SeedFixedIntegers(std::vector<int>({1, 2, 3, 4}));
+  GridParallelRNG pRNG(UGrid); pRNG.SeedFixedIntegers(std::vector<int>({5, 6, 7, 8}));
+
+  Field U(UGrid);
+  SU<Nc>::ColdConfiguration(pRNG, U);
+
+  // Hasenbusch pair on the outer level, gauge action inside
+  WilsonGaugeActionR Waction(5.6);
+  FermionAction DenOp(U, *UGrid, *UrbGrid, 0.1);
+  FermionAction NumOp(U, *UGrid, *UrbGrid, 0.5);
+  ConjugateGradient<FermionField> CG(1.0e-10, 2000);
+  TwoFlavourEvenOddRatioPseudoFermionAction<FermionImplPolicy> Nf2(NumOp, DenOp, CG, CG);
+
+  ActionSet<Field, NoHirep> TheAction(2);
+  TheAction[0].push_back(&Nf2);
+  TheAction[1].multiplier = 2;
+  TheAction[1].push_back(&Waction);
+
+  Smearing smear;
+  HMCparameters par;
+  par.StartTrajectory   = 0;
+  par.NoMetropolisUntil = 2;
+  par.TuneTrajectories  = 4;
+  par.Trajectories      = 2;
+  par.TargetAcceptance  = 0.9;
+  par.TunedParameterFile= "hmc_tune_resume.xml";
+  par.MD                = IntegratorParameters(3, 1.0);
+
+  Omelyan MD(UGrid, par.MD, TheAction, smear);
+  std::vector<HmcObservable<Field> *> obs;
+  HybridMonteCarlo<Omelyan> HMC(par, MD, sRNG, pRNG, obs, U);
+  HMC.evolve();
+
+  const IntegratorParameters &tuned = MD.getParameters();
+  std::cout << GridLogMessage << "Tuned: MDsteps " << tuned.MDsteps << " inner multiplier " << MD.getMultiplier(1)
+	    << " lambda " << tuned.lambda << std::endl;
+  assert(tuned.MDsteps >= 1);
+  assert(tuned.lambda.size() == 2);
+  for (auto l : tuned.lambda) assert(l >= 1.0 / 6.0 && l <= 0.25);
+
+  // The cheapest outer step count meeting the target with the chosen multipliers
+  RealD acc = MD.PredictedAcceptance(tuned.MDsteps);
+  std::cout << GridLogMessage << "Predicted acceptance " << acc << std::endl;
+  assert(acc >= par.TargetAcceptance);
+  if (tuned.MDsteps > 1) assert(MD.PredictedAcceptance(tuned.MDsteps - 1) < par.TargetAcceptance);
+
+  std::cout << GridLogMessage << "Resuming from the tuned parameter file" << std::endl;
+  {
+    XmlReader RD(par.TunedParameterFile);
+    HMCparameters in(RD);
+    assert(in.StartingType == "CheckpointStart");
+    assert(in.StartTrajectory == par.StartTrajectory + par.NoMetropolisUntil + par.TuneTrajectories);
+    assert(in.TuneTrajectories == 0);
+    assert(in.MD.MDsteps == tuned.MDsteps);
+    assert(in.MD.multipliers.size() == 2);
+    assert(in.MD.lambda.size() == 2);
+    for (int l = 0; l < 2; l++) assert(std::abs(in.MD.lambda[l] - tuned.lambda[l]) < 1.0e-6);
+
+    // The file's multipliers replace those of the action set
+    Omelyan Resumed(UGrid, in.MD, TheAction, smear);
+    for (int l = 0; l < 2; l++) {
+      assert(in.MD.multipliers[l] == MD.getMultiplier(l));
+      assert(Resumed.getMultiplier(l) == MD.getMultiplier(l));
+    }
+  }
+
+  std::cout << GridLogMessage << "Integrator tuning test passed" << std::endl;
+  Grid_finalize();
+}
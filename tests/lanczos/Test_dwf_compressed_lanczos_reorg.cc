@@ -39,6 +39,45 @@ using namespace Grid;
 
 #ifdef HAVE_LIME
 
+// Store a vector set in the compressed format with each codec and report
+// ratio, throughput and the worst relative error over the set.
+template<class Field>
+void compressedCheckpoint(std::vector<Field> &evecs,int n,std::string stem)
+{
+  const char *name[] = {"lossless","fp16","bfloat16"};
+  std::vector<const Field *> out;
+  for(int k=0;k<n;k++) out.push_back(&evecs[k]);
+
+  for(int codec=CompressedIOParams::Lossless;codec<=CompressedIOParams::BFloat16;codec++){
+    std::string file = stem+"."+name[codec];
+    CompressedIOParams params;
+    params.codec       = codec;
+    params.chunkSlices = 2;
+    CompressedIO::writeFields(out,file,params);
+    double ratio = CompressedIO::lastRatio;
+    double wr    = CompressedIO::lastPerf.mbytesPerSecond;
+
+    std::vector<Field> back(n,evecs[0].Grid());
+    std::vector<Field *> in;
+    for(int k=0;k<n;k++) in.push_back(&back[k]);
+    CompressedIO::readFields(in,file);
+    double rd    = CompressedIO::lastPerf.mbytesPerSecond;
+
+    RealD err=0.0;
+    Field diff(evecs[0].Grid());
+    for(int k=0;k<n;k++){
+      assert(back[k].Checkerboard()==evecs[k].Checkerboard());
+      diff = back[k]-evecs[k];
+      err  = std::max(err,std::sqrt(norm2(diff)/norm2(evecs[k])));
+    }
+    std::cout << GridLogIRL << "Compressed "<<stem<<" "<<name[codec]<<" : ratio "<<ratio
+	      <<" write "<<wr<<" MB/s read "<<rd<<" MB/s max relative error "<<err<<std::endl;
+    if ( codec==CompressedIOParams::Lossless ) assert(err==0.0);
+    if ( codec==CompressedIOParams::Half     ) assert(err<1.0e-3);
+    if ( codec==CompressedIOParams::BFloat16 ) assert(err<1.0e-2);
+  }
+}
+
 template<class Fobj,class CComplex,int nbasis>
 class LocalCoherenceLanczosScidac : public LocalCoherenceLanczos<Fobj,CComplex,nbasis>
 { 
@@ -70,6 +109,11 @@ public:
     write(WRx,"evals",this->evals_fine);
   }
 
+  void checkpointFineCompressed(std::string stem)
+  {
+    compressedCheckpoint(this->subspace,nbasis,stem);
+  }
+
   void checkpointFineRestore(std::string evecs_file,std::string evals_file)
   {
     this->evals_fine.resize(nbasis);
@@ -107,6 +151,11 @@ public:
     write(WRx,"evals",this->evals_coarse);
   }
 
+  void checkpointCoarseCompressed(std::string stem)
+  {
+    compressedCheckpoint(this->evec_coarse,this->evec_coarse.size(),stem);
+  }
+
   void checkpointCoarseRestore(std::string evecs_file,std::string evals_file,int nvec)
   {
     std::cout << "resizing coarse vecs to " << nvec<< std::endl;
@@ -219,6 +268,7 @@ int main (int argc, char ** argv) {
 
     std::cout << GridLogIRL<<"Checkpointing Fine evecs"<<std::endl;
     _LocalCoherenceLanczos.checkpointFine(std::string("evecs.scidac"),std::string("evals.xml"));
+    _LocalCoherenceLanczos.checkpointFineCompressed(std::string("evecs.compressed"));
     _LocalCoherenceLanczos.testFine(fine.resid*100.0); // Coarse check
     std::cout << GridLogIRL<<"Orthogonalising"<<std::endl;
     _LocalCoherenceLanczos.Orthogonalise();
@@ -241,6 +291,7 @@ int main (int argc, char ** argv) {
 
     std::cout << GridLogIRL<<"Checkpointing coarse evecs"<<std::endl;
     _LocalCoherenceLanczos.checkpointCoarse(std::string("evecs.coarse.scidac"),std::string("evals.coarse.xml"));
+    _LocalCoherenceLanczos.checkpointCoarseCompressed(std::string("evecs.coarse.compressed"));
   }
 
   if ( Params.doCoarseRead ) {
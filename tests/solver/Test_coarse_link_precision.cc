@@ -0,0 +1,146 @@
+/*************************************************************************************
+
+    Grid physics library, www.github.com/paboyle/Grid
+
+    Source file: ./tests/solver/Test_coarse_link_precision.cc
+
+    Copyright (C) 2015-2020
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License along
+    with this program; if not, write to the Free Software Foundation, Inc.,
+    51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+
+    See the full license in the file "LICENSE" in the top level distribution directory
+*************************************************************************************/
+/*  END LEGAL */
+#include <Grid/Grid.h>
+
+using namespace Grid;
+
+#ifndef NBASIS
+#define NBASIS 32
+#endif
+
+template<class Field> RealD relativeDeviation(const Field &ref,const Field &res)
+{
+  Field diff(ref.Grid());
+  diff = ref - res;
+  return std::sqrt(norm2(diff)/norm2(ref));
+}
+
+int main(int argc, char** argv) {
+  Grid_init(&argc, &argv);
+
+  const int nbasis = NBASIS;
+
+  GridCartesian*         Grid_c   = SpaceTimeGrid::makeFourDimGrid(GridDefaultLatt(), GridDefaultSimd(Nd, vComplex::Nsimd()), GridDefaultMpi());
+  GridRedBlackCartesian* RBGrid_c = SpaceTimeGrid::makeFourDimRedBlackGrid(Grid_c);
+
+  GridParallelRNG pRNG_c(Grid_c);
+  pRNG_c.SeedFixedIntegers(std::vector<int>({1, 2, 3, 4}));
+
+  typedef CoarsenedMatrix<vSpinColourVector, vTComplex, nbasis> CoarseDiracMatrix;
+  typedef CoarseDiracMatrix::CoarseVector                       CoarseVector;
+
+  /////////////////////////////////////////////////////////////////////////////
+  // Random non-hermitian links are enough to exercise every stencil kernel
+  /////////////////////////////////////////////////////////////////////////////
+  CoarseDiracMatrix Dc(*Grid_c, *RBGrid_c, 0);
+  for(auto &a : Dc.A) gaussian(pRNG_c, a);
+  Dc.InvertSelfStencilLink();
+  Dc.FillHalfCbs();
+
+  CoarseVector src(Grid_c);   random(pRNG_c, src);
+  CoarseVector src_e(RBGrid_c); pickCheckerboard(Even, src_e, src);
+  CoarseVector src_o(RBGrid_c); pickCheckerboard(Odd,  src_o, src);
+
+  std::vector<CoarseVector> dirs(Dc.geom.npoint - 1, Grid_c);
+  auto apply = [&](std::vector<CoarseVector> &out, std::vector<CoarseVector> &out_cb) {
+    Dc.M(src, out[0]);
+    Dc.Mdag(src, out[1]);
+    Dc.Mdir(src, out[2], 1, +1);
+    Dc.Dhop(src, out[3], DaggerYes);
+    Dc.Mdiag(src, out[4]);
+    Dc.MdirAll(src, dirs);
+    out[5] = dirs[0];
+    for(int p = 1; p < dirs.size(); p++) out[5] = out[5] + dirs[p];
+    Dc.Meooe(src_e, out_cb[0]);
+    Dc.MeooeDag(src_o, out_cb[1]);
+  };
+  const int   nop     = 6;
+  const char *name[]    = {"M", "Mdag", "Mdir", "DhopDag", "Mdiag", "MdirAll"};
+  const char *name_cb[] = {"Meooe", "MeooeDag"};
+
+  std::vector<CoarseVector> ref(nop, Grid_c), res(nop, Grid_c);
+  std::vector<CoarseVector> ref_cb(2, RBGrid_c), res_cb(2, RBGrid_c);
+  apply(ref, ref_cb);
+
+  int   ncall = 10;
+  RealD nbytes = 1.0 * Grid_c->gSites() * Dc.geom.npoint * nbasis * nbasis * sizeof(typename vTComplex::scalar_type);
+  const char *precName[] = {"full", "single", "half"};
+  RealD       precTol[]  = {0.0, 1.0e-6, 2.0e-3};
+
+  for(int prec = CoarseDiracMatrix::LinksFull; prec <= CoarseDiracMatrix::LinksHalf; prec++) {
+    std::cout << GridLogMessage << "===========================================================================" << std::endl;
+    std::cout << GridLogMessage << "= Coarse links held in " << precName[prec] << " precision" << std::endl;
+    std::cout << GridLogMessage << "===========================================================================" << std::endl;
+
+    // The full precision hopping links are released once compressed, so storage shrinks;
+    // lattices live in the cpu pool and the compressed links (Vector) in the shared pool
+    auto live = []() {
+      return MemoryManager::PoolStatistics(MemoryManager::PoolCpu).requestedBytes
+	   + MemoryManager::PoolStatistics(MemoryManager::PoolShared).requestedBytes;
+    };
+    int64_t live0 = live();
+    Dc.SetLinkPrecision(prec);
+    int64_t live1 = live();
+    std::cout << GridLogMessage << "Link storage changed by " << live1 - live0 << " bytes" << std::endl;
+    if(Dc.LinkPrecision() != CoarseDiracMatrix::LinksFull) assert(live1 < live0);
+    apply(res, res_cb);
+
+    RealD tol = (getPrecision<CoarseVector>::value == 1) ? std::max(precTol[prec], 1.0e-6) : precTol[prec];
+    if(Dc.LinkPrecision() == CoarseDiracMatrix::LinksFull) tol = 0.0;
+    for(int n = 0; n < nop; n++) {
+      RealD dev = relativeDeviation(ref[n], res[n]);
+      std::cout << GridLogMessage << name[n] << " relative deviation " << dev << std::endl;
+      assert(dev <= tol);
+    }
+    for(int n = 0; n < 2; n++) {
+      RealD dev = relativeDeviation(ref_cb[n], res_cb[n]);
+      std::cout << GridLogMessage << name_cb[n] << " relative deviation " << dev << std::endl;
+      assert(dev <= tol);
+      assert(res_cb[n].Checkerboard() == ref_cb[n].Checkerboard());
+    }
+
+    GridStopWatch timer;
+    timer.Start();
+    for(int i = 0; i < ncall; i++) Dc.M(src, res[0]);
+    timer.Stop();
+    RealD usec = timer.useconds() / ncall;
+    std::cout << GridLogMessage << "M with " << precName[prec] << " links: " << usec << " us per call, "
+              << nbytes / usec / Dc.Grid()->_Nprocessors << " MB/s per rank of full precision link traffic" << std::endl;
+  }
+
+  // Back to full precision: the links are expanded from the compressed copy and keep its rounding
+  int lowest = Dc.LinkPrecision();
+  Dc.SetLinkPrecision(CoarseDiracMatrix::LinksFull);
+  apply(res, res_cb);
+  RealD tol = (getPrecision<CoarseVector>::value == 1) ? std::max(precTol[lowest], 1.0e-6) : precTol[lowest];
+  for(int n = 0; n < nop; n++) {
+    RealD dev = relativeDeviation(ref[n], res[n]);
+    std::cout << GridLogMessage << name[n] << " relative deviation after expansion " << dev << std::endl;
+    assert(dev <= tol);
+  }
+
+  Grid_finalize();
+}
@@ -0,0 +1,171 @@
+/*************************************************************************************
+
+    Grid physics library, www.github.com/paboyle/Grid
+
+    Source file: ./tests/solver/Test_coarsen_probing.cc
+
+    Copyright (C) 2015-2020
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License along
+    with this program; if not, write to the Free Software Foundation, Inc.,
+    51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+
+    See the full license in the file "LICENSE" in the top level distribution directory
+*************************************************************************************/
+/*  END LEGAL */
+#include <Grid/Grid.h>
+
+using namespace Grid;
+
+#ifndef NBASIS
+#define NBASIS 16
+#endif
+
+template<class Field> RealD relativeDeviation(const Field &ref,const Field &res)
+{
+  Field diff(ref.Grid());
+  diff = ref - res;
+  return std::sqrt(norm2(diff)/norm2(ref));
+}
+
+int main(int argc, char** argv) {
+  Grid_init(&argc, &argv);
+
+  const int nbasis = NBASIS;
+
+  Coordinate clatt = GridDefaultLatt();
+  for(int d=0; d<clatt.size(); d++) clatt[d] = clatt[d] / 2;
+
+  GridCartesian*         Grid_f   = SpaceTimeGrid::makeFourDimGrid(GridDefaultLatt(), GridDefaultSimd(Nd, vComplex::Nsimd()), GridDefaultMpi());
+  GridCartesian*         Grid_c   = SpaceTimeGrid::makeFourDimGrid(clatt, GridDefaultSimd(Nd, vComplex::Nsimd()), GridDefaultMpi());
+  GridRedBlackCartesian* RBGrid_f = SpaceTimeGrid::makeFourDimRedBlackGrid(Grid_f);
+  GridRedBlackCartesian* RBGrid_c = SpaceTimeGrid::makeFourDimRedBlackGrid(Grid_c);
+
+  GridParallelRNG pRNG_f(Grid_f); pRNG_f.SeedFixedIntegers(std::vector<int>({1, 2, 3, 4}));
+  GridParallelRNG pRNG_c(Grid_c); pRNG_c.SeedFixedIntegers(std::vector<int>({5, 6, 7, 8}));
+
+  LatticeGaugeField Umu(Grid_f);
+  SU<Nc>::HotConfiguration(pRNG_f, Umu);
+
+  RealD mass = -0.30;
+  RealD csw  = 1.9192;
+  RealD tol  = (getPrecision<LatticeFermion>::value == 1) ? 1e-5 : 1e-10;
+
+  WilsonCloverFermionR Dwc(Umu, *Grid_f, *RBGrid_f, mass, csw, csw);
+  MdagMLinearOperator<WilsonCloverFermionR, LatticeFermion> MdagMOp_Dwc(Dwc);
+
+  typedef Aggregation<vSpinColourVector, vTComplex, nbasis>     Aggregates;
+  typedef CoarsenedMatrix<vSpinColourVector, vTComplex, nbasis> CoarseDiracMatrix;
+  typedef CoarseDiracMatrix::CoarseVector                       CoarseVector;
+
+  Aggregates Aggs(Grid_c, Grid_f, 0);
+  for(int n = 0; n < nbasis; n++) gaussian(pRNG_f, Aggs.subspace[n]);
+
+  CoarseVector src(Grid_c); random(pRNG_c, src);
+  CoarseVector ref(Grid_c), res(Grid_c);
+
+  /////////////////////////////////////////////////////////////////////////////
+  // Probing and masked coarsening agree link by link
+  /////////////////////////////////////////////////////////////////////////////
+  GridStopWatch maskedTimer, probingTimer, updateTimer;
+
+  CoarseDiracMatrix Dm(*Grid_c, *RBGrid_c, 0);
+  maskedTimer.Start();
+  Dm.CoarsenOperator(Grid_f, MdagMOp_Dwc, Aggs);
+  maskedTimer.Stop();
+
+  CoarseDiracMatrix Dp(*Grid_c, *RBGrid_c, 0);
+  Dp.coarsenMethod = CoarseDiracMatrix::CoarsenProbing;
+  assert(Dp.ProbingPossible());
+  probingTimer.Start();
+  Dp.UpdateOperator(Grid_f, MdagMOp_Dwc, Aggs);
+  probingTimer.Stop();
+
+  for(int p = 0; p < Dm.geom.npoint; p++) {
+    RealD dev = relativeDeviation(Dm.A[p], Dp.A[p]);
+    std::cout << GridLogMessage << "Stencil point " << p << ": probing vs masked relative deviation " << dev << std::endl;
+    assert(dev < tol);
+  }
+
+  /////////////////////////////////////////////////////////////////////////////
+  // Galerkin check against the fine operator: R D P src = D_c src
+  /////////////////////////////////////////////////////////////////////////////
+  {
+    LatticeFermion fine(Grid_f), Dfine(Grid_f);
+    Aggs.PromoteFromSubspace(src, fine);
+    MdagMOp_Dwc.Op(fine, Dfine);
+    Aggs.ProjectToSubspace(ref, Dfine);
+    Dp.M(src, res);
+    RealD dev = relativeDeviation(ref, res);
+    std::cout << GridLogMessage << "R D P - D_c (probing) relative deviation " << dev << std::endl;
+    assert(dev < tol);
+  }
+
+  // Redundant copies of Dp on as few ranks as possible, checked after the update below
+  CoarseAgglomeration<CoarseDiracMatrix> Agglomerate(Dp, Grid_c->gSites());
+
+  /////////////////////////////////////////////////////////////////////////////
+  // Update path: a perturbed gauge field recoarsened on the existing subspace
+  // matches a full coarsening; a small non-unitary perturbation suffices here
+  /////////////////////////////////////////////////////////////////////////////
+  {
+    LatticeGaugeField dU(Grid_f); gaussian(pRNG_f, dU);
+    LatticeGaugeField Umu2(Grid_f); Umu2 = Umu + 0.01 * dU;
+    WilsonCloverFermionR Dwc2(Umu2, *Grid_f, *RBGrid_f, mass, csw, csw);
+    MdagMLinearOperator<WilsonCloverFermionR, LatticeFermion> MdagMOp_Dwc2(Dwc2);
+
+    updateTimer.Start();
+    Dm.UpdateOperator(Grid_f, MdagMOp_Dwc2, Aggs);
+    updateTimer.Stop();
+
+    CoarseDiracMatrix Dfull(*Grid_c, *RBGrid_c, 0);
+    Dfull.CoarsenOperator(Grid_f, MdagMOp_Dwc2, Aggs);
+
+    Dfull.M(src, ref);    Dm.M(src, res);
+    RealD devM = relativeDeviation(ref, res);
+    Dfull.Mdag(src, ref); Dm.Mdag(src, res);
+    RealD devMdag = relativeDeviation(ref, res);
+    std::cout << GridLogMessage << "Update vs full coarsening: M " << devM << " Mdag " << devMdag << std::endl;
+    assert(devM < tol);
+    assert(devMdag < tol);
+
+    // Refreshed subspace, recoarsened with probing
+    Aggs.RefreshSubspace(MdagMOp_Dwc2, 4);
+    Dp.UpdateOperator(Grid_f, MdagMOp_Dwc2, Aggs);
+
+    LatticeFermion fine(Grid_f), Dfine(Grid_f);
+    Aggs.PromoteFromSubspace(src, fine);
+    MdagMOp_Dwc2.Op(fine, Dfine);
+    Aggs.ProjectToSubspace(ref, Dfine);
+    Dp.M(src, res);
+    RealD dev = relativeDeviation(ref, res);
+    std::cout << GridLogMessage << "R D P - D_c after refresh relative deviation " << dev << std::endl;
+    assert(dev < tol);
+
+    // The agglomerated copies follow the update once refreshed
+    Agglomerate.Refresh();
+    CoarseVector s_src(Agglomerate.Grid()), s_res(Agglomerate.Grid());
+    Agglomerate.Replicate(src, s_src);
+    Agglomerate.Operator().M(s_src, s_res);
+    Agglomerate.Gather(s_res, ref);
+    dev = relativeDeviation(ref, res);
+    std::cout << GridLogMessage << Agglomerate.Copies() << " agglomerated copies after update relative deviation " << dev << std::endl;
+    assert(dev < tol);
+  }
+
+  std::cout << GridLogMessage << "Coarsening times: masked (with orthogonalisation) " << maskedTimer.Elapsed()
+	    << " probing " << probingTimer.Elapsed() << " masked update " << updateTimer.Elapsed() << std::endl;
+
+  std::cout << GridLogMessage << "Coarsen probing test passed" << std::endl;
+  Grid_finalize();
+}
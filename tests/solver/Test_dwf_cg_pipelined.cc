@@ -0,0 +1,103 @@
+    /*************************************************************************************
+
+    Grid physics library, www.github.com/paboyle/Grid
+
+    Source file: ./tests/solver/Test_dwf_cg_pipelined.cc
+
+    Copyright (C) 2015
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License along
+    with this program; if not, write to the Free Software Foundation, Inc.,
+    51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+
+    See the full license in the file "LICENSE" in the top level distribution directory
+    *************************************************************************************/
+    /*  END LEGAL */
+#include <Grid/Grid.h>
+
+using namespace std;
+using namespace Grid;
+
+int main(int argc, char** argv) {
+  Grid_init(&argc, &argv);
+
+  const int Ls = 8;
+
+  GridCartesian* UGrid = SpaceTimeGrid::makeFourDimGrid(GridDefaultLatt(), GridDefaultSimd(Nd, vComplex::Nsimd()),GridDefaultMpi());
+  GridRedBlackCartesian* UrbGrid = SpaceTimeGrid::makeFourDimRedBlackGrid(UGrid);
+  GridCartesian* FGrid = SpaceTimeGrid::makeFiveDimGrid(Ls, UGrid);
+  GridRedBlackCartesian* FrbGrid = SpaceTimeGrid::makeFiveDimRedBlackGrid(Ls, UGrid);
+
+  std::vector<int> seeds4({1, 2, 3, 4});
+  std::vector<int> seeds5({5, 6, 7, 8});
+  GridParallelRNG RNG5(FGrid);  RNG5.SeedFixedIntegers(seeds5);
+  GridParallelRNG RNG4(UGrid);  RNG4.SeedFixedIntegers(seeds4);
+
+  LatticeFermion src(FGrid); random(RNG5, src);
+  LatticeGaugeField Umu(UGrid); SU<Nc>::HotConfiguration(RNG4, Umu);
+
+  RealD mass = 0.1;
+  RealD M5 = 1.8;
+  DomainWallFermionR Ddwf(Umu, *FGrid, *FrbGrid, *UGrid, *UrbGrid, mass, M5);
+
+  LatticeFermion src_o(FrbGrid);
+  pickCheckerboard(Odd, src_o, src);
+
+  SchurDiagMooeeOperator<DomainWallFermionR, LatticeFermion> HermOpEO(Ddwf);
+
+  RealD tol = 1.0e-8;
+  ConjugateGradient<LatticeFermion>          CG (tol, 10000);
+  ConjugateGradientPipelined<LatticeFermion> PCG(tol, 10000, true, CGPipelined);
+  ConjugateGradientPipelined<LatticeFermion> CGCG(tol, 10000, true, CGChronopoulosGear);
+
+  LatticeFermion ref(FrbGrid);    ref = Zero();
+  LatticeFermion result(FrbGrid);
+  LatticeFermion diff(FrbGrid);
+
+  CG(HermOpEO, src_o, ref);
+
+  std::cout << GridLogMessage << "############ Pipelined CG" << std::endl;
+  result = Zero();
+  PCG(HermOpEO, src_o, result);
+  diff = ref - result;
+  std::cout << GridLogMessage << "CG iterations " << CG.IterationsToComplete
+	    << " pipelined iterations " << PCG.IterationsToComplete
+	    << " relative difference " << std::sqrt(norm2(diff)/norm2(ref)) << std::endl;
+  assert(PCG.TrueResidual < 10*tol);
+  assert(std::abs((int)PCG.IterationsToComplete - (int)CG.IterationsToComplete) <= CG.IterationsToComplete/10+2);
+
+  std::cout << GridLogMessage << "############ Chronopoulos-Gear CG" << std::endl;
+  result = Zero();
+  CGCG(HermOpEO, src_o, result);
+  diff = ref - result;
+  std::cout << GridLogMessage << "CG iterations " << CG.IterationsToComplete
+	    << " Chronopoulos-Gear iterations " << CGCG.IterationsToComplete
+	    << " relative difference " << std::sqrt(norm2(diff)/norm2(ref)) << std::endl;
+  assert(CGCG.TrueResidual < 10*tol);
+  assert(std::abs((int)CGCG.IterationsToComplete - (int)CG.IterationsToComplete) <= CG.IterationsToComplete/10+2);
+
+  std::cout << GridLogMessage << "############ Schur solve with pipelined CG" << std::endl;
+  {
+    LatticeFermion sol(FGrid); sol = Zero();
+    SchurRedBlackDiagMooeeSolve<LatticeFermion> SchurSolver(PCG);
+    SchurSolver(Ddwf, src, sol);
+    LatticeFermion tmp(FGrid);
+    Ddwf.M(sol, tmp);
+    tmp = tmp - src;
+    RealD res = std::sqrt(norm2(tmp)/norm2(src));
+    std::cout << GridLogMessage << "Schur pipelined CG unpreconditioned residual " << res << std::endl;
+    assert(res < 1.0e-6);
+  }
+
+  Grid_finalize();
+}
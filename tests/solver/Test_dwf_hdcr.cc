@@ -344,15 +344,31 @@ int main (int argc, char ** argv)
   CoarseCoarseVector cc_src(CoarseCoarse5d); cc_src=1.0;
   IRLL2.calc(eval2,evec2,cc_src,cNconv);
 
+  ///////////////////////////////////////////////////////////////////
+  // --agglomerate N : solve the bottom level redundantly on subgrids
+  // holding at least N coarse-coarse sites per rank
+  ///////////////////////////////////////////////////////////////////
+  int agglomerate=0;
+  if( GridCmdOptionExists(argv,argv+argc,"--agglomerate") ){
+    std::string arg = GridCmdOptionPayload(argv,argv+argc,"--agglomerate");
+    GridCmdOptionInt(arg,agglomerate);
+  }
+  CoarseAgglomeration<Level2Op> L2Agglomerate(L2Op,agglomerate);
+  std::vector<CoarseCoarseVector> evec2s(cNm,L2Agglomerate.Grid());
+  for(int n=0;n<cNm;n++) L2Agglomerate.Replicate(evec2[n],evec2s[n]);
+
   ConjugateGradient<CoarseCoarseVector>  CoarseCoarseCG(0.1,1000);
   DeflatedGuesser<CoarseCoarseVector> DeflCoarseCoarseGuesser(evec2,eval2);
-  NormalEquations<CoarseCoarseVector> DeflCoarseCoarseCGNE(L2Op,CoarseCoarseCG,DeflCoarseCoarseGuesser);
+  DeflatedGuesser<CoarseCoarseVector> DeflCoarseCoarseGuesserS(evec2s,eval2);
+  NormalEquations<CoarseCoarseVector> DeflCoarseCoarseCGNE(L2Agglomerate.Operator(),CoarseCoarseCG,DeflCoarseCoarseGuesserS);
+  typedef AgglomeratedCoarseSolve<Level2Op,NormalEquations<CoarseCoarseVector> > CoarseCoarseSolve;
+  CoarseCoarseSolve DeflCoarseCoarseSolve(L2Agglomerate,DeflCoarseCoarseCGNE);
 
   std::cout<<GridLogMessage << "**************************************************"<< std::endl;
   std::cout<<GridLogMessage << "Building 3 level Multigrid            "<< std::endl;
   std::cout<<GridLogMessage << "**************************************************"<< std::endl;
   typedef MultiGridPreconditioner<vSpinColourVector,  vTComplex,nbasis, DomainWallFermionR,DeflatedGuesser<CoarseVector> , NormalEquations<CoarseVector> >   TwoLevelMG;
-  typedef MultiGridPreconditioner<siteVector,iScalar<vTComplex>,nbasisc,Level1Op, DeflatedGuesser<CoarseCoarseVector>, NormalEquations<CoarseCoarseVector> > CoarseMG;
+  typedef MultiGridPreconditioner<siteVector,iScalar<vTComplex>,nbasisc,Level1Op, DeflatedGuesser<CoarseCoarseVector>, CoarseCoarseSolve > CoarseMG;
   typedef MultiGridPreconditioner<vSpinColourVector,  vTComplex,nbasis, DomainWallFermionR,ZeroGuesser<CoarseVector>, LinearFunction<CoarseVector> >     ThreeLevelMG;
 
   // MultiGrid preconditioner acting on the coarse space <-> coarsecoarse space
@@ -366,7 +382,7 @@ int main (int argc, char ** argv)
 			 L1LinOp,LDOp,
 			 CoarseSmoother,
 			 DeflCoarseCoarseGuesser,
-			 DeflCoarseCoarseCGNE);
+			 DeflCoarseCoarseSolve);
   Level2Precon.Level(2);
 
   // PGCR Applying this solver to solve the coarse space problem
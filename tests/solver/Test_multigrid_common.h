@@ -51,7 +51,9 @@ public:
                                   std::vector<int>,              kCycleMaxInnerIter,   // size == nLevels - 1
                                   double,                        coarseSolverTol,
                                   int,                           coarseSolverMaxOuterIter,
-                                  int,                           coarseSolverMaxInnerIter);
+                                  int,                           coarseSolverMaxInnerIter,
+                                  int,                           coarseAgglomerateSites, // 0 == never agglomerate
+                                  int,                           coarseLinkPrecision);   // 0 == full, 1 == single, 2 == half
 
   // constructor with default values
   MultiGridParams(int                           _nLevels                  = 2,
@@ -65,7 +67,9 @@ public:
                   std::vector<int>              _kCycleMaxInnerIter       = {5},
                   double                        _coarseSolverTol          = 5e-2,
                   int                           _coarseSolverMaxOuterIter = 10,
-                  int                           _coarseSolverMaxInnerIter = 500)
+                  int                           _coarseSolverMaxInnerIter = 500,
+                  int                           _coarseAgglomerateSites   = 0,
+                  int                           _coarseLinkPrecision      = 0)
   : nLevels(_nLevels)
   , blockSizes(_blockSizes)
   , smootherTol(_smootherTol)
@@ -78,6 +82,8 @@ public:
   , coarseSolverTol(_coarseSolverTol)
   , coarseSolverMaxOuterIter(_coarseSolverMaxOuterIter)
   , coarseSolverMaxInnerIter(_coarseSolverMaxInnerIter)
+  , coarseAgglomerateSites(_coarseAgglomerateSites)
+  , coarseLinkPrecision(_coarseLinkPrecision)
   {}
 };
 // clang-format on
@@ -246,6 +252,7 @@ public:
 
     _SetupCoarsenOperatorTimer.Start();
     _CoarseMatrix.CoarsenOperator(_LevelInfo.Grids[_CurrentLevel], fineMdagMOp, _Aggregates);
+    _CoarseMatrix.SetLinkPrecision(_MultiGridParams.coarseLinkPrecision);
     _SetupCoarsenOperatorTimer.Stop();
 
     _SetupNextLevelTimer.Start();
@@ -495,11 +502,16 @@ public:
     std::cout << GridLogMG << " Level " << _CurrentLevel << ": norm2(R D P v_c) = " << norm2(coarseTmps[1])
               << " | norm2(D_c v_c) = " << norm2(coarseTmps[2]) << " | relative deviation = " << deviation;
 
-    if(deviation > tolerance) {
-      std::cout << " > " << tolerance << " -> check failed" << std::endl;
+    // D_c is applied with its links rounded to the storage precision
+    RealD linkTolerance = tolerance;
+    if(_CoarseMatrix.LinkPrecision() == CoarseDiracMatrix::LinksSingle) linkTolerance = std::max(tolerance, 1e-6);
+    if(_CoarseMatrix.LinkPrecision() == CoarseDiracMatrix::LinksHalf)   linkTolerance = std::max(tolerance, 1e-2);
+
+    if(deviation > linkTolerance) {
+      std::cout << " > " << linkTolerance << " -> check failed" << std::endl;
       abort();
     } else {
-      std::cout << " < " << tolerance << " -> check passed" << std::endl;
+      std::cout << " < " << linkTolerance << " -> check passed" << std::endl;
     }
 
     std::cout << GridLogMG << " Level " << _CurrentLevel << ": **************************************************" << std::endl;
@@ -587,6 +599,8 @@ public:
   FineDiracMatrix &_FineMatrix;
   FineDiracMatrix &_SmootherMatrix;
 
+  std::unique_ptr<CoarseAgglomeration<FineDiracMatrix>> _Agglomeration;
+
   GridStopWatch _SolveTotalTimer;
   GridStopWatch _SolveSmootherTimer;
 
@@ -604,7 +618,9 @@ public:
     resetTimers();
   }
 
-  void setup() {}
+  void setup() {
+    _Agglomeration.reset(new CoarseAgglomeration<FineDiracMatrix>(_FineMatrix, _MultiGridParams.coarseAgglomerateSites));
+  }
 
   virtual void operator()(FineVector const &in, FineVector &out) {
 
@@ -620,10 +636,14 @@ public:
     FlexibleGeneralisedMinimalResidual<FineVector> fineFGMRES(
       _MultiGridParams.coarseSolverTol, coarseSolverMaxIter, fineTrivialPreconditioner, _MultiGridParams.coarseSolverMaxInnerIter, false);
 
-    MdagMLinearOperator<FineDiracMatrix, FineVector> fineMdagMOp(_FineMatrix);
+    // Runs on the agglomerated subgrids when the local volume is below threshold
+    MdagMLinearOperator<FineDiracMatrix, FineVector> fineMdagMOp(_Agglomeration->Operator());
+
+    auto fineSolve = [&](FineVector const &src, FineVector &sol) { fineFGMRES(fineMdagMOp, src, sol); };
+    AgglomeratedCoarseSolve<FineDiracMatrix, decltype(fineSolve)> agglomeratedSolve(*_Agglomeration, fineSolve);
 
     _SolveSmootherTimer.Start();
-    fineFGMRES(fineMdagMOp, in, out);
+    agglomeratedSolve(in, out);
     _SolveSmootherTimer.Stop();
 
     _SolveTotalTimer.Stop();
@@ -0,0 +1,109 @@
+    /*************************************************************************************
+
+    Grid physics library, www.github.com/paboyle/Grid 
+
+    Source file: ./tests/solver/Test_split_grid_solver.cc
+
+    Copyright (C) 2015
+
+Author: Peter Boyle <paboyle@ph.ed.ac.uk>
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License along
+    with this program; if not, write to the Free Software Foundation, Inc.,
+    51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+
+    See the full license in the file "LICENSE" in the top level distribution directory
+    *************************************************************************************/
+    /*  END LEGAL */
+#include <Grid/Grid.h>
+#include <Grid/algorithms/iterative/BlockConjugateGradient.h>
+
+using namespace std;
+using namespace Grid;
+
+int main (int argc, char ** argv)
+{
+  typedef typename DomainWallFermionR::FermionField FermionField;
+
+  const int Ls=4;
+
+  Grid_init(&argc,&argv);
+
+  GridCartesian         * UGrid   = SpaceTimeGrid::makeFourDimGrid(GridDefaultLatt(), GridDefaultSimd(Nd,vComplex::Nsimd()),GridDefaultMpi());
+  GridCartesian         * FGrid   = SpaceTimeGrid::makeFiveDimGrid(Ls,UGrid);
+  GridRedBlackCartesian * rbGrid  = SpaceTimeGrid::makeFourDimRedBlackGrid(UGrid);
+  GridRedBlackCartesian * FrbGrid = SpaceTimeGrid::makeFiveDimRedBlackGrid(Ls,UGrid);
+
+  int nrhs = 3;
+  for(int i=0;i<argc;i++){
+    if(std::string(argv[i]) == "--nrhs"){
+      std::stringstream ss(argv[i+1]); ss >> nrhs;
+    }
+  }
+
+  std::vector<int> seeds({1,2,3,4});
+  GridParallelRNG pRNG(UGrid );  pRNG.SeedFixedIntegers(seeds);
+  GridParallelRNG pRNG5(FGrid);  pRNG5.SeedFixedIntegers(seeds);
+
+  std::vector<FermionField> src(nrhs,FGrid);
+  std::vector<FermionField> result(nrhs,FGrid);
+  FermionField tmp(FGrid);
+  for(int s=0;s<nrhs;s++) random(pRNG5,src[s]);
+  for(int s=0;s<nrhs;s++) result[s]=Zero();
+
+  LatticeGaugeField Umu(UGrid); SU<Nc>::HotConfiguration(pRNG,Umu);
+
+  RealD mass=0.01;
+  RealD M5=1.8;
+  RealD tol=1.0e-8;
+
+  ///////////////////////////////////////////////////////////////
+  // The factory builds the operator and solver on each subgrid
+  ///////////////////////////////////////////////////////////////
+  typedef SplitGridSolver<LatticeGaugeField,FermionField> Splitter;
+  Splitter::SolverFactory factory = [&](LatticeGaugeField &s_Umu,const SplitGrids &g) -> Splitter::SolveFn {
+    auto Ddwf   = std::make_shared<DomainWallFermionR>(s_Umu,*g.FGrid,*g.FrbGrid,*g.UGrid,*g.UrbGrid,mass,M5);
+    auto HermOp = std::make_shared<MdagMLinearOperator<DomainWallFermionR,FermionField> >(*Ddwf);
+    auto CG     = std::make_shared<ConjugateGradient<FermionField> >(tol,10000);
+    return [Ddwf,HermOp,CG](const FermionField &in,FermionField &out) { (*CG)(*HermOp,in,out); };
+  };
+
+  SplitGridSolverParams params;
+  for(int i=0;i<argc;i++){
+    if(std::string(argv[i]) == "--split"){
+      params.split.resize(Nd);
+      for(int k=0;k<Nd;k++){
+	std::stringstream ss(argv[i+1+k]);
+	ss >> params.split[k];
+      }
+    }
+  }
+
+  Splitter Solver(Umu,factory,params);
+  std::cout << GridLogMessage << "Split chosen for "<<nrhs<<" sources "<<Solver.ChooseSplit(nrhs)<<std::endl;
+  Solver(src,result);
+
+  /////////////////////////////////////////////////////////////
+  // Residual check on the unsplit grid
+  /////////////////////////////////////////////////////////////
+  DomainWallFermionR Dchk(Umu,*FGrid,*FrbGrid,*UGrid,*rbGrid,mass,M5);
+  MdagMLinearOperator<DomainWallFermionR,FermionField> HermOpCk(Dchk);
+  for(int n=0;n<nrhs;n++){
+    HermOpCk.HermOp(result[n],tmp); tmp = tmp - src[n];
+    RealD resid = std::sqrt(norm2(tmp)/norm2(src[n]));
+    std::cout << GridLogMessage<<" resid["<<n<<"]  "<< resid<<std::endl;
+    assert(resid < 100*tol);
+  }
+
+  Grid_finalize();
+}
@@ -69,6 +69,11 @@ int main(int argc, char **argv) {
     std::cout << GridLogMessage << "Read in " << inputXml << std::endl;
   }
 
+  if(GridCmdOptionExists(argv, argv + argc, "--agglomerate")) {
+    std::string arg = GridCmdOptionPayload(argv, argv + argc, "--agglomerate");
+    GridCmdOptionInt(arg, mgParams.coarseAgglomerateSites);
+  }
+
   checkParameterValidity(mgParams);
   std::cout << mgParams << std::endl;
 